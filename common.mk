@@ -44,6 +44,8 @@ STATIC_OBJS_SMALL	= \
 		pthread_barrierattr_getpshared.$(OBJEXT) \
 		pthread_barrierattr_init.$(OBJEXT) \
 		pthread_barrierattr_setpshared.$(OBJEXT) \
+		pthread_barrierattr_setkind_np.$(OBJEXT) \
+		pthread_barrierattr_getkind_np.$(OBJEXT) \
 		pthread_cancel.$(OBJEXT) \
 		pthread_cond_destroy.$(OBJEXT) \
 		pthread_cond_init.$(OBJEXT) \
@@ -89,18 +91,27 @@ STATIC_OBJS_SMALL	= \
 		pthread_num_processors_np.$(OBJEXT) \
 		pthread_once.$(OBJEXT) \
 		pthread_rwlock_destroy.$(OBJEXT) \
+		pthread_rwlock_downgrade_np.$(OBJEXT) \
 		pthread_rwlock_init.$(OBJEXT) \
 		pthread_rwlock_rdlock.$(OBJEXT) \
 		pthread_rwlock_timedrdlock.$(OBJEXT) \
 		pthread_rwlock_timedwrlock.$(OBJEXT) \
 		pthread_rwlock_tryrdlock.$(OBJEXT) \
 		pthread_rwlock_trywrlock.$(OBJEXT) \
+		pthread_rwlock_tryupgrade_np.$(OBJEXT) \
 		pthread_rwlock_unlock.$(OBJEXT) \
+		pthread_rwlock_upgrade_np.$(OBJEXT) \
 		pthread_rwlock_wrlock.$(OBJEXT) \
 		pthread_rwlockattr_destroy.$(OBJEXT) \
+		pthread_rwlockattr_getkind_np.$(OBJEXT) \
 		pthread_rwlockattr_getpshared.$(OBJEXT) \
 		pthread_rwlockattr_init.$(OBJEXT) \
+		pthread_rwlockattr_setkind_np.$(OBJEXT) \
 		pthread_rwlockattr_setpshared.$(OBJEXT) \
+		pthread_seqlock_destroy_np.$(OBJEXT) \
+		pthread_seqlock_init_np.$(OBJEXT) \
+		pthread_seqlock_read_np.$(OBJEXT) \
+		pthread_seqlock_write_np.$(OBJEXT) \
 		pthread_self.$(OBJEXT) \
 		pthread_setaffinity.$(OBJEXT) \
 		pthread_setcancelstate.$(OBJEXT) \
@@ -111,6 +122,7 @@ STATIC_OBJS_SMALL	= \
 		pthread_setspecific.$(OBJEXT) \
 		pthread_spin_destroy.$(OBJEXT) \
 		pthread_spin_init.$(OBJEXT) \
+		pthread_spin_init_np.$(OBJEXT) \
 		pthread_spin_lock.$(OBJEXT) \
 		pthread_spin_trylock.$(OBJEXT) \
 		pthread_spin_unlock.$(OBJEXT) \
@@ -121,18 +133,39 @@ STATIC_OBJS_SMALL	= \
 		ptw32_callUserDestroyRoutines.$(OBJEXT) \
 		ptw32_calloc.$(OBJEXT) \
 		ptw32_cond_check_need_init.$(OBJEXT) \
+		ptw32_cond_queue.$(OBJEXT) \
 		ptw32_getprocessors.$(OBJEXT) \
+		ptw32_key_index.$(OBJEXT) \
 		ptw32_is_attr.$(OBJEXT) \
 		ptw32_mutex_check_need_init.$(OBJEXT) \
+		ptw32_mutex_adaptive_spin.$(OBJEXT) \
+		ptw32_mutex_wait.$(OBJEXT) \
 		ptw32_new.$(OBJEXT) \
+		ptw32_get_cancel_event.$(OBJEXT) \
 		ptw32_processInitialize.$(OBJEXT) \
 		ptw32_processTerminate.$(OBJEXT) \
+		ptw32_pshared.$(OBJEXT) \
+		ptw32_pshared_barrier.$(OBJEXT) \
+		ptw32_barrier_spin.$(OBJEXT) \
+		ptw32_barrier_tree.$(OBJEXT) \
+		ptw32_pshared_cond.$(OBJEXT) \
+		ptw32_pshared_mutex.$(OBJEXT) \
+		ptw32_pshared_rwlock.$(OBJEXT) \
 		ptw32_relmillisecs.$(OBJEXT) \
 		ptw32_reuse.$(OBJEXT) \
 		ptw32_rwlock_cancelwrwait.$(OBJEXT) \
 		ptw32_rwlock_check_need_init.$(OBJEXT) \
+		ptw32_rwlock_bias.$(OBJEXT) \
+		ptw32_rwlock_policy.$(OBJEXT) \
+		ptw32_rwlock_upgrade.$(OBJEXT) \
 		ptw32_semwait.$(OBJEXT) \
+		ptw32_slab.$(OBJEXT) \
+		ptw32_sem_get_handle.$(OBJEXT) \
+		ptw32_sem_named_path.$(OBJEXT) \
+		ptw32_sem_take.$(OBJEXT) \
+		ptw32_sem_cancel_wait.$(OBJEXT) \
 		ptw32_spinlock_check_need_init.$(OBJEXT) \
+		ptw32_srw.$(OBJEXT) \
 		ptw32_threadDestroy.$(OBJEXT) \
 		ptw32_threadStart.$(OBJEXT) \
 		ptw32_throw.$(OBJEXT) \
@@ -152,6 +185,8 @@ STATIC_OBJS_SMALL	= \
 		sem_open.$(OBJEXT) \
 		sem_post.$(OBJEXT) \
 		sem_post_multiple.$(OBJEXT) \
+		sem_trywait_multiple_np.$(OBJEXT) \
+		sem_timedwait_multiple_np.$(OBJEXT) \
 		sem_timedwait.$(OBJEXT) \
 		sem_trywait.$(OBJEXT) \
 		sem_unlink.$(OBJEXT) \
@@ -163,24 +198,45 @@ PTHREAD_SRCS	= \
 		ptw32_is_attr.c \
 		ptw32_processInitialize.c \
 		ptw32_processTerminate.c \
+		ptw32_pshared.c \
+		ptw32_pshared_barrier.c \
+		ptw32_barrier_spin.c \
+		ptw32_barrier_tree.c \
+		ptw32_pshared_cond.c \
+		ptw32_pshared_mutex.c \
+		ptw32_pshared_rwlock.c \
 		ptw32_threadStart.c \
 		ptw32_threadDestroy.c \
 		ptw32_tkAssocCreate.c \
 		ptw32_tkAssocDestroy.c \
 		ptw32_callUserDestroyRoutines.c \
 		ptw32_semwait.c \
+		ptw32_slab.c \
+		ptw32_sem_get_handle.c \
+		ptw32_sem_named_path.c \
+		ptw32_sem_take.c \
+		ptw32_sem_cancel_wait.c \
 		ptw32_timespec.c \
 		ptw32_throw.c \
 		ptw32_getprocessors.c \
+		ptw32_key_index.c \
 		ptw32_calloc.c \
 		ptw32_new.c \
+		ptw32_get_cancel_event.c \
 		ptw32_reuse.c \
 		ptw32_relmillisecs.c \
 		ptw32_cond_check_need_init.c \
+		ptw32_cond_queue.c \
 		ptw32_mutex_check_need_init.c \
+		ptw32_mutex_adaptive_spin.c \
+		ptw32_mutex_wait.c \
 		ptw32_rwlock_check_need_init.c \
+		ptw32_rwlock_bias.c \
+		ptw32_rwlock_policy.c \
+		ptw32_rwlock_upgrade.c \
 		ptw32_rwlock_cancelwrwait.c \
 		ptw32_spinlock_check_need_init.c \
+		ptw32_srw.c \
 		pthread_attr_init.c \
 		pthread_attr_destroy.c \
 		pthread_attr_getaffinity_np.c \
@@ -201,6 +257,8 @@ PTHREAD_SRCS	= \
 		pthread_barrierattr_init.c \
 		pthread_barrierattr_destroy.c \
 		pthread_barrierattr_setpshared.c \
+		pthread_barrierattr_setkind_np.c \
+		pthread_barrierattr_getkind_np.c \
 		pthread_barrierattr_getpshared.c \
 		pthread_setcancelstate.c \
 		pthread_setcanceltype.c \
@@ -253,17 +311,26 @@ PTHREAD_SRCS	= \
 		pthread_timechange_handler_np.c \
 		pthread_rwlock_init.c \
 		pthread_rwlock_destroy.c \
+		pthread_rwlock_downgrade_np.c \
 		pthread_rwlockattr_init.c \
+		pthread_rwlockattr_setkind_np.c \
 		pthread_rwlockattr_destroy.c \
+		pthread_rwlockattr_getkind_np.c \
 		pthread_rwlockattr_getpshared.c \
 		pthread_rwlockattr_setpshared.c \
+		pthread_seqlock_destroy_np.c \
+		pthread_seqlock_init_np.c \
+		pthread_seqlock_read_np.c \
+		pthread_seqlock_write_np.c \
 		pthread_rwlock_rdlock.c \
 		pthread_rwlock_timedrdlock.c \
 		pthread_rwlock_wrlock.c \
 		pthread_rwlock_timedwrlock.c \
 		pthread_rwlock_unlock.c \
+		pthread_rwlock_upgrade_np.c \
 		pthread_rwlock_tryrdlock.c \
 		pthread_rwlock_trywrlock.c \
+		pthread_rwlock_tryupgrade_np.c \
 		pthread_attr_setschedpolicy.c \
 		pthread_attr_getschedpolicy.c \
 		pthread_attr_setschedparam.c \
@@ -287,11 +354,14 @@ PTHREAD_SRCS	= \
 		sem_wait.c \
 		sem_post.c \
 		sem_post_multiple.c \
+		sem_trywait_multiple_np.c \
+		sem_timedwait_multiple_np.c \
 		sem_getvalue.c \
 		sem_open.c \
 		sem_close.c \
 		sem_unlink.c \
 		pthread_spin_init.c \
+		pthread_spin_init_np.c \
 		pthread_spin_destroy.c \
 		pthread_spin_lock.c \
 		pthread_spin_unlock.c \
@@ -101,6 +101,90 @@
  */
 #undef PTW32_THREAD_ID_REUSE_INCREMENT
 
+/*
+# ----------------------------------------------------------------------
+# PTW32_MUTEX_NO_WAIT_ON_ADDRESS
+# Purpose:
+# On Windows 8 and later the library detects WaitOnAddress() at load time
+# and non-robust mutexes then block on their lock word, so a mutex never
+# needs a kernel object. Define this to make every contended mutex block
+# on its own auto-reset event instead (created on first contention), e.g.
+# to compare the two or to keep handle-based tools working.
+#
+# Usage:
+# define PTW32_MUTEX_NO_WAIT_ON_ADDRESS
+#
+# ----------------------------------------------------------------------
+ */
+#undef PTW32_MUTEX_NO_WAIT_ON_ADDRESS
+
+/*
+# ----------------------------------------------------------------------
+# PTW32_NO_SELF_TLS_CACHE
+# Purpose:
+# By default each thread caches a pointer to its own thread struct in a
+# compiler thread-local variable (__declspec(thread) or __thread), which
+# makes pthread_self() and everything built on it a single TLS load.
+# The TlsAlloc() slot is still maintained and used as the fallback.
+# Define this to use only the TlsAlloc() slot, e.g. for a DLL that must
+# be loaded with LoadLibrary() on Windows XP or earlier, where implicit
+# TLS in dynamically loaded DLLs does not work.
+#
+# Usage:
+# define PTW32_NO_SELF_TLS_CACHE
+#
+# ----------------------------------------------------------------------
+ */
+#undef PTW32_NO_SELF_TLS_CACHE
+
+
+/*
+# ----------------------------------------------------------------------
+# PTW32_SRW
+# Purpose:
+# Back process-private, non-robust mutexes with SRWLOCK, condition
+# variables waited on with such a mutex with CONDITION_VARIABLE, and
+# read-write locks with SRWLOCK. Requires Windows Vista or later.
+# Robust mutexes keep the generic implementation. In this mode:
+# - timed mutex and rwlock waits sleep on a CONDITION_VARIABLE of
+#   their own that unlocks signal;
+# - rwlock locking is not a cancellation point;
+# - pthread_cond_[timed]wait remains a cancellation point;
+#   pthread_cancel wakes the native wait.
+# See ptw32_srw.c.
+#
+# Experimental: off by default until benchtest figures for both
+# flavours are in tests/README.BENCHTESTS.
+#
+# Usage:
+# define PTW32_SRW, or configure with cmake -DPTW32_SRW=ON.
+# (Not #undef'd here so that the CMake option is honoured.)
+#
+# ----------------------------------------------------------------------
+ */
+
+
+/*
+# ----------------------------------------------------------------------
+# PTW32_CACHE_LINE_SIZE
+# Purpose:
+# The cache line size, in bytes, that the library aligns and pads its
+# objects to so that unrelated locks never share a line. Mutexes,
+# semaphores, condition variables, spin locks and the other small
+# objects start on a line of their own (see ptw32_slab.c), and the
+# per-CPU parts of rwlocks and barriers are padded to whole lines.
+# Must be a power of 2 and at least 32. Defaults to 64, which suits
+# current x86, x64 and ARM64 processors; use 128 where adjacent lines
+# are prefetched in pairs.
+#
+# Usage:
+# define PTW32_CACHE_LINE_SIZE 128, or configure with
+# cmake -DPTW32_CACHE_LINE_SIZE=128.
+# (Not #undef'd here so that the CMake setting is honoured.)
+#
+# ----------------------------------------------------------------------
+ */
+
 
 /*********************************************************************
  * Target specific groups
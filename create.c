@@ -215,8 +215,6 @@ pthread_create (pthread_t * tid,
    */
   tp->state = run ? PThreadStateInitial : PThreadStateSuspended;
 
-  tp->keys = NULL;
-
   /*
    * Threads must be started in suspended mode and resumed if necessary
    * after _beginthreadex returns us the handle. Otherwise we set up a
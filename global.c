@@ -47,9 +47,40 @@
 
 
 int ptw32_processInitialized = PTW32_FALSE;
-ptw32_thread_t * ptw32_threadReuseTop = PTW32_THREAD_REUSE_EMPTY;
-ptw32_thread_t * ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
+SLIST_HEADER ptw32_threadReuseStack;	/* All zero is an empty list */
 pthread_key_t ptw32_selfThreadKey = NULL;
+#if defined(PTW32_SELF_TLS)
+PTW32_SELF_TLS ptw32_thread_t * ptw32_selfThread = NULL;
+/*
+ * Auto-reset event the calling thread parks on while waiting in an
+ * MCS lock queue. Created on first use and closed at thread detach.
+ */
+PTW32_SELF_TLS HANDLE ptw32_mcsParkEvent = NULL;
+/*
+ * The calling thread's free slab objects, by size class. Returned
+ * to ptw32_slabDepot at thread detach.
+ */
+PTW32_SELF_TLS ptw32_slab_magazine_t ptw32_slabMagazine[PTW32_SLAB_CLASSES];
+#endif
+/*
+ * Free slab objects shared by all threads, by size class. All zero
+ * is an empty list.
+ */
+SLIST_HEADER ptw32_slabDepot[PTW32_SLAB_CLASSES];
+/*
+ * Every slab chunk, freed by ptw32_processTerminate.
+ */
+ptw32_slab_chunk_t * ptw32_slabChunks = NULL;
+/*
+ * Slab objects allocated and not yet freed, by size class. A class's
+ * chunks are only freed while its count is zero.
+ */
+LONG ptw32_slabOutstanding[PTW32_SLAB_CLASSES];
+/*
+ * Bumped when a class's chunks are freed. Magazines filled under an
+ * older generation are discarded.
+ */
+LONG ptw32_slabGeneration[PTW32_SLAB_CLASSES];
 pthread_key_t ptw32_cleanupKey = NULL;
 pthread_cond_t ptw32_cond_list_head = NULL;
 pthread_cond_t ptw32_cond_list_tail = NULL;
@@ -72,7 +103,25 @@ unsigned __int64 ptw32_threadSeqNumber = 0;
 DWORD (*ptw32_register_cancellation) (PAPCFUNC, HANDLE, DWORD) = NULL;
 
 /*
- * Global lock for managing pthread_t struct reuse.
+ * Function pointers to WaitOnAddress and WakeByAddressSingle if the
+ * system provides them (Windows 8 or later). When set, non-robust
+ * mutexes park waiters on their lock word instead of allocating a
+ * per-mutex event. See ptw32_mutex_wait.c.
+ */
+BOOL (WINAPI *ptw32_wait_on_address) (volatile VOID *, PVOID, SIZE_T, DWORD) = NULL;
+VOID (WINAPI *ptw32_wake_by_address_single) (PVOID) = NULL;
+
+/*
+ * GetCurrentProcessorNumber and GetLogicalProcessorInformation if
+ * kernel32 exports them. See ptw32_barrier_tree.c.
+ */
+DWORD (WINAPI *ptw32_get_current_processor_number) (void) = NULL;
+BOOL (WINAPI *ptw32_get_logical_processor_information) (PVOID, PDWORD) = NULL;
+
+/*
+ * Global lock for retiring pthread_t handles: held while a
+ * handle's reuse counter is bumped, and while a handle is
+ * validated against it.
  */
 ptw32_mcs_lock_t ptw32_thread_reuse_lock = 0;
 
@@ -99,6 +148,27 @@ ptw32_mcs_lock_t ptw32_rwlock_test_init_lock = 0;
  */
 ptw32_mcs_lock_t ptw32_spinlock_test_init_lock = 0;
 
+/*
+ * This process's views of process-shared objects, hashed by id. Readers
+ * walk the chains without the lock; see ptw32_pshared.c.
+ */
+ptw32_mcs_lock_t ptw32_pshared_lock = 0;
+ptw32_pshared_local_t * ptw32_pshared_cache[PTW32_PSHARED_CACHE_SIZE];
+ptw32_pshared_local_t * ptw32_pshared_retired = NULL;
+
+/*
+ * The machine-wide id counter for process-shared objects, mapped on
+ * first use and kept until the process detaches.
+ */
+HANDLE ptw32_pshared_idSection = NULL;
+LONG * ptw32_pshared_nextId = NULL;
+
+/*
+ * The named semaphores this process has open; see sem_open.c.
+ */
+ptw32_mcs_lock_t ptw32_sem_named_lock = 0;
+ptw32_sem_named_t * ptw32_sem_named_list = NULL;
+
 /*
  * Global lock for condition variable linked list. The list exists
  * to wake up CVs when a WM_TIMECHANGE message arrives. See
@@ -106,6 +176,18 @@ ptw32_mcs_lock_t ptw32_spinlock_test_init_lock = 0;
  */
 ptw32_mcs_lock_t ptw32_cond_list_lock = 0;
 
+/*
+ * Thread-specific data key indices, guarded by ptw32_key_lock.
+ * ptw32_keyIndexUsed entries of ptw32_keyIndex have been handed out
+ * at some time; ptw32_keyIndexFree heads the chain of those now free
+ * (-1 if none).
+ */
+ptw32_mcs_lock_t ptw32_key_lock = 0;
+ptw32_key_index_t * ptw32_keyIndex = NULL;
+LONG ptw32_keyIndexSize = 0;
+LONG ptw32_keyIndexUsed = 0;
+LONG ptw32_keyIndexFree = -1;
+
 #if defined(_UWIN)
 /*
  * Keep a count of the number of threads.
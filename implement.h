@@ -215,6 +215,8 @@ typedef struct ptw32_mcs_node_t_     ptw32_mcs_local_node_t;
 typedef struct ptw32_mcs_node_t_*    ptw32_mcs_lock_t;
 typedef struct ptw32_robust_node_t_  ptw32_robust_node_t;
 typedef struct ptw32_thread_t_       ptw32_thread_t;
+typedef struct ptw32_cond_waiter_t_  ptw32_cond_waiter_t;
+typedef struct ptw32_tsd_t_          ptw32_tsd_t;
 
 #ifdef _MSC_VER
   // Suppress warnings about padding changes due to alignment.
@@ -224,18 +226,27 @@ typedef struct ptw32_thread_t_       ptw32_thread_t;
 
 struct ptw32_thread_t_
 {
+  /*
+   * 'tsd' and 'tsdSize' must come first: pthread_getspecific_fast_np
+   * reads them through struct ptw32_thread_inline_np_t_ in pthread.h.
+   */
+  ptw32_tsd_t * tsd;		/* Thread-specific values, by key index */
+  LONG tsdSize;			/* Entries in 'tsd' */
   unsigned __int64 seqNumber;	/* Process-unique thread sequence number */
   HANDLE threadH;		/* Win32 thread handle - POSIX thread is invalid if threadH == 0 */
   pthread_t ptHandle;		/* This thread's permanent pthread_t handle */
-  ptw32_thread_t * prevReuse;	/* Links threads on reuse stack; sentinel is PTW32_THREAD_REUSE_EMPTY */
+  SLIST_ENTRY reuseEntry;	/* Links threads on reuse stack. Aligned by MEMORY_ALLOCATION_ALIGNMENT as malloc is */
   volatile PThreadState state;
   ptw32_mcs_lock_t threadLock;	/* Used for serialised access to public thread state */
   ptw32_mcs_lock_t stateLock;	/* Used for async-cancel safety */
   HANDLE cancelEvent;
+  HANDLE condEvent;		/* Auto-reset; blocks this thread in pthread_cond_[timed]wait */
+#if defined(PTW32_SRW)
+  pthread_cond_t srwCond;	/* Native condition variable this thread is blocked on */
+  volatile LONG srwWaking;	/* pthread_cancel is waking srwCond */
+#endif
   void *exitStatus;
   void *parms;
-  void *keys;
-  void *nextAssoc;
 #if defined(PTW32_CLEANUP_C)
   jmp_buf start_mark;		/* Jump buffer follows void* so should be aligned */
 #endif				/* PTW32_CLEANUP_C */
@@ -298,9 +309,19 @@ struct pthread_attr_t_
  * ====================
  */
 
+/*
+ * '*count' is only ever changed with interlocked operations: it is the
+ * semaphore count when >= 0 and minus the number of waiters not yet
+ * released when < 0, so posts and waits only need the Win32 object when
+ * it crosses zero. 'count' points to 'value' except for named semaphores,
+ * whose count lives in a section shared by every process that opened
+ * the name. 'lock' only protects 'leftToUnblock' (NEED_SEM) and
+ * serialises sem_destroy.
+ */
 struct sem_t_
 {
-  int value;
+  LONG * count;
+  LONG value;
   ptw32_mcs_lock_t lock;
   HANDLE sem;
 #if defined(NEED_SEM)
@@ -308,9 +329,68 @@ struct sem_t_
 #endif
 };
 
+/*
+ * Named semaphores. The section "pthreads4w-sem-<name>" holds the count
+ * and the Win32 semaphore "pthreads4w-sem-<name>-wait" is released once
+ * for each waiter that a post finds. 'state' goes from 0 to
+ * PTW32_SEM_NAMED_READY once the creator has set the initial count, and
+ * to PTW32_SEM_NAMED_UNLINKED on sem_unlink.
+ */
+#define PTW32_SEM_NAME_MAX       200
+#define PTW32_SEM_NAMED_READY    1
+#define PTW32_SEM_NAMED_UNLINKED 2
+
+typedef struct ptw32_sem_named_shared_t_ ptw32_sem_named_shared_t;
+
+struct ptw32_sem_named_shared_t_
+{
+  LONG value;
+  LONG state;
+};
+
+/*
+ * One per name and process: every sem_open of the name returns &sem.
+ */
+typedef struct ptw32_sem_named_t_ ptw32_sem_named_t;
+
+struct ptw32_sem_named_t_
+{
+  sem_t sem;
+  struct sem_t_ s;
+  ptw32_sem_named_t * next;
+  int refs;
+  HANDLE section;
+  ptw32_sem_named_shared_t * shared;
+  char name[PTW32_SEM_NAME_MAX + 32];
+};
+
 #define PTW32_OBJECT_AUTO_INIT ((void *)(size_t) -1)
 #define PTW32_OBJECT_INVALID   NULL
 
+#if defined(PTW32_SRW)
+/*
+ * Timed acquirers of an SRW-backed mutex or rwlock sleep on 'cv' and
+ * are woken by unlocks while 'waiters' is non-zero.
+ */
+typedef struct ptw32_srw_timed_t_ ptw32_srw_timed_t;
+
+struct ptw32_srw_timed_t_
+{
+  SRWLOCK guard;		/* Held by a timed acquirer until it sleeps */
+  CONDITION_VARIABLE cv;
+  LONG waiters;			/* Threads in a timed acquire */
+};
+#endif
+
+/*
+ * The first four members are also read and written by the inline
+ * mutex fast paths in pthread.h (see PTW32_MUTEX_INLINE_NP). Keep
+ * them in step with struct ptw32_mutex_inline_np_t_.
+ *
+ * Members written while the mutex is contended come first, so that
+ * they share the object's first cache line. Those only read after
+ * initialisation ('event', 'robustNode') follow.
+ */
 struct pthread_mutex_t_
 {
   LONG lock_idx;		/* Provides exclusive access to mutex state
@@ -324,12 +404,83 @@ struct pthread_mutex_t_
 				   mutexes only). */
   int kind;			/* Mutex type. */
   pthread_t ownerThread;
+  int spinCount;		/* Running estimate of the number of spins
+				   needed to acquire a contended lock
+				   (adaptive mutexes only). */
+  ptw32_mcs_lock_t morphLock;	/* Guards morphHead/morphTail */
+  ptw32_cond_waiter_t *
+                    morphHead;	/* Condition variable waiters moved here by */
+  ptw32_cond_waiter_t *		/* pthread_cond_broadcast, each waiting to */
+                    morphTail;	/* be handed the mutex by an unlock. */
   HANDLE event;			/* Mutex release notification to waiting
 				   threads. */
   ptw32_robust_node_t*
                     robustNode; /* Extra state for robust mutexes  */
+#if defined(PTW32_SRW)
+  SRWLOCK srw;			/* Non-robust kinds. See ptw32_srw.c */
+  ptw32_srw_timed_t srwTimed;
+#endif
 };
 
+/*
+ * True if pthread_cond_broadcast has queued waiters on the mutex.
+ */
+#define PTW32_MUTEX_MORPH_PENDING(mx) \
+  (*(ptw32_cond_waiter_t * PTW32_INTERLOCKED_VOLATILE *) &(mx)->morphHead != NULL)
+
+/*
+ * Upper bound on the number of iterations an adaptive mutex will
+ * busy-wait on a contended lock before blocking on its event.
+ * The actual budget is learned per mutex from recent acquisitions
+ * and never exceeds this value. See ptw32_mutex_adaptive_spin.c.
+ */
+#if !defined(PTW32_MUTEX_ADAPTIVE_SPIN_MAX)
+# define PTW32_MUTEX_ADAPTIVE_SPIN_MAX 100
+#endif
+
+/*
+ * Number of times a thread waiting for an MCS lock queue flag polls it
+ * before parking on an event. Queue hand-offs normally complete within
+ * a few hundred cycles, so a short spin avoids most kernel waits.
+ */
+#if !defined(PTW32_MCS_SPIN_COUNT)
+# define PTW32_MCS_SPIN_COUNT 64
+#endif
+
+/*
+ * See config.h. Objects and the parts of them that different CPUs
+ * write are aligned and padded to this many bytes.
+ */
+#if !defined(PTW32_CACHE_LINE_SIZE)
+# define PTW32_CACHE_LINE_SIZE 64
+#endif
+
+/*
+ * Processor hint for use inside busy-wait loops. Reduces power and
+ * the memory-order mis-speculation penalty when the loop exits.
+ */
+#if defined(YieldProcessor) || defined(_MSC_VER) || defined(__MINGW32__)
+# define PTW32_SPIN_PAUSE() YieldProcessor()
+#else
+# define PTW32_SPIN_PAUSE()
+#endif
+
+/*
+ * Keeps loads after the barrier from being performed before loads
+ * preceding it. x86 and x64 never reorder loads with other loads, so
+ * there only the compiler has to be restrained.
+ */
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+# if defined(_MSC_VER)
+#  include <intrin.h>
+#  define PTW32_READ_BARRIER() _ReadWriteBarrier()
+# else
+#  define PTW32_READ_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+# endif
+#else
+# define PTW32_READ_BARRIER() MemoryBarrier()
+#endif
+
 enum ptw32_robust_state_t_
 {
   PTW32_ROBUST_CONSISTENT,
@@ -371,13 +522,35 @@ struct pthread_mutexattr_t_
  * routines to attempt an InterlockedCompareExchange on "interlock"
  * immediately and, if that fails, to try the inferior mutex.
  *
- * "u.cpus" isn't used for anything yet, but could be used at
- * some point to optimise spinlock behaviour.
+ * PTHREAD_SPINLOCK_FAIR_NP spinlocks on more than one cpu are ticket
+ * locks instead: "interlock" stays PTW32_SPIN_TICKET and the lock is
+ * held while "owner" differs from "next".
+ *
+ * "u.cpus" scales the backoff of contending threads. See
+ * pthread_spin_lock.c.
  */
 #define PTW32_SPIN_INVALID     (0)
 #define PTW32_SPIN_UNLOCKED    (1)
 #define PTW32_SPIN_LOCKED      (2)
 #define PTW32_SPIN_USE_MUTEX   (3)
+#define PTW32_SPIN_TICKET      (4)
+
+/*
+ * A thread that loses the race for a spinlock backs off for up to
+ * PTW32_SPIN_BACKOFF_PER_CPU * cpus pause iterations, at most
+ * PTW32_SPIN_BACKOFF_MAX. After PTW32_SPIN_YIELD_LIMIT iterations
+ * without the lock it yields its time slice, in case the holder
+ * is waiting for a cpu.
+ */
+#if !defined(PTW32_SPIN_BACKOFF_PER_CPU)
+# define PTW32_SPIN_BACKOFF_PER_CPU 16
+#endif
+#if !defined(PTW32_SPIN_BACKOFF_MAX)
+# define PTW32_SPIN_BACKOFF_MAX 1024
+#endif
+#if !defined(PTW32_SPIN_YIELD_LIMIT)
+# define PTW32_SPIN_YIELD_LIMIT 16384
+#endif
 
 struct pthread_spinlock_t_
 {
@@ -387,6 +560,8 @@ struct pthread_spinlock_t_
     int cpus;			/* No. of cpus if multi cpus, or   */
     pthread_mutex_t mutex;	/* mutex if single cpu.            */
   } u;
+  LONG next;			/* PTW32_SPIN_TICKET: next ticket  */
+  LONG owner;			/* PTW32_SPIN_TICKET: ticket served */
 };
 
 /*
@@ -403,29 +578,238 @@ struct ptw32_mcs_node_t_
 };
 
 
+/*
+ * Sequence lock - see pthread_seqlock_read_np.c
+ */
+struct pthread_seqlock_t_
+{
+  LONG seq;			/* Odd while a writer is updating */
+  ptw32_mcs_lock_t lock;	/* Serialises writers */
+  ptw32_mcs_local_node_t writerNode;	/* The holding writer's queue node */
+};
+
+
+/*
+ * Process-shared objects - see ptw32_pshared.c
+ *
+ * A mutex, condition variable, rwlock or barrier initialised with
+ * PTHREAD_PROCESS_SHARED holds an encoded object id instead of a
+ * pointer. The object's state lives in a named section that each
+ * process maps on first use, so nothing in it may point into any
+ * one process. Heap pointers are at least 4-byte aligned, so bit 1
+ * tells an id from a pointer; the static initializers, which have
+ * low bits set too, are above the id range.
+ */
+#define PTW32_PSHARED_IS_HANDLE(obj) \
+  ((((size_t) (obj)) & 3) == 2 \
+   && (size_t) (obj) < (size_t) PTHREAD_ERRORCHECK_MUTEX_INITIALIZER)
+#define PTW32_PSHARED_HANDLE(id)	((void *) (((size_t) (id) << 2) | 2))
+#define PTW32_PSHARED_ID(obj)		((LONG) ((size_t) (obj) >> 2))
+#define PTW32_PSHARED_MAX_ID		0x1FFFFFFF
+#define PTW32_PSHARED_MAGIC		((LONG) 0x50534844)
+#define PTW32_PSHARED_EVENTS		2	/* Named events per object */
+#define PTW32_PSHARED_CACHE_SIZE	64	/* Power of 2 */
+
+enum {
+  PTW32_PSHARED_MUTEX = 1,
+  PTW32_PSHARED_COND,
+  PTW32_PSHARED_RWLOCK,
+  PTW32_PSHARED_BARRIER
+};
+
+typedef struct ptw32_pshared_mutex_t_   ptw32_pshared_mutex_t;
+typedef struct ptw32_pshared_cond_t_    ptw32_pshared_cond_t;
+typedef struct ptw32_pshared_rwlock_t_  ptw32_pshared_rwlock_t;
+typedef struct ptw32_pshared_barrier_t_ ptw32_pshared_barrier_t;
+typedef struct ptw32_pshared_t_         ptw32_pshared_t;
+typedef struct ptw32_pshared_local_t_   ptw32_pshared_local_t;
+
+struct ptw32_pshared_mutex_t_
+{
+  LONG lock_idx;		/* As pthread_mutex_t_; waiters block on event 0 */
+  LONG kind;			/* As pthread_mutex_t_: robust kinds are negative */
+  LONG recursive_count;
+  LONG robustState;		/* ptw32_robust_state_t */
+  DWORD ownerTid;		/* Windows thread id of the owner, or 0 */
+};
+
+/*
+ * Generation counting condition: a signal or broadcast releases that
+ * many of the threads waiting at the time and sets a manual-reset
+ * event; a woken thread that entered after the release leaves the
+ * token for those it was meant for.
+ */
+struct ptw32_pshared_cond_t_
+{
+  LONG guard;			/* Short spin lock for the counters: holder's thread id */
+  LONG nWaiters;
+  LONG nRelease;		/* Waiters released but not yet gone */
+  LONG generation;		/* Incremented by each release */
+};
+
+struct ptw32_pshared_rwlock_t_
+{
+  LONG guard;
+  LONG nReaders;
+  LONG nWaitingWriters;
+  DWORD writerTid;		/* Windows thread id of the writer, or 0 */
+  ptw32_pshared_cond_t readers;	/* Event 0 */
+  ptw32_pshared_cond_t writers;	/* Event 1 */
+};
+
+struct ptw32_pshared_barrier_t_
+{
+  LONG guard;
+  LONG count;
+  LONG remaining;
+  LONG generation;
+  ptw32_pshared_cond_t cv;	/* Event 0 */
+};
+
+struct ptw32_pshared_t_
+{
+  LONG magic;			/* PTW32_PSHARED_MAGIC until destroyed */
+  LONG type;			/* PTW32_PSHARED_MUTEX etc. */
+  union
+  {
+    ptw32_pshared_mutex_t mutex;
+    ptw32_pshared_cond_t cond;
+    ptw32_pshared_rwlock_t rwlock;
+    ptw32_pshared_barrier_t barrier;
+  } u;
+};
+
+/*
+ * This process's view of a shared object, found by id in
+ * ptw32_pshared_cache. Never freed while the process runs.
+ */
+struct ptw32_pshared_local_t_
+{
+  ptw32_pshared_local_t * next;
+  LONG id;
+  HANDLE section;
+  ptw32_pshared_t * shared;	/* Mapped view */
+  HANDLE event[PTW32_PSHARED_EVENTS];
+};
+
+
+/*
+ * Upper bound on the number of iterations a PTHREAD_BARRIER_SPIN_NP
+ * waiter spins before it sleeps. See ptw32_barrier_spin.c.
+ */
+#if !defined(PTW32_BARRIER_SPIN_MAX)
+# define PTW32_BARRIER_SPIN_MAX 4000
+#endif
+
+/*
+ * PTHREAD_BARRIER_TREE_NP: each node of the combining tree takes this
+ * many arrivals, and occupies a cache line of its own. cpuLeaf maps the
+ * processor numbers within a group to the leaf of their topology domain.
+ * See ptw32_barrier_tree.c.
+ */
+#if !defined(PTW32_BARRIER_TREE_FANIN)
+# define PTW32_BARRIER_TREE_FANIN 4
+#endif
+#define PTW32_BARRIER_MAX_CPUS 64
+
+typedef struct ptw32_barrier_node_t_ ptw32_barrier_node_t;
+
+struct ptw32_barrier_node_t_
+{
+  LONG count;			/* Arrivals in this phase */
+  LONG size;			/* Arrivals that complete the node */
+  ptw32_barrier_node_t * parent;	/* NULL at the root */
+  char pad[PTW32_CACHE_LINE_SIZE - 2 * sizeof (LONG) - sizeof (ptw32_barrier_node_t *)];
+};
+
 struct pthread_barrier_t_
 {
   unsigned int nCurrentBarrierHeight;
   unsigned int nInitialBarrierHeight;
   int pshared;
-  sem_t semBarrierBreeched;
-  ptw32_mcs_lock_t lock;
-  ptw32_mcs_local_node_t proxynode;
+  int kind;			/* PTHREAD_BARRIER_*_NP */
+  sem_t semBarrierBreeched;	/* DEFAULT only */
+  ptw32_mcs_lock_t lock;	/* DEFAULT only */
+  ptw32_mcs_local_node_t proxynode;	/* DEFAULT only */
+  /*
+   * PTHREAD_BARRIER_SPIN_NP only. 'remaining' is written by every
+   * arrival, so keep it off the line the waiters spin on.
+   */
+  LONG remaining;		/* Arrivals still expected */
+  char pad[PTW32_CACHE_LINE_SIZE];
+  LONG sense;			/* Flips each time the barrier opens */
+  LONG nLeaving;		/* Released threads not yet returned */
+  LONG spinCount;		/* Running estimate of spins needed */
+  LONG spinMax;			/* 0 if there are more threads than CPUs */
+  LONG nSleepers[2];		/* Indexed by sense: may be asleep */
+  HANDLE event[2];		/* Indexed by sense: manual-reset */
+  /*
+   * PTHREAD_BARRIER_TREE_NP only. Arrival climbs the tree instead of
+   * decrementing 'remaining'; the rest is as for SPIN.
+   */
+  ptw32_barrier_node_t * nodes;	/* Leaves first, root last */
+  void * nodeBlock;		/* Allocation holding 'nodes' */
+  int nLeaves;
+  int cpuLeaf[PTW32_BARRIER_MAX_CPUS];
 };
 
 struct pthread_barrierattr_t_
 {
   int pshared;
+  int kind;
 };
 
+/*
+ * Thread-specific data. A key is an index into an array of values that
+ * each thread grows as it sets values (ptw32_thread_t.tsd), so the
+ * number of keys is limited only by memory and uses no TlsAlloc slots.
+ * Each use of an index has a new generation, and a value only belongs
+ * to the key if it was set for the same generation: a key created in
+ * a deleted key's place reads NULL in every thread until set.
+ *
+ * ptw32_selfThreadKey is the exception, since it is how a thread finds
+ * its ptw32_thread_t: it has index -1 and its value is in TLS slot 'key'.
+ *
+ * The first three members of pthread_key_t_ and all of ptw32_tsd_t are
+ * read by pthread_getspecific_fast_np in pthread.h (see
+ * PTW32_TSD_INLINE_NP). Keep them in step with its view structs.
+ */
 struct pthread_key_t_
 {
-  DWORD key;
+  DWORD key;			/* TLS slot (ptw32_selfThreadKey only) */
+  LONG index;			/* Index into each thread's 'tsd' */
+  LONG gen;			/* Generation of 'index' for this key */
   void (PTW32_CDECL *destructor) (void *);
   ptw32_mcs_lock_t keyLock;
   void *threads;
 };
 
+struct ptw32_tsd_t_
+{
+  void * value;
+  LONG gen;			/* Key generation 'value' was set for */
+  void * assoc;			/* This thread's ThreadKeyAssoc for the key, or NULL */
+};
+
+/*
+ * Key index allocation: 'gen' is the generation of the index's current
+ * or last key; free indices are chained through 'nextFree'.
+ */
+typedef struct ptw32_key_index_t_ ptw32_key_index_t;
+
+struct ptw32_key_index_t_
+{
+  LONG gen;
+  LONG nextFree;
+};
+
+/*
+ * The value of index key 'k' in thread 'sp', or NULL.
+ */
+#define PTW32_TSD_GET(sp, k) \
+  ((k)->index < (sp)->tsdSize && (sp)->tsd[(k)->index].gen == (k)->gen \
+   ? (sp)->tsd[(k)->index].value : NULL)
+
 
 typedef struct ThreadParms ThreadParms;
 
@@ -437,19 +821,43 @@ struct ThreadParms
 };
 
 
+/*
+ * A thread blocked in pthread_cond_[timed]wait. The node lives on the
+ * waiter's stack and is linked into its condition variable's FIFO or,
+ * after a broadcast, into the FIFO of the mutex it must re-acquire.
+ *
+ * 'state' leaves PTW32_COND_WAITING exactly once, by compare-exchange,
+ * either by the waiter withdrawing itself (timeout, cancellation) or by
+ * a signal or broadcast under the condition variable's lock. Whoever
+ * then moves the node to SIGNALLED or OWNER sets 'event' exactly once.
+ */
+enum {
+  PTW32_COND_WAITING = 0,	/* Queued on the condition variable     */
+  PTW32_COND_WITHDRAWN,		/* Dequeued by the waiter itself         */
+  PTW32_COND_SIGNALLED,		/* Woken; must re-acquire the mutex      */
+  PTW32_COND_MORPHED,		/* Queued on the mutex by a broadcast    */
+  PTW32_COND_OWNER		/* Woken holding the mutex               */
+};
+
+struct ptw32_cond_waiter_t_
+{
+  ptw32_cond_waiter_t * next;
+  ptw32_cond_waiter_t * prev;
+  HANDLE event;			/* The waiting thread's condEvent        */
+  pthread_t self;		/* The waiting thread                    */
+  pthread_mutex_t mx;		/* Mutex released by the wait            */
+  LONG state;
+};
+
 struct pthread_cond_t_
 {
-  long nWaitersBlocked;		/* Number of threads blocked            */
-  long nWaitersGone;		/* Number of threads timed out          */
-  long nWaitersToUnblock;	/* Number of threads to unblock         */
-  sem_t semBlockQueue;		/* Queue up threads waiting for the     */
-  /*   condition to become signalled      */
-  sem_t semBlockLock;		/* Semaphore that guards access to      */
-  /* | waiters blocked count/block queue  */
-  /* +-> Mandatory Sync.LEVEL-1           */
-  pthread_mutex_t mtxUnblockLock;	/* Mutex that guards access to          */
-  /* | waiters (to)unblock(ed) counts     */
-  /* +-> Optional* Sync.LEVEL-2           */
+  ptw32_mcs_lock_t lock;	/* Guards the waiter queue              */
+  ptw32_cond_waiter_t * head;	/* FIFO of blocked waiters              */
+  ptw32_cond_waiter_t * tail;
+#if defined(PTW32_SRW)
+  CONDITION_VARIABLE native;	/* Waiters holding a non-robust mutex   */
+  SRWLOCK srwGuard;		/* Held shared by those until asleep    */
+#endif
   pthread_cond_t next;		/* Doubly linked list                   */
   pthread_cond_t prev;
 };
@@ -462,6 +870,31 @@ struct pthread_condattr_t_
 
 #define PTW32_RWLOCK_MAGIC 0xfacade2
 
+/*
+ * PTHREAD_RWLOCK_READ_MOSTLY_NP reader slots. A thread takes the slot
+ * its sequence number hashes to; each slot is a cache line of its own.
+ * See ptw32_rwlock_bias.c.
+ */
+#if !defined(PTW32_RWLOCK_READER_SLOTS)
+# define PTW32_RWLOCK_READER_SLOTS 64	/* Power of 2 */
+#endif
+
+/*
+ * After a writer revokes reader bias, readers stay on the slow path for
+ * this many times as long as the revocation took.
+ */
+#if !defined(PTW32_RWLOCK_BIAS_INHIBIT)
+# define PTW32_RWLOCK_BIAS_INHIBIT 9
+#endif
+
+typedef struct ptw32_rwlock_slot_t_ ptw32_rwlock_slot_t;
+
+struct ptw32_rwlock_slot_t_
+{
+  PVOID volatile owner;		/* ptw32_thread_t * of the fast reader */
+  char pad[PTW32_CACHE_LINE_SIZE - sizeof (PVOID)];
+};
+
 struct pthread_rwlock_t_
 {
   pthread_mutex_t mtxExclusiveAccess;
@@ -471,11 +904,38 @@ struct pthread_rwlock_t_
   int nExclusiveAccessCount;
   int nCompletedSharedAccessCount;
   int nMagic;
+  int kind;			/* PTHREAD_RWLOCK_*_NP */
+  LONG bias;			/* READ_MOSTLY: readers may use the slots */
+  LONGLONG inhibitUntil;	/* READ_MOSTLY: no re-bias before this QPC time */
+  ptw32_rwlock_slot_t * readers;	/* READ_MOSTLY: reader slots */
+  void * readersMem;		/* Allocation that holds readers */
+  pthread_mutex_t mtxPolicy;	/* Policy kinds: guards the fields below */
+  pthread_cond_t cndReaders;	/* Policy kinds: broadcast to grant readers */
+  pthread_cond_t cndWriters;	/* Policy kinds: waiting writers */
+  int nReaders;			/* Policy kinds: readers holding the lock */
+  int nWaitingReaders;
+  int nWaitingWriters;
+  int writer;			/* Policy kinds: a writer holds the lock */
+  int upgrading;		/* Policy kinds: a reader is upgrading */
+  unsigned int readerPhase;	/* Policy kinds: bumped at each grant */
+#if defined(PTW32_SRW)
+  SRWLOCK srw;			/* See ptw32_srw.c */
+  int srwExclusive;		/* srw is held exclusively */
+  ptw32_srw_timed_t srwTimed;
+#endif
 };
 
+/*
+ * Kinds implemented by ptw32_rwlock_policy.c rather than by the
+ * pthread_rwlock_*.c routines themselves.
+ */
+#define PTW32_RWLOCK_IS_POLICY(rwl) \
+  ((rwl)->kind >= PTHREAD_RWLOCK_PREFER_READER_NP)
+
 struct pthread_rwlockattr_t_
 {
   int pshared;
+  int kind;
 };
 
 typedef union
@@ -500,9 +960,10 @@ struct ThreadKeyAssoc
    *         K - Key with destructor
    *            (head of chain is key->threads)
    *         T - Thread that has called pthread_setspecific(Kn)
-   *            (head of chain is thread->keys)
-   *         A - Association. Each association is a node at the
-   *             intersection of two doubly-linked lists.
+   *            (indexed by key in thread->tsd[Kn->index].assoc)
+   *         A - Association. Each association is a node in its
+   *             key's doubly-linked list and in its thread's
+   *             'tsd' array.
    *
    *                 T1    T2    T3
    *                 |     |     |
@@ -537,9 +998,11 @@ struct ThreadKeyAssoc
    *      pthread_setspecific() on a key that has a specified
    *      destructor.
    *
-   *      An association is destroyed either immediately after the
-   *      thread calls the key destructor function on thread exit, or
-   *      when the key is deleted.
+   *      An association is destroyed either after the thread has
+   *      called the key destructors on thread exit, or when the key
+   *      is deleted. Both clear its slot in the thread's 'tsd' array,
+   *      and the thread only grows that array while holding its
+   *      thread lock.
    *
    * Attributes:
    *      thread
@@ -553,16 +1016,6 @@ struct ThreadKeyAssoc
    *      key
    *              reference to the key that owns the association.
    *
-   *      nextKey
-   *              The pthread_t->keys attribute is the head of a
-   *              chain of associations that runs through the nextKey
-   *              link. This chain provides the 1 to many relationship
-   *              between a pthread_t and all pthread_key_t on which
-   *              it called pthread_setspecific.
-   *
-   *      prevKey
-   *              Similarly.
-   *
    *      nextThread
    *              The pthread_key_t->threads attribute is the head of
    *              a chain of associations that runs through the
@@ -574,10 +1027,15 @@ struct ThreadKeyAssoc
    *      prevThread
    *              Similarly.
    *
+   *      The 1 to many relationship between a thread and its keys
+   *      is the thread's 'tsd' array, indexed by key->index, so a
+   *      thread finds its association for a key in constant time.
+   *
    * Notes:
    *      1)      As soon as either the key or the thread is no longer
    *              referencing the association, it can be destroyed. The
-   *              association will be removed from both chains.
+   *              association will be removed from the key's chain
+   *              and the thread's 'tsd' array.
    *
    *      2)      Under WIN32, an association is only created by
    *              pthread_setspecific if the user provided a
@@ -587,9 +1045,7 @@ struct ThreadKeyAssoc
    */
   ptw32_thread_t * thread;
   pthread_key_t key;
-  ThreadKeyAssoc *nextKey;
   ThreadKeyAssoc *nextThread;
-  ThreadKeyAssoc *prevKey;
   ThreadKeyAssoc *prevThread;
 };
 
@@ -659,17 +1115,101 @@ PTW32_BEGIN_C_DECLS
 /* Declared in pthread_cancel.c */
 extern DWORD (*ptw32_register_cancellation) (PAPCFUNC, HANDLE, DWORD);
 
+/*
+ * Declared in global.c. Set by pthread_win32_process_attach_np() if the
+ * system provides WaitOnAddress() (Windows 8 or later), otherwise NULL.
+ */
+extern BOOL (WINAPI *ptw32_wait_on_address) (volatile VOID *, PVOID, SIZE_T, DWORD);
+extern VOID (WINAPI *ptw32_wake_by_address_single) (PVOID);
+
+/*
+ * Declared in global.c. Set by pthread_win32_process_attach_np() if
+ * kernel32 exports them (Windows Vista and XP SP3 or later), otherwise
+ * NULL. Used to lay out PTHREAD_BARRIER_TREE_NP barriers.
+ */
+extern DWORD (WINAPI *ptw32_get_current_processor_number) (void);
+extern BOOL (WINAPI *ptw32_get_logical_processor_information) (PVOID, PDWORD);
+
 PTW32_END_C_DECLS
 
-/* Thread Reuse stack bottom marker. Must not be NULL or any valid pointer to memory. */
-#define PTW32_THREAD_REUSE_EMPTY ((ptw32_thread_t *)(size_t) 1)
+/*
+ * Compiler-supported thread-local storage used to cache the calling
+ * thread's ptw32_thread_t, i.e. its ptw32_selfThreadKey value, so that
+ * pthread_self() is a single TLS load. The key remains the reference;
+ * every place that sets or clears the key for the calling thread must
+ * also use PTW32_SELF_CACHE_SET. See config.h PTW32_NO_SELF_TLS_CACHE.
+ *
+ * The same storage class holds each thread's MCS lock park event
+ * (see ptw32_MCS_lock.c).
+ */
+#if !defined(PTW32_NO_SELF_TLS_CACHE) && !defined(WINCE)
+# if defined(_MSC_VER)
+#   define PTW32_SELF_TLS __declspec(thread)
+# elif defined(__GNUC__)
+#   define PTW32_SELF_TLS __thread
+# endif
+#endif
+
+#if defined(PTW32_SELF_TLS)
+# define PTW32_SELF_CACHE_SET(sp) (ptw32_selfThread = (sp))
+#else
+# define PTW32_SELF_CACHE_SET(sp) ((void) 0)
+#endif
+
+/*
+ * Slab allocator for the library's small fixed-size objects: sync
+ * objects, their attributes and ThreadKeyAssocs (see ptw32_slab.c).
+ * Sizes are rounded up to one of PTW32_SLAB_CLASSES powers of two
+ * from PTW32_CACHE_LINE_SIZE bytes, so every object starts on its own
+ * cache line. Each thread keeps a magazine of up to
+ * PTW32_SLAB_MAGAZINE_ROUNDS free objects per class in front of the
+ * shared per-class depot, and the depot is refilled a
+ * PTW32_SLAB_CHUNK_SIZE chunk at a time.
+ */
+#define PTW32_SLAB_CLASSES          6	/* 1 to 32 cache lines */
+#if !defined(PTW32_SLAB_MAGAZINE_ROUNDS)
+# define PTW32_SLAB_MAGAZINE_ROUNDS 8
+#endif
+#if !defined(PTW32_SLAB_CHUNK_SIZE)
+# define PTW32_SLAB_CHUNK_SIZE      16384
+#endif
+
+typedef struct ptw32_slab_magazine_t_ ptw32_slab_magazine_t;
+
+struct ptw32_slab_magazine_t_
+{
+  LONG gen;			/* ptw32_slabGeneration the rounds are from */
+  int rounds;
+  void * round[PTW32_SLAB_MAGAZINE_ROUNDS];
+};
+
+/*
+ * Sits just before the first object of each chunk and links all
+ * chunks so that they can be freed at process detach.
+ */
+typedef struct ptw32_slab_chunk_t_ ptw32_slab_chunk_t;
+
+struct ptw32_slab_chunk_t_
+{
+  ptw32_slab_chunk_t * next;
+  void * mem;			/* As returned by malloc */
+  int c;			/* Size class */
+};
 
 PTW32_BEGIN_C_DECLS
 
 extern int ptw32_processInitialized;
-extern ptw32_thread_t * ptw32_threadReuseTop;
-extern ptw32_thread_t * ptw32_threadReuseBottom;
+extern SLIST_HEADER ptw32_threadReuseStack;
 extern pthread_key_t ptw32_selfThreadKey;
+#if defined(PTW32_SELF_TLS)
+extern PTW32_SELF_TLS ptw32_thread_t * ptw32_selfThread;
+extern PTW32_SELF_TLS HANDLE ptw32_mcsParkEvent;
+extern PTW32_SELF_TLS ptw32_slab_magazine_t ptw32_slabMagazine[PTW32_SLAB_CLASSES];
+#endif
+extern SLIST_HEADER ptw32_slabDepot[PTW32_SLAB_CLASSES];
+extern ptw32_slab_chunk_t * ptw32_slabChunks;
+extern LONG ptw32_slabOutstanding[PTW32_SLAB_CLASSES];
+extern LONG ptw32_slabGeneration[PTW32_SLAB_CLASSES];
 extern pthread_key_t ptw32_cleanupKey;
 extern pthread_cond_t ptw32_cond_list_head;
 extern pthread_cond_t ptw32_cond_list_tail;
@@ -685,9 +1225,21 @@ extern int ptw32_features;
 extern ptw32_mcs_lock_t ptw32_thread_reuse_lock;
 extern ptw32_mcs_lock_t ptw32_mutex_test_init_lock;
 extern ptw32_mcs_lock_t ptw32_cond_list_lock;
+extern ptw32_mcs_lock_t ptw32_key_lock;
+extern ptw32_key_index_t * ptw32_keyIndex;
+extern LONG ptw32_keyIndexSize;
+extern LONG ptw32_keyIndexUsed;
+extern LONG ptw32_keyIndexFree;
 extern ptw32_mcs_lock_t ptw32_cond_test_init_lock;
 extern ptw32_mcs_lock_t ptw32_rwlock_test_init_lock;
 extern ptw32_mcs_lock_t ptw32_spinlock_test_init_lock;
+extern ptw32_mcs_lock_t ptw32_pshared_lock;
+extern ptw32_pshared_local_t * ptw32_pshared_cache[PTW32_PSHARED_CACHE_SIZE];
+extern ptw32_pshared_local_t * ptw32_pshared_retired;
+extern HANDLE ptw32_pshared_idSection;
+extern LONG * ptw32_pshared_nextId;
+extern ptw32_mcs_lock_t ptw32_sem_named_lock;
+extern ptw32_sem_named_t * ptw32_sem_named_list;
 
 #if defined(_UWIN)
 extern int pthread_count;
@@ -708,10 +1260,111 @@ PTW32_BEGIN_C_DECLS
   int ptw32_is_attr (const pthread_attr_t * attr);
 
   int ptw32_cond_check_need_init (pthread_cond_t * cond);
+
+  void ptw32_cond_queue_add (ptw32_cond_waiter_t ** head,
+                             ptw32_cond_waiter_t ** tail,
+                             ptw32_cond_waiter_t * w);
+
+  void ptw32_cond_queue_remove (ptw32_cond_waiter_t ** head,
+                                ptw32_cond_waiter_t ** tail,
+                                ptw32_cond_waiter_t * w);
+
+  void ptw32_cond_morph_arm (pthread_mutex_t mx);
+
+  void ptw32_cond_morph_kick (pthread_mutex_t mx);
+
+  int ptw32_cond_morph_handoff (pthread_mutex_t mx);
+
+  LONG ptw32_cond_morph_withdraw (ptw32_cond_waiter_t * w);
+
+#if defined(PTW32_SRW)
+  void ptw32_srw_timed_init (ptw32_srw_timed_t * timed);
+  int ptw32_srw_mutex_lock (pthread_mutex_t mx, const struct timespec * abstime);
+  int ptw32_srw_mutex_trylock (pthread_mutex_t mx);
+  int ptw32_srw_mutex_unlock (pthread_mutex_t mx);
+  int ptw32_srw_cond_wait (pthread_cond_t cv, pthread_mutex_t mx,
+                           const struct timespec * abstime);
+  void ptw32_srw_cond_wake (pthread_cond_t cv, int all);
+  int ptw32_srw_rwlock_lock (pthread_rwlock_t rwl, int exclusive,
+                             const struct timespec * abstime);
+  int ptw32_srw_rwlock_trylock (pthread_rwlock_t rwl, int exclusive);
+  int ptw32_srw_rwlock_unlock (pthread_rwlock_t rwl);
+#endif
   int ptw32_mutex_check_need_init (pthread_mutex_t * mutex);
   int ptw32_rwlock_check_need_init (pthread_rwlock_t * rwlock);
+
+  int ptw32_rwlock_bias_init (pthread_rwlock_t rwl);
+  int ptw32_rwlock_bias_rdlock (pthread_rwlock_t rwl);
+  int ptw32_rwlock_bias_rdunlock (pthread_rwlock_t rwl);
+  int ptw32_rwlock_bias_held (pthread_rwlock_t rwl);
+  void ptw32_rwlock_bias_rearm (pthread_rwlock_t rwl);
+  int ptw32_rwlock_bias_revoke (pthread_rwlock_t rwl, int tryOnly,
+                                const struct timespec * abstime);
+  int ptw32_rwlock_bias_busy (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_policy_init (pthread_rwlock_t rwl);
+  int ptw32_rwlock_policy_destroy (pthread_rwlock_t rwl);
+  int ptw32_rwlock_policy_lock (pthread_rwlock_t rwl, int writer, int tryOnly,
+                                const struct timespec * abstime);
+  int ptw32_rwlock_policy_unlock (pthread_rwlock_t rwl);
+  int ptw32_rwlock_policy_upgrade (pthread_rwlock_t rwl, int tryOnly);
+  int ptw32_rwlock_policy_downgrade (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_upgrade (pthread_rwlock_t * rwlock, int tryOnly);
+
+  int ptw32_pshared_create (LONG type, ptw32_pshared_local_t ** local);
+  ptw32_pshared_local_t * ptw32_pshared_find (void * handle, LONG type);
+  void ptw32_pshared_destroy (ptw32_pshared_local_t * local);
+  void ptw32_pshared_terminate (void);
+  int ptw32_pshared_thread_dead (DWORD tid);
+  void ptw32_pshared_guard_acquire (LONG * guard);
+  void ptw32_pshared_guard_release (LONG * guard);
+
+  int ptw32_pshared_mutex_init (pthread_mutex_t * mutex,
+                                const pthread_mutexattr_t * attr);
+  int ptw32_pshared_mutex_destroy (pthread_mutex_t * mutex);
+  int ptw32_pshared_mutex_lock (pthread_mutex_t mx, int tryOnly,
+                                const struct timespec * abstime);
+  int ptw32_pshared_mutex_unlock (pthread_mutex_t mx);
+  int ptw32_pshared_mutex_consistent (pthread_mutex_t mx);
+
+  LONG ptw32_pshared_cond_enter (ptw32_pshared_cond_t * cv);
+  int ptw32_pshared_cond_block (ptw32_pshared_cond_t * cv, HANDLE event,
+                                LONG generation, const struct timespec * abstime,
+                                int cancelable);
+  int ptw32_pshared_cond_leave (ptw32_pshared_cond_t * cv, HANDLE event,
+                                LONG generation);
+  void ptw32_pshared_cond_release (ptw32_pshared_cond_t * cv, HANDLE event,
+                                   int all);
+  int ptw32_pshared_cond_init (pthread_cond_t * cond);
+  int ptw32_pshared_cond_destroy (pthread_cond_t * cond);
+  int ptw32_pshared_cond_wait (pthread_cond_t cv, pthread_mutex_t * mutex,
+                               const struct timespec * abstime);
+  int ptw32_pshared_cond_signal (pthread_cond_t cv, int all);
+
+  int ptw32_pshared_rwlock_init (pthread_rwlock_t * rwlock);
+  int ptw32_pshared_rwlock_destroy (pthread_rwlock_t * rwlock);
+  int ptw32_pshared_rwlock_lock (pthread_rwlock_t rwl, int writer, int tryOnly,
+                                 const struct timespec * abstime);
+  int ptw32_pshared_rwlock_unlock (pthread_rwlock_t rwl);
+
+  int ptw32_pshared_barrier_init (pthread_barrier_t * barrier, unsigned int count);
+  int ptw32_pshared_barrier_destroy (pthread_barrier_t * barrier);
+  int ptw32_pshared_barrier_wait (pthread_barrier_t b);
+
+  int ptw32_barrier_spin_init (pthread_barrier_t b);
+  int ptw32_barrier_spin_destroy (pthread_barrier_t b);
+  int ptw32_barrier_spin_wait (pthread_barrier_t b);
+  int ptw32_barrier_tree_init (pthread_barrier_t b);
+  void ptw32_barrier_tree_destroy (pthread_barrier_t b);
+  int ptw32_barrier_tree_arrive (pthread_barrier_t b, int * first);
+  void ptw32_barrier_tree_rearm (pthread_barrier_t b);
   int ptw32_spinlock_check_need_init (pthread_spinlock_t * lock);
 
+  int ptw32_mutex_adaptive_spin (pthread_mutex_t mx);
+  int ptw32_mutex_wait (pthread_mutex_t mx, const struct timespec * abstime);
+  int ptw32_mutex_wake (pthread_mutex_t mx);
+
   int ptw32_robust_mutex_inherit(pthread_mutex_t * mutex);
   void ptw32_robust_mutex_add(pthread_mutex_t* mutex, pthread_t self);
   void ptw32_robust_mutex_remove(pthread_mutex_t* mutex, ptw32_thread_t* otp);
@@ -730,6 +1383,8 @@ PTW32_BEGIN_C_DECLS
 
   pthread_t ptw32_new (void);
 
+  HANDLE ptw32_get_cancel_event (ptw32_thread_t * tp);
+
   pthread_t ptw32_threadReusePop (void);
 
   void ptw32_threadReusePush (pthread_t thread);
@@ -754,6 +1409,10 @@ PTW32_BEGIN_C_DECLS
   void ptw32_tkAssocDestroy (ThreadKeyAssoc * assoc);
 
   int ptw32_semwait (sem_t * sem);
+  HANDLE ptw32_sem_get_handle (sem_t s);
+  int ptw32_sem_cancel_wait (sem_t s);
+  int ptw32_sem_named_path (char * path, const char * name, const char * suffix);
+  int ptw32_sem_take (sem_t s, int max);
 
   DWORD ptw32_relmillisecs (const struct timespec * abstime);
 
@@ -769,6 +1428,18 @@ PTW32_BEGIN_C_DECLS
 
   void ptw32_filetime_to_timespec (const FILETIME * ft, struct timespec *ts);
 
+  void * ptw32_slab_calloc (size_t size);
+
+  void ptw32_slab_free (void * p, size_t size);
+
+  void ptw32_slab_flush (void);
+
+  void ptw32_slab_destroy (void);
+
+  int ptw32_key_index_alloc (pthread_key_t key);
+
+  void ptw32_key_index_free (pthread_key_t key);
+
 /* Declared in pthw32_calloc.c */
 #if defined(NEED_CALLOC)
 #define calloc(n, s) ptw32_calloc(n, s)
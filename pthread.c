@@ -62,24 +62,45 @@
 #include "ptw32_is_attr.c"
 #include "ptw32_processInitialize.c"
 #include "ptw32_processTerminate.c"
+#include "ptw32_pshared.c"
+#include "ptw32_pshared_barrier.c"
+#include "ptw32_barrier_spin.c"
+#include "ptw32_barrier_tree.c"
+#include "ptw32_pshared_cond.c"
+#include "ptw32_pshared_mutex.c"
+#include "ptw32_pshared_rwlock.c"
 #include "ptw32_threadStart.c"
 #include "ptw32_threadDestroy.c"
 #include "ptw32_tkAssocCreate.c"
 #include "ptw32_tkAssocDestroy.c"
 #include "ptw32_callUserDestroyRoutines.c"
 #include "ptw32_semwait.c"
+#include "ptw32_slab.c"
+#include "ptw32_sem_get_handle.c"
+#include "ptw32_sem_named_path.c"
+#include "ptw32_sem_take.c"
+#include "ptw32_sem_cancel_wait.c"
 #include "ptw32_timespec.c"
 #include "ptw32_throw.c"
 #include "ptw32_getprocessors.c"
+#include "ptw32_key_index.c"
 #include "ptw32_calloc.c"
 #include "ptw32_new.c"
+#include "ptw32_get_cancel_event.c"
 #include "ptw32_reuse.c"
 #include "ptw32_relmillisecs.c"
 #include "ptw32_cond_check_need_init.c"
+#include "ptw32_cond_queue.c"
 #include "ptw32_mutex_check_need_init.c"
+#include "ptw32_mutex_adaptive_spin.c"
+#include "ptw32_mutex_wait.c"
 #include "ptw32_rwlock_check_need_init.c"
+#include "ptw32_rwlock_bias.c"
+#include "ptw32_rwlock_policy.c"
+#include "ptw32_rwlock_upgrade.c"
 #include "ptw32_rwlock_cancelwrwait.c"
 #include "ptw32_spinlock_check_need_init.c"
+#include "ptw32_srw.c"
 #include "ptw32_strdup.c"
 #include "pthread_attr_init.c"
 #include "pthread_attr_destroy.c"
@@ -101,6 +122,8 @@
 #include "pthread_barrierattr_init.c"
 #include "pthread_barrierattr_destroy.c"
 #include "pthread_barrierattr_setpshared.c"
+#include "pthread_barrierattr_setkind_np.c"
+#include "pthread_barrierattr_getkind_np.c"
 #include "pthread_barrierattr_getpshared.c"
 #include "pthread_setcancelstate.c"
 #include "pthread_setcanceltype.c"
@@ -155,17 +178,26 @@
 #include "pthread_timechange_handler_np.c"
 #include "pthread_rwlock_init.c"
 #include "pthread_rwlock_destroy.c"
+#include "pthread_rwlock_downgrade_np.c"
 #include "pthread_rwlockattr_init.c"
+#include "pthread_rwlockattr_setkind_np.c"
 #include "pthread_rwlockattr_destroy.c"
+#include "pthread_rwlockattr_getkind_np.c"
 #include "pthread_rwlockattr_getpshared.c"
 #include "pthread_rwlockattr_setpshared.c"
+#include "pthread_seqlock_destroy_np.c"
+#include "pthread_seqlock_init_np.c"
+#include "pthread_seqlock_read_np.c"
+#include "pthread_seqlock_write_np.c"
 #include "pthread_rwlock_rdlock.c"
 #include "pthread_rwlock_timedrdlock.c"
 #include "pthread_rwlock_wrlock.c"
 #include "pthread_rwlock_timedwrlock.c"
 #include "pthread_rwlock_unlock.c"
+#include "pthread_rwlock_upgrade_np.c"
 #include "pthread_rwlock_tryrdlock.c"
 #include "pthread_rwlock_trywrlock.c"
+#include "pthread_rwlock_tryupgrade_np.c"
 #include "pthread_attr_setschedpolicy.c"
 #include "pthread_attr_getschedpolicy.c"
 #include "pthread_attr_setschedparam.c"
@@ -187,11 +219,14 @@
 #include "sem_wait.c"
 #include "sem_post.c"
 #include "sem_post_multiple.c"
+#include "sem_trywait_multiple_np.c"
+#include "sem_timedwait_multiple_np.c"
 #include "sem_getvalue.c"
 #include "sem_open.c"
 #include "sem_close.c"
 #include "sem_unlink.c"
 #include "pthread_spin_init.c"
+#include "pthread_spin_init_np.c"
 #include "pthread_spin_destroy.c"
 #include "pthread_spin_lock.c"
 #include "pthread_spin_unlock.c"
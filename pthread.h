@@ -268,15 +268,21 @@ enum
  *                              pthread_mutexattr_setprioceiling
  *                              pthread_mutexattr_setprotocol     +
  *
- * _POSIX_THREAD_PROCESS_SHARED (== -1)
- *                      If set, you can create mutexes and condition
- *                      variables that can be shared with another
- *                      process.If set, indicates the availability
- *                      of:
+ * _POSIX_THREAD_PROCESS_SHARED (== 200809L)
+ *                      If set, you can create mutexes, condition
+ *                      variables, read/write locks and barriers that
+ *                      can be shared with another process, and spin
+ *                      locks that work between processes (as a
+ *                      mutex). If set, indicates the
+ *                      availability of:
  *                              pthread_mutexattr_getpshared
  *                              pthread_mutexattr_setpshared
  *                              pthread_condattr_getpshared
  *                              pthread_condattr_setpshared
+ *                              pthread_rwlockattr_getpshared
+ *                              pthread_rwlockattr_setpshared
+ *                              pthread_barrierattr_getpshared
+ *                              pthread_barrierattr_setpshared
  *
  * _POSIX_THREAD_SAFE_FUNCTIONS (== 200809L)
  *                      If == 200809L you can use the special *_r library
@@ -293,9 +299,8 @@ enum
  *
  * _POSIX_ROBUST_MUTEXES (== 200809L)
  *                      If == 200809L, you can use robust mutexes
- *                      Officially this should also imply
- *                      _POSIX_THREAD_PROCESS_SHARED != -1 however
- *                      not here yet.
+ *                      Robust process-shared mutexes recover
+ *                      from the death of the owning process.
  *
  * -------------------------------------------------------------
  */
@@ -341,7 +346,7 @@ enum
 #define _POSIX_THREAD_PRIORITY_SCHEDULING  -1
 
 #undef  _POSIX_THREAD_PROCESS_SHARED
-#define _POSIX_THREAD_PROCESS_SHARED  -1
+#define _POSIX_THREAD_PROCESS_SHARED  200809L
 
 
 /*
@@ -385,6 +390,10 @@ enum
 #undef  _POSIX_THREAD_KEYS_MAX
 #define _POSIX_THREAD_KEYS_MAX                  128
 
+/*
+ * Keys use no Win32 TLS slots: far more than PTHREAD_KEYS_MAX can be
+ * created, up to the limit of memory.
+ */
 #undef  PTHREAD_KEYS_MAX
 #define PTHREAD_KEYS_MAX                        _POSIX_THREAD_KEYS_MAX
 
@@ -448,6 +457,7 @@ typedef struct pthread_condattr_t_ * pthread_condattr_t;
 typedef struct pthread_rwlock_t_ * pthread_rwlock_t;
 typedef struct pthread_rwlockattr_t_ * pthread_rwlockattr_t;
 typedef struct pthread_spinlock_t_ * pthread_spinlock_t;
+typedef struct pthread_seqlock_t_ * pthread_seqlock_t;
 typedef struct pthread_barrier_t_ * pthread_barrier_t;
 typedef struct pthread_barrierattr_t_ * pthread_barrierattr_t;
 
@@ -576,8 +586,8 @@ enum
   PTHREAD_MUTEX_FAST_NP,
   PTHREAD_MUTEX_RECURSIVE_NP,
   PTHREAD_MUTEX_ERRORCHECK_NP,
+  PTHREAD_MUTEX_ADAPTIVE_NP,
   PTHREAD_MUTEX_TIMED_NP = PTHREAD_MUTEX_FAST_NP,
-  PTHREAD_MUTEX_ADAPTIVE_NP = PTHREAD_MUTEX_FAST_NP,
   /* For compatibility with POSIX */
   PTHREAD_MUTEX_NORMAL = PTHREAD_MUTEX_FAST_NP,
   PTHREAD_MUTEX_RECURSIVE = PTHREAD_MUTEX_RECURSIVE_NP,
@@ -585,6 +595,38 @@ enum
   PTHREAD_MUTEX_DEFAULT = PTHREAD_MUTEX_NORMAL
 };
 
+/*
+ * Read-write lock kinds (non-portable, see pthread_rwlockattr_setkind_np).
+ */
+enum
+{
+  PTHREAD_RWLOCK_DEFAULT_NP,
+  PTHREAD_RWLOCK_READ_MOSTLY_NP,
+  PTHREAD_RWLOCK_PREFER_READER_NP,
+  PTHREAD_RWLOCK_PREFER_WRITER_NP,
+  PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP,
+  PTHREAD_RWLOCK_PHASE_FAIR_NP
+};
+
+/*
+ * Barrier kinds (non-portable, see pthread_barrierattr_setkind_np).
+ */
+enum
+{
+  PTHREAD_BARRIER_DEFAULT_NP,
+  PTHREAD_BARRIER_SPIN_NP,
+  PTHREAD_BARRIER_TREE_NP
+};
+
+/*
+ * Spin lock kinds (non-portable, see pthread_spin_init_np).
+ */
+enum
+{
+  PTHREAD_SPINLOCK_DEFAULT_NP,
+  PTHREAD_SPINLOCK_FAIR_NP
+};
+
 
 typedef struct ptw32_cleanup_t ptw32_cleanup_t;
 
@@ -1046,6 +1088,275 @@ PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_setkind_np(pthread_mutexattr_t *
                                          int kind);
 PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_getkind_np(pthread_mutexattr_t * attr,
                                          int *kind);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_setkind_np(pthread_rwlockattr_t * attr,
+                                          int pref);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_getkind_np(const pthread_rwlockattr_t * attr,
+                                          int *pref);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_upgrade_np(pthread_rwlock_t * rwlock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_tryupgrade_np(pthread_rwlock_t * rwlock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_downgrade_np(pthread_rwlock_t * rwlock);
+PTW32_DLLPORT int PTW32_CDECL pthread_barrierattr_setkind_np(pthread_barrierattr_t * attr,
+                                           int kind);
+PTW32_DLLPORT int PTW32_CDECL pthread_barrierattr_getkind_np(const pthread_barrierattr_t * attr,
+                                           int *kind);
+PTW32_DLLPORT int PTW32_CDECL pthread_spin_init_np(pthread_spinlock_t * lock,
+                                           int pshared,
+                                           int kind);
+
+/*
+ * Sequence locks: readers retry instead of locking.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_init_np(pthread_seqlock_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_destroy_np(pthread_seqlock_t * lock);
+PTW32_DLLPORT unsigned int PTW32_CDECL pthread_seqlock_read_begin_np(pthread_seqlock_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_read_retry_np(pthread_seqlock_t * lock,
+                                          unsigned int seq);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_write_lock_np(pthread_seqlock_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_write_unlock_np(pthread_seqlock_t * lock);
+
+#if defined(PTW32_MUTEX_INLINE_NP) || defined(PTW32_TSD_INLINE_NP)
+/*
+ * Compiler support shared by the opt-in inline routines below.
+ */
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#  pragma intrinsic(_InterlockedCompareExchange)
+#  define PTW32_INLINE_NP static __inline
+#  define PTW32_INLINE_NP_TLS __declspec(thread)
+#  define PTW32_INLINE_NP_CAS(location, value, comparand) \
+     _InterlockedCompareExchange((long volatile *)(location), (value), (comparand))
+#elif defined(__GNUC__)
+#  define PTW32_INLINE_NP static __inline__
+#  define PTW32_INLINE_NP_TLS __thread
+#  define PTW32_INLINE_NP_CAS(location, value, comparand) \
+     __sync_val_compare_and_swap((location), (comparand), (value))
+#else
+#  error PTW32_MUTEX_INLINE_NP and PTW32_TSD_INLINE_NP are not supported by this compiler
+#endif
+#endif /* PTW32_MUTEX_INLINE_NP || PTW32_TSD_INLINE_NP */
+
+#if defined(PTW32_MUTEX_INLINE_NP)
+/*
+ * Kind-specialised mutex fast paths (opt-in).
+ *
+ * Define PTW32_MUTEX_INLINE_NP before including pthread.h to get
+ * inline versions of lock, trylock and unlock for mutexes that the
+ * application knows to be PTHREAD_MUTEX_NORMAL (or DEFAULT) or
+ * PTHREAD_MUTEX_RECURSIVE. The uncontended case is a single
+ * interlocked operation with no call into the library. Anything
+ * else - a static initializer, a mutex of another kind, a robust
+ * mutex, contention or an error - falls through to the regular
+ * pthread_mutex_* function, so the result is always the same as
+ * calling that function directly.
+ *
+ * The view below must match the start of struct pthread_mutex_t_
+ * in implement.h.
+ */
+struct ptw32_mutex_inline_np_t_
+{
+  long lock_idx;
+  int recursive_count;
+  int kind;
+  pthread_t ownerThread;
+};
+
+/*
+ * True for a pointer to an initialised process-private mutex. Maps
+ * NULL and the static initializers (the highest addresses) out of
+ * range with a single unsigned compare. Process-shared mutexes are
+ * not pointers and have bit 1 set.
+ */
+#define PTW32_INLINE_NP_IS_MUTEX(mx) \
+  ((size_t)(mx) - 1 < (size_t) PTHREAD_ERRORCHECK_MUTEX_INITIALIZER - 1 \
+   && ((size_t)(mx) & 2) == 0)
+
+PTW32_INLINE_NP int
+pthread_mutex_lock_normal_np (pthread_mutex_t * mutex)
+{
+  struct ptw32_mutex_inline_np_t_ * mx = (struct ptw32_mutex_inline_np_t_ *) *mutex;
+
+  if (PTW32_INLINE_NP_IS_MUTEX(mx)
+      && mx->kind == PTHREAD_MUTEX_NORMAL
+      && PTW32_INLINE_NP_CAS(&mx->lock_idx, 1, 0) == 0)
+    {
+      return 0;
+    }
+  return pthread_mutex_lock (mutex);
+}
+
+PTW32_INLINE_NP int
+pthread_mutex_trylock_normal_np (pthread_mutex_t * mutex)
+{
+  struct ptw32_mutex_inline_np_t_ * mx = (struct ptw32_mutex_inline_np_t_ *) *mutex;
+
+  /* A busy lock word is left to the library (see PTW32_SRW). */
+  if (PTW32_INLINE_NP_IS_MUTEX(mx)
+      && mx->kind == PTHREAD_MUTEX_NORMAL
+      && PTW32_INLINE_NP_CAS(&mx->lock_idx, 1, 0) == 0)
+    {
+      return 0;
+    }
+  return pthread_mutex_trylock (mutex);
+}
+
+PTW32_INLINE_NP int
+pthread_mutex_unlock_normal_np (pthread_mutex_t * mutex)
+{
+  struct ptw32_mutex_inline_np_t_ * mx = (struct ptw32_mutex_inline_np_t_ *) *mutex;
+
+  /* Waiters (-1) or not locked (0) are left to the library. */
+  if (PTW32_INLINE_NP_IS_MUTEX(mx)
+      && mx->kind == PTHREAD_MUTEX_NORMAL
+      && PTW32_INLINE_NP_CAS(&mx->lock_idx, 0, 1) == 1)
+    {
+      return 0;
+    }
+  return pthread_mutex_unlock (mutex);
+}
+
+PTW32_INLINE_NP int
+pthread_mutex_lock_recursive_np (pthread_mutex_t * mutex)
+{
+  struct ptw32_mutex_inline_np_t_ * mx = (struct ptw32_mutex_inline_np_t_ *) *mutex;
+
+  if (PTW32_INLINE_NP_IS_MUTEX(mx)
+      && mx->kind == PTHREAD_MUTEX_RECURSIVE)
+    {
+      pthread_t self = pthread_self ();
+
+      if (PTW32_INLINE_NP_CAS(&mx->lock_idx, 1, 0) == 0)
+        {
+          mx->recursive_count = 1;
+          mx->ownerThread = self;
+          return 0;
+        }
+      if (mx->ownerThread.p == self.p && mx->ownerThread.x == self.x)
+        {
+          mx->recursive_count++;
+          return 0;
+        }
+    }
+  return pthread_mutex_lock (mutex);
+}
+
+PTW32_INLINE_NP int
+pthread_mutex_trylock_recursive_np (pthread_mutex_t * mutex)
+{
+  struct ptw32_mutex_inline_np_t_ * mx = (struct ptw32_mutex_inline_np_t_ *) *mutex;
+
+  if (PTW32_INLINE_NP_IS_MUTEX(mx)
+      && mx->kind == PTHREAD_MUTEX_RECURSIVE)
+    {
+      pthread_t self = pthread_self ();
+
+      if (PTW32_INLINE_NP_CAS(&mx->lock_idx, 1, 0) == 0)
+        {
+          mx->recursive_count = 1;
+          mx->ownerThread = self;
+          return 0;
+        }
+      if (mx->ownerThread.p == self.p && mx->ownerThread.x == self.x)
+        {
+          mx->recursive_count++;
+          return 0;
+        }
+    }
+  return pthread_mutex_trylock (mutex);
+}
+
+PTW32_INLINE_NP int
+pthread_mutex_unlock_recursive_np (pthread_mutex_t * mutex)
+{
+  struct ptw32_mutex_inline_np_t_ * mx = (struct ptw32_mutex_inline_np_t_ *) *mutex;
+
+  if (PTW32_INLINE_NP_IS_MUTEX(mx)
+      && mx->kind == PTHREAD_MUTEX_RECURSIVE)
+    {
+      pthread_t self = pthread_self ();
+
+      if (mx->ownerThread.p == self.p && mx->ownerThread.x == self.x)
+        {
+          if (mx->recursive_count > 1)
+            {
+              mx->recursive_count--;
+              return 0;
+            }
+          mx->recursive_count = 0;
+          mx->ownerThread.p = NULL;
+          if (PTW32_INLINE_NP_CAS(&mx->lock_idx, 0, 1) == 1)
+            {
+              return 0;
+            }
+          /*
+           * There are waiters. We still hold the lock, so restore
+           * ownership and let the library release it and wake one.
+           */
+          mx->recursive_count = 1;
+          mx->ownerThread = self;
+        }
+    }
+  return pthread_mutex_unlock (mutex);
+}
+
+#endif /* PTW32_MUTEX_INLINE_NP */
+
+#if defined(PTW32_TSD_INLINE_NP)
+/*
+ * Inline thread-specific data read (opt-in).
+ *
+ * Define PTW32_TSD_INLINE_NP before including pthread.h to get
+ * pthread_getspecific_fast_np, which returns the same value as
+ * pthread_getspecific but reads it straight from the calling thread's
+ * value array: a few loads, no call into the library, and no TLS API
+ * call, so GetLastError and WSAGetLastError are never touched. The
+ * first call in each thread (per translation unit) calls pthread_self
+ * to find the thread's array and caches it in compiler TLS, so a
+ * thread must not use it after calling pthread_win32_thread_detach_np.
+ *
+ * The views below must match the start of struct pthread_key_t_,
+ * struct ptw32_tsd_t_ and struct ptw32_thread_t_ in implement.h.
+ */
+struct ptw32_key_inline_np_t_
+{
+  unsigned long key;
+  long index;
+  long gen;
+};
+
+struct ptw32_tsd_inline_np_t_
+{
+  void * value;
+  long gen;
+  void * assoc;
+};
+
+struct ptw32_thread_inline_np_t_
+{
+  struct ptw32_tsd_inline_np_t_ * tsd;
+  long tsdSize;
+};
+
+PTW32_INLINE_NP void *
+pthread_getspecific_fast_np (pthread_key_t key)
+{
+  static PTW32_INLINE_NP_TLS struct ptw32_thread_inline_np_t_ * self;
+  const struct ptw32_key_inline_np_t_ * k = (const struct ptw32_key_inline_np_t_ *) key;
+
+  if (self == NULL
+      && (self = (struct ptw32_thread_inline_np_t_ *) pthread_self ().p) == NULL)
+    {
+      /* No thread struct (out of memory): as pthread_getspecific does */
+      return pthread_getspecific (key);
+    }
+  if (k != NULL && k->index >= 0)
+    {
+      return k->index < self->tsdSize && self->tsd[k->index].gen == k->gen
+             ? self->tsd[k->index].value : NULL;
+    }
+  return pthread_getspecific (key);
+}
+
+#endif /* PTW32_TSD_INLINE_NP */
 PTW32_DLLPORT int PTW32_CDECL pthread_timedjoin_np(pthread_t thread,
                                          void **value_ptr,
                                          const struct timespec *abstime);
@@ -1090,7 +1401,8 @@ PTW32_DLLPORT int PTW32_CDECL pthread_win32_test_features_np(int);
 enum ptw32_features 
 {
   PTW32_SYSTEM_INTERLOCKED_COMPARE_EXCHANGE = 0x0001,	/* System provides it. */
-  PTW32_ALERTABLE_ASYNC_CANCEL              = 0x0002	/* Can cancel blocked threads. */
+  PTW32_ALERTABLE_ASYNC_CANCEL              = 0x0002,	/* Can cancel blocked threads. */
+  PTW32_WAIT_ON_ADDRESS                     = 0x0004	/* Mutexes wait on the lock word. */
 };
 
 /*
@@ -79,7 +79,7 @@ pthread_attr_destroy (pthread_attr_t * attr)
    * Set the attribute object to a specific invalid value.
    */
   (*attr)->valid = 0;
-  free (*attr);
+  ptw32_slab_free (*attr, sizeof (**attr));
   *attr = NULL;
 
   return 0;
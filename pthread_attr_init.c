@@ -81,7 +81,7 @@ pthread_attr_init (pthread_attr_t * attr)
       return EINVAL;
     }
 
-  attr_result = (pthread_attr_t) malloc (sizeof (*attr_result));
+  attr_result = (pthread_attr_t) ptw32_slab_calloc (sizeof (*attr_result));
 
   if (attr_result == NULL)
     {
@@ -56,6 +56,23 @@ pthread_barrier_destroy (pthread_barrier_t * barrier)
       return EINVAL;
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(*barrier))
+    {
+      return ptw32_pshared_barrier_destroy (barrier);
+    }
+
+  if ((*barrier)->kind != PTHREAD_BARRIER_DEFAULT_NP)
+    {
+      b = *barrier;
+
+      if (0 == (result = ptw32_barrier_spin_destroy (b)))
+        {
+          *barrier = (pthread_barrier_t) PTW32_OBJECT_INVALID;
+          ptw32_slab_free (b, sizeof (*b));
+        }
+      return result;
+    }
+
   if (0 != ptw32_mcs_lock_try_acquire(&(*barrier)->lock, &node))
     {
       return EBUSY;
@@ -83,7 +100,7 @@ pthread_barrier_destroy (pthread_barrier_t * barrier)
            * and will require a major version number increment.
            */
           ptw32_mcs_lock_release(&node);
-	  (void) free (b);
+	  ptw32_slab_free (b, sizeof (*b));
 	  return 0;
 	}
       else
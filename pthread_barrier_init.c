@@ -56,20 +56,47 @@ pthread_barrier_init (pthread_barrier_t * barrier,
       return EINVAL;
     }
 
-  if (NULL != (b = (pthread_barrier_t) calloc (1, sizeof (*b))))
+  if (attr != NULL && *attr != NULL
+      && (*attr)->pshared == PTHREAD_PROCESS_SHARED)
+    {
+      /*
+       * See ptw32_pshared.c.
+       */
+      return ptw32_pshared_barrier_init (barrier, count);
+    }
+
+  if (NULL != (b = (pthread_barrier_t) ptw32_slab_calloc (sizeof (*b))))
     {
       b->pshared = (attr != NULL && *attr != NULL
 		    ? (*attr)->pshared : PTHREAD_PROCESS_PRIVATE);
 
+      b->kind = (attr != NULL && *attr != NULL
+		 ? (*attr)->kind : PTHREAD_BARRIER_DEFAULT_NP);
+
       b->nCurrentBarrierHeight = b->nInitialBarrierHeight = count;
       b->lock = 0;
 
+      if (b->kind != PTHREAD_BARRIER_DEFAULT_NP)
+        {
+          int result = ptw32_barrier_spin_init (b);
+
+          if (result == 0)
+            {
+              *barrier = b;
+            }
+          else
+            {
+              ptw32_slab_free (b, sizeof (*b));
+            }
+          return result;
+        }
+
       if (0 == sem_init (&(b->semBarrierBreeched), b->pshared, 0))
 	    {
 	      *barrier = b;
 	      return 0;
 	    }
-      (void) free (b);
+      ptw32_slab_free (b, sizeof (*b));
     }
 
   return ENOMEM;
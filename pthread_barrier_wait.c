@@ -58,6 +58,16 @@ pthread_barrier_wait (pthread_barrier_t * barrier)
       return EINVAL;
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(*barrier))
+    {
+      return ptw32_pshared_barrier_wait (*barrier);
+    }
+
+  if ((*barrier)->kind != PTHREAD_BARRIER_DEFAULT_NP)
+    {
+      return ptw32_barrier_spin_wait (*barrier);
+    }
+
   ptw32_mcs_lock_acquire(&(*barrier)->lock, &node);
 
   b = *barrier;
@@ -83,7 +83,7 @@ pthread_barrierattr_destroy (pthread_barrierattr_t * attr)
       pthread_barrierattr_t ba = *attr;
 
       *attr = NULL;
-      free (ba);
+      ptw32_slab_free (ba, sizeof (*ba));
     }
 
   return (result);
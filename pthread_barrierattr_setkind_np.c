@@ -0,0 +1,108 @@
+/*
+ * pthread_barrierattr_setkind_np.c
+ *
+ * Description:
+ * This translation unit implements barrier primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_barrierattr_setkind_np (pthread_barrierattr_t * attr, int kind)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Selects the implementation used by barriers created
+      *      with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_barrierattr_t
+      *
+      *      kind
+      *              must be one of:
+      *
+      *                      PTHREAD_BARRIER_DEFAULT_NP
+      *                              The standard implementation. All
+      *                              but the last thread to arrive
+      *                              sleep until it arrives.
+      *
+      *                      PTHREAD_BARRIER_SPIN_NP
+      *                              Threads arrive with a single
+      *                              interlocked decrement and spin for
+      *                              a while before they sleep. Suits
+      *                              short phases with no more threads
+      *                              than CPUs.
+      *
+      *                      PTHREAD_BARRIER_TREE_NP
+      *                              As PTHREAD_BARRIER_SPIN_NP, but
+      *                              threads arrive through a tree of
+      *                              counters laid out by CPU topology.
+      *                              For many threads.
+      *
+      * DESCRIPTION
+      *      Selects the implementation used by barriers created
+      *      with 'attr'. The kinds differ only in performance.
+      *      Process-shared barriers ignore the kind.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'kind' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (attr == NULL || *attr == NULL)
+    {
+      return EINVAL;
+    }
+
+  switch (kind)
+    {
+    case PTHREAD_BARRIER_DEFAULT_NP:
+    case PTHREAD_BARRIER_SPIN_NP:
+    case PTHREAD_BARRIER_TREE_NP:
+      (*attr)->kind = kind;
+      return 0;
+    default:
+      return EINVAL;
+    }
+
+}				/* pthread_barrierattr_setkind_np */
@@ -111,6 +111,9 @@ pthread_cancel (pthread_t thread)
   pthread_t self;
   ptw32_thread_t * tp;
   ptw32_mcs_local_node_t stateLock;
+#if defined(PTW32_SRW)
+  pthread_cond_t srwCond = NULL;
+#endif
 
   /*
    * Validate the thread id. This method works for pthreads-win32 because
@@ -187,10 +190,23 @@ pthread_cancel (pthread_t thread)
       if (tp->state < PThreadStateCancelPending)
 	{
 	  tp->state = PThreadStateCancelPending;
-	  if (!SetEvent (tp->cancelEvent))
+	  if (!SetEvent (ptw32_get_cancel_event (tp)))
 	    {
 	      result = ESRCH;
 	    }
+#if defined(PTW32_SRW)
+	  /*
+	   * A native condition variable wait can't watch the cancel
+	   * event. Wake it once stateLock is released, since the waiter
+	   * holds the cv's guard while it takes stateLock; srwWaking
+	   * keeps it in ptw32_srw_cond_wait until we are done. The
+	   * extra wake-ups are spurious to other waiters.
+	   */
+	  if ((srwCond = tp->srwCond) != NULL)
+	    {
+	      tp->srwWaking = 1;
+	    }
+#endif
 	}
       else if (tp->state >= PThreadStateCanceling)
 	{
@@ -198,6 +214,14 @@ pthread_cancel (pthread_t thread)
 	}
 
       ptw32_mcs_lock_release (&stateLock);
+
+#if defined(PTW32_SRW)
+      if (srwCond != NULL)
+	{
+	  ptw32_srw_cond_wake (srwCond, PTW32_TRUE);
+	  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &tp->srwWaking, 0);
+	}
+#endif
     }
 
   return (result);
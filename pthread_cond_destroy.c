@@ -121,7 +121,7 @@ pthread_cond_destroy (pthread_cond_t * cond)
       */
 {
   pthread_cond_t cv;
-  int result = 0, result1 = 0, result2 = 0;
+  int result = 0;
 
   /*
    * Assuming any race condition here is harmless.
@@ -133,52 +133,36 @@ pthread_cond_destroy (pthread_cond_t * cond)
     
   ptw32_processInitialize ();
 
+  if (PTW32_PSHARED_IS_HANDLE(*cond))
+    {
+      return ptw32_pshared_cond_destroy (cond);
+    }
+
   if (*cond != PTHREAD_COND_INITIALIZER)
     {
       ptw32_mcs_local_node_t node;
+      ptw32_mcs_local_node_t cvNode;
+      int busy;
+
       ptw32_mcs_lock_acquire(&ptw32_cond_list_lock, &node);
 
       cv = *cond;
 
       /*
-       * Close the gate; this will synchronize this thread with
-       * all already signaled waiters to let them retract their
-       * waiter status - SEE NOTE 1 ABOVE!!!
+       * Synchronise with waiters withdrawing from the queue after a
+       * timeout or cancellation. Waiters already dequeued by a signal
+       * or broadcast never touch the cv again - SEE NOTE 1 ABOVE!!!
        */
-      if (ptw32_semwait (&(cv->semBlockLock)) != 0) /* Non-cancelable */
-	{
-	  result = PTW32_GET_ERRNO();
-	}
-      else
-        {
-          /*
-           * !TRY! lock mtxUnblockLock; try will detect busy condition
-           * and will not cause a deadlock with respect to concurrent
-           * signal/broadcast.
-           */
-          if ((result = pthread_mutex_trylock (&(cv->mtxUnblockLock))) != 0)
-	    {
-	      (void) sem_post (&(cv->semBlockLock));
-	    }
-	}
-	
-      if (result != 0)
-        {
-          ptw32_mcs_lock_release(&node);
-          return result;
-        }
+      ptw32_mcs_lock_acquire(&cv->lock, &cvNode);
+      busy = (cv->head != NULL);
+      ptw32_mcs_lock_release(&cvNode);
 
       /*
        * Check whether cv is still busy (still has waiters)
        */
-      if (cv->nWaitersBlocked > cv->nWaitersGone)
+      if (busy)
 	{
-	  if (sem_post (&(cv->semBlockLock)) != 0)
-	    {
-	      result = PTW32_GET_ERRNO();
-	    }
-	  result1 = pthread_mutex_unlock (&(cv->mtxUnblockLock));
-	  result2 = EBUSY;
+	  result = EBUSY;
 	}
       else
 	{
@@ -187,19 +171,6 @@ pthread_cond_destroy (pthread_cond_t * cond)
 	   */
 	  *cond = NULL;
 
-	  if (sem_destroy (&(cv->semBlockLock)) != 0)
-	    {
-	      result = PTW32_GET_ERRNO();
-	    }
-	  if (sem_destroy (&(cv->semBlockQueue)) != 0)
-	    {
-	      result1 = PTW32_GET_ERRNO();
-	    }
-	  if ((result2 = pthread_mutex_unlock (&(cv->mtxUnblockLock))) == 0)
-	    {
-	      result2 = pthread_mutex_destroy (&(cv->mtxUnblockLock));
-	    }
-
 	  /* Unlink the CV from the list */
 
 	  if (ptw32_cond_list_head == cv)
@@ -220,7 +191,7 @@ pthread_cond_destroy (pthread_cond_t * cond)
 	      cv->next->prev = cv->prev;
 	    }
 
-	  (void) free (cv);
+	  ptw32_slab_free (cv, sizeof (*cv));
 	}
 
       ptw32_mcs_lock_release(&node);
@@ -258,5 +229,5 @@ pthread_cond_destroy (pthread_cond_t * cond)
       ptw32_mcs_lock_release(&node);
     }
 
-  return ((result != 0) ? result : ((result1 != 0) ? result1 : result2));
+  return result;
 }
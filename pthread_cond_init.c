@@ -75,8 +75,8 @@ pthread_cond_init (pthread_cond_t * cond, const pthread_condattr_t * attr)
       * ------------------------------------------------------
       */
 {
-  int result;
   pthread_cond_t cv = NULL;
+  ptw32_mcs_local_node_t node;
 
   if (cond == NULL)
     {
@@ -90,85 +90,47 @@ pthread_cond_init (pthread_cond_t * cond, const pthread_condattr_t * attr)
     {
       /*
        * Creating condition variable that can be shared between
-       * processes.
+       * processes. See ptw32_pshared.c.
        */
-      return ENOSYS;
+      return ptw32_pshared_cond_init (cond);
     }
 
-  cv = (pthread_cond_t) calloc (1, sizeof (*cv));
+  cv = (pthread_cond_t) ptw32_slab_calloc (sizeof (*cv));
 
   if (cv == NULL)
     {
       return ENOMEM;
     }
 
-  cv->nWaitersBlocked = 0;
-  cv->nWaitersToUnblock = 0;
-  cv->nWaitersGone = 0;
+  cv->lock = NULL;
+  cv->head = NULL;
+  cv->tail = NULL;
+#if defined(PTW32_SRW)
+  InitializeConditionVariable (&cv->native);
+  InitializeSRWLock (&cv->srwGuard);
+#endif
 
-  if (sem_init (&(cv->semBlockLock), 0, 1) != 0)
-    {
-      result = PTW32_GET_ERRNO();
-      goto FAIL0;
-    }
+  ptw32_mcs_lock_acquire(&ptw32_cond_list_lock, &node);
 
-  if (sem_init (&(cv->semBlockQueue), 0, 0) != 0)
-    {
-      result = PTW32_GET_ERRNO();
-      goto FAIL1;
-    }
+  cv->next = NULL;
+  cv->prev = ptw32_cond_list_tail;
 
-  if ((result = pthread_mutex_init (&(cv->mtxUnblockLock), 0)) != 0)
+  if (ptw32_cond_list_tail != NULL)
     {
-      goto FAIL2;
+      ptw32_cond_list_tail->next = cv;
     }
 
-  result = 0;
-
-  goto DONE;
-
-  /*
-   * -------------
-   * Failed...
-   * -------------
-   */
-FAIL2:
-  (void) sem_destroy (&(cv->semBlockQueue));
-
-FAIL1:
-  (void) sem_destroy (&(cv->semBlockLock));
+  ptw32_cond_list_tail = cv;
 
-FAIL0:
-  (void) free (cv);
-  cv = NULL;
-
-DONE:
-  if (NULL != cv && 0 == result)
+  if (ptw32_cond_list_head == NULL)
     {
-      ptw32_mcs_local_node_t node;
-
-      ptw32_mcs_lock_acquire(&ptw32_cond_list_lock, &node);
-
-      cv->next = NULL;
-      cv->prev = ptw32_cond_list_tail;
-
-      if (ptw32_cond_list_tail != NULL)
-	{
-	  ptw32_cond_list_tail->next = cv;
-	}
-
-      ptw32_cond_list_tail = cv;
-
-      if (ptw32_cond_list_head == NULL)
-	{
-	  ptw32_cond_list_head = cv;
-	}
-
-      ptw32_mcs_lock_release(&node);
+      ptw32_cond_list_head = cv;
     }
 
+  ptw32_mcs_lock_release(&node);
+
   *cond = cv;
 
-  return result;
+  return 0;
 
 }				/* pthread_cond_init */
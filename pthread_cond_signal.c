@@ -47,31 +47,66 @@
 #include "pthread.h"
 #include "implement.h"
 
+static INLINE pthread_mutex_t
+ptw32_cond_morph_target (pthread_cond_t cv)
+     /*
+      * Returns the mutex that a broadcast can requeue all of cv's
+      * waiters onto, or NULL if they must all be woken instead.
+      * POSIX requires concurrent waiters to use the same mutex
+      * but we don't rely on it. Robust mutexes track ownership
+      * per thread and can't be handed over by an unlock.
+      */
+{
+  ptw32_cond_waiter_t * w = cv->head;
+  pthread_mutex_t mx;
+
+  if (w == NULL || w->next == NULL)
+    {
+      /* Nothing to gain over a plain wake-up. */
+      return NULL;
+    }
+
+  mx = w->mx;
+
+  if (PTW32_PSHARED_IS_HANDLE(mx) || mx->kind < 0)
+    {
+      return NULL;
+    }
+
+  for (w = w->next; w != NULL; w = w->next)
+    {
+      if (w->mx != mx)
+	{
+	  return NULL;
+	}
+    }
+
+  return mx;
+}
+
 static INLINE int
 ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
      /*
       * Notes.
       *
       * Does not use the external mutex for synchronisation,
-      * therefore semBlockLock is needed.
-      * mtxUnblockLock is for LEVEL-2 synch. LEVEL-2 is the
-      * state where the external mutex is not necessarily locked by
-      * any thread, ie. between cond_wait unlocking and re-acquiring
-      * the lock after having been signaled or a timeout or
-      * cancellation.
-      *
-      * Uses the following CV elements:
-      *   nWaitersBlocked
-      *   nWaitersToUnblock
-      *   nWaitersGone
-      *   mtxUnblockLock
-      *   semBlockLock
-      *   semBlockQueue
+      * therefore cv->lock is needed. It guards only the FIFO of
+      * waiter nodes and is never held while anyone blocks.
+      *
+      * A waiter that is timing out or being cancelled at the same
+      * time moves its own node out of PTW32_COND_WAITING first and
+      * is skipped; it will dequeue itself. Every other waiter taken
+      * gets exactly one wake-up, issued after cv->lock is released.
       */
 {
-  int result;
+  int result = 0;
   pthread_cond_t cv;
-  int nSignalsToIssue;
+  pthread_mutex_t mx = NULL;
+  ptw32_cond_waiter_t * w;
+  ptw32_cond_waiter_t * next;
+  ptw32_cond_waiter_t * woken = NULL;
+  ptw32_cond_waiter_t ** wokenTail = &woken;
+  ptw32_mcs_local_node_t node;
 
   if (cond == NULL || *cond == NULL)
     {
@@ -89,64 +124,97 @@ ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
       return 0;
     }
 
-  if ((result = pthread_mutex_lock (&(cv->mtxUnblockLock))) != 0)
+  if (PTW32_PSHARED_IS_HANDLE(cv))
     {
-      return result;
+      return ptw32_pshared_cond_signal (cv, unblockAll);
     }
 
-  if (0 != cv->nWaitersToUnblock)
+#if defined(PTW32_SRW)
+  /*
+   * Waiters holding an SRW-backed mutex sleep on cv->native.
+   */
+  if (unblockAll)
     {
-      if (0 == cv->nWaitersBlocked)
-	{
-	  return pthread_mutex_unlock (&(cv->mtxUnblockLock));
-	}
-      if (unblockAll)
-	{
-	  cv->nWaitersToUnblock += (nSignalsToIssue = cv->nWaitersBlocked);
-	  cv->nWaitersBlocked = 0;
-	}
-      else
-	{
-	  nSignalsToIssue = 1;
-	  cv->nWaitersToUnblock++;
-	  cv->nWaitersBlocked--;
-	}
+      ptw32_srw_cond_wake (cv, PTW32_TRUE);
     }
-  else if (cv->nWaitersBlocked > cv->nWaitersGone)
+#endif
+
+  ptw32_mcs_lock_acquire (&cv->lock, &node);
+
+  if (unblockAll)
     {
-      /* Use the non-cancellable version of sem_wait() */
-      if (ptw32_semwait (&(cv->semBlockLock)) != 0)
-	{
-	  result = PTW32_GET_ERRNO();
-	  (void) pthread_mutex_unlock (&(cv->mtxUnblockLock));
-	  return result;
-	}
-      if (0 != cv->nWaitersGone)
-	{
-	  cv->nWaitersBlocked -= cv->nWaitersGone;
-	  cv->nWaitersGone = 0;
-	}
-      if (unblockAll)
+      mx = ptw32_cond_morph_target (cv);
+    }
+
+  if (mx != NULL)
+    {
+      /*
+       * Wait morphing: requeue the waiters onto the mutex they will
+       * re-acquire. Unlocking the mutex then hands it to them one at
+       * a time.
+       */
+      ptw32_mcs_local_node_t morphNode;
+
+      ptw32_mcs_lock_acquire (&mx->morphLock, &morphNode);
+      for (w = cv->head; w != NULL; w = next)
 	{
-	  nSignalsToIssue = cv->nWaitersToUnblock = cv->nWaitersBlocked;
-	  cv->nWaitersBlocked = 0;
+	  next = w->next;
+	  if ((PTW32_INTERLOCKED_LONG) PTW32_COND_WAITING == PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+						(PTW32_INTERLOCKED_LONGPTR) &w->state,
+						(PTW32_INTERLOCKED_LONG) PTW32_COND_MORPHED,
+						(PTW32_INTERLOCKED_LONG) PTW32_COND_WAITING))
+	    {
+	      ptw32_cond_queue_remove (&cv->head, &cv->tail, w);
+	      ptw32_cond_queue_add (&mx->morphHead, &mx->morphTail, w);
+	    }
 	}
-      else
+      ptw32_mcs_lock_release (&morphNode);
+      ptw32_mcs_lock_release (&node);
+
+      ptw32_cond_morph_arm (mx);
+
+      return 0;
+    }
+
+  for (w = cv->head; w != NULL; w = next)
+    {
+      next = w->next;
+      if ((PTW32_INTERLOCKED_LONG) PTW32_COND_WAITING == PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+					    (PTW32_INTERLOCKED_LONGPTR) &w->state,
+					    (PTW32_INTERLOCKED_LONG) PTW32_COND_SIGNALLED,
+					    (PTW32_INTERLOCKED_LONG) PTW32_COND_WAITING))
 	{
-	  nSignalsToIssue = cv->nWaitersToUnblock = 1;
-	  cv->nWaitersBlocked--;
+	  ptw32_cond_queue_remove (&cv->head, &cv->tail, w);
+	  w->next = NULL;
+	  *wokenTail = w;
+	  wokenTail = &w->next;
+
+	  if (!unblockAll)
+	    {
+	      break;
+	    }
 	}
     }
-  else
+
+  ptw32_mcs_lock_release (&node);
+
+#if defined(PTW32_SRW)
+  if (woken == NULL && !unblockAll)
     {
-      return pthread_mutex_unlock (&(cv->mtxUnblockLock));
+      ptw32_srw_cond_wake (cv, PTW32_FALSE);
     }
+#endif
 
-  if ((result = pthread_mutex_unlock (&(cv->mtxUnblockLock))) == 0)
+  /*
+   * A waiter may return as soon as its event is set, so
+   * don't touch its node after that.
+   */
+  for (w = woken; w != NULL; w = next)
     {
-      if (sem_post_multiple (&(cv->semBlockQueue), nSignalsToIssue) != 0)
+      next = w->next;
+      if (!SetEvent (w->event))
 	{
-	  result = PTW32_GET_ERRNO();
+	  result = EINVAL;
 	}
     }
 
@@ -37,224 +37,57 @@
  *
  * -------------------------------------------------------------
  * Algorithm:
- * The algorithm used in this implementation is that developed by
- * Alexander Terekhov in colaboration with Louis Thomas. The bulk
- * of the discussion is recorded in the file README.CV, which contains
- * several generations of both colaborators original algorithms. The final
- * algorithm used here is the one referred to as
+ * Each waiter queues a node on its own stack in a FIFO held by the
+ * condition variable and blocks on its thread's auto-reset condEvent.
+ * The FIFO is guarded by an MCS lock that is never held across a wait.
  *
- *     Algorithm 8a / IMPL_SEM,UNBLOCK_STRATEGY == UNBLOCK_ALL
- * 
- * presented below in pseudo-code as it appeared:
- *
- *
- * given:
- * semBlockLock - bin.semaphore
- * semBlockQueue - semaphore
- * mtxExternal - mutex or CS
- * mtxUnblockLock - mutex or CS
- * nWaitersGone - int
- * nWaitersBlocked - int
- * nWaitersToUnblock - int
- * 
- * wait( timeout ) {
- * 
- *   [auto: register int result          ]     // error checking omitted
- *   [auto: register int nSignalsWasLeft ]
- *   [auto: register int nWaitersWasGone ]
- * 
- *   sem_wait( semBlockLock );
- *   nWaitersBlocked++;
- *   sem_post( semBlockLock );
- * 
- *   unlock( mtxExternal );
- *   bTimedOut = sem_wait( semBlockQueue,timeout );
- * 
- *   lock( mtxUnblockLock );
- *   if ( 0 != (nSignalsWasLeft = nWaitersToUnblock) ) {
- *     if ( bTimeout ) {                       // timeout (or canceled)
- *       if ( 0 != nWaitersBlocked ) {
- *         nWaitersBlocked--;
- *       }
- *       else {
- *         nWaitersGone++;                     // count spurious wakeups.
- *       }
- *     }
- *     if ( 0 == --nWaitersToUnblock ) {
- *       if ( 0 != nWaitersBlocked ) {
- *         sem_post( semBlockLock );           // open the gate.
- *         nSignalsWasLeft = 0;                // do not open the gate
- *                                             // below again.
- *       }
- *       else if ( 0 != (nWaitersWasGone = nWaitersGone) ) {
- *         nWaitersGone = 0;
- *       }
- *     }
- *   }
- *   else if ( INT_MAX/2 == ++nWaitersGone ) { // timeout/canceled or
- *                                             // spurious semaphore :-)
- *     sem_wait( semBlockLock );
- *     nWaitersBlocked -= nWaitersGone;     // something is going on here
- *                                          //  - test of timeouts? :-)
- *     sem_post( semBlockLock );
- *     nWaitersGone = 0;
- *   }
- *   unlock( mtxUnblockLock );
- * 
- *   if ( 1 == nSignalsWasLeft ) {
- *     if ( 0 != nWaitersWasGone ) {
- *       // sem_adjust( semBlockQueue,-nWaitersWasGone );
- *       while ( nWaitersWasGone-- ) {
- *         sem_wait( semBlockQueue );       // better now than spurious later
- *       }
- *     } sem_post( semBlockLock );          // open the gate
- *   }
- * 
- *   lock( mtxExternal );
- * 
- *   return ( bTimedOut ) ? ETIMEOUT : 0;
- * }
- * 
- * signal(bAll) {
- * 
- *   [auto: register int result         ]
- *   [auto: register int nSignalsToIssue]
- * 
- *   lock( mtxUnblockLock );
- * 
- *   if ( 0 != nWaitersToUnblock ) {        // the gate is closed!!!
- *     if ( 0 == nWaitersBlocked ) {        // NO-OP
- *       return unlock( mtxUnblockLock );
- *     }
- *     if (bAll) {
- *       nWaitersToUnblock += nSignalsToIssue=nWaitersBlocked;
- *       nWaitersBlocked = 0;
- *     }
- *     else {
- *       nSignalsToIssue = 1;
- *       nWaitersToUnblock++;
- *       nWaitersBlocked--;
- *     }
- *   }
- *   else if ( nWaitersBlocked > nWaitersGone ) { // HARMLESS RACE CONDITION!
- *     sem_wait( semBlockLock );                  // close the gate
- *     if ( 0 != nWaitersGone ) {
- *       nWaitersBlocked -= nWaitersGone;
- *       nWaitersGone = 0;
- *     }
- *     if (bAll) {
- *       nSignalsToIssue = nWaitersToUnblock = nWaitersBlocked;
- *       nWaitersBlocked = 0;
- *     }
- *     else {
- *       nSignalsToIssue = nWaitersToUnblock = 1;
- *       nWaitersBlocked--;
- *     }
- *   }
- *   else { // NO-OP
- *     return unlock( mtxUnblockLock );
+ * wait( mutex, timeout ) {
+ *   lock( cv );  enqueue( cv, self, WAITING );  unlock( cv );
+ *   unlock( mutex );
+ *   wait( self.event, timeout );
+ *   if ( CAS( self.state, WAITING -> WITHDRAWN ) ) {  // timeout/cancel
+ *     lock( cv );  dequeue( cv, self );  unlock( cv );
+ *   } else {                               // a wake-up is ours
+ *     if ( timed out or canceled ) consume( self.event );
+ *     if ( self.state == OWNER ) return 0; // see broadcast
+ *     timed out = FALSE;
  *   }
- * 
- *   unlock( mtxUnblockLock );
- *   sem_post( semBlockQueue,nSignalsToIssue );
- *   return result;
+ *   lock( mutex );
+ *   return ( timed out ) ? ETIMEDOUT : 0;
  * }
- * -------------------------------------------------------------
- *
- *     Algorithm 9 / IMPL_SEM,UNBLOCK_STRATEGY == UNBLOCK_ALL
- * 
- * presented below in pseudo-code; basically 8a...
- *                                      ...BUT W/O "spurious wakes" prevention:
  *
+ * signal() {
+ *   lock( cv );
+ *   w = first node with CAS( w.state, WAITING -> SIGNALLED );
+ *   dequeue( cv, w );
+ *   unlock( cv );
+ *   set( w.event );                        // exactly one wake-up
+ * }
  *
- * given:
- * semBlockLock - bin.semaphore
- * semBlockQueue - semaphore
- * mtxExternal - mutex or CS
- * mtxUnblockLock - mutex or CS
- * nWaitersGone - int
- * nWaitersBlocked - int
- * nWaitersToUnblock - int
- * 
- * wait( timeout ) {
- * 
- *   [auto: register int result          ]     // error checking omitted
- *   [auto: register int nSignalsWasLeft ]
- * 
- *   sem_wait( semBlockLock );
- *   ++nWaitersBlocked;
- *   sem_post( semBlockLock );
- * 
- *   unlock( mtxExternal );
- *   bTimedOut = sem_wait( semBlockQueue,timeout );
- * 
- *   lock( mtxUnblockLock );
- *   if ( 0 != (nSignalsWasLeft = nWaitersToUnblock) ) {
- *     --nWaitersToUnblock;
- *   }
- *   else if ( INT_MAX/2 == ++nWaitersGone ) { // timeout/canceled or
- *                                             // spurious semaphore :-)
- *     sem_wait( semBlockLock );
- *     nWaitersBlocked -= nWaitersGone;        // something is going on here
- *                                             //  - test of timeouts? :-)
- *     sem_post( semBlockLock );
- *     nWaitersGone = 0;
- *   }
- *   unlock( mtxUnblockLock );
- * 
- *   if ( 1 == nSignalsWasLeft ) {
- *     sem_post( semBlockLock );               // open the gate
+ * broadcast() {
+ *   lock( cv );
+ *   if ( all waiters share a non-robust mutex ) {
+ *     lock( mutex.morph );                 // wait morphing
+ *     move each WAITING node to mutex.morph queue as MORPHED;
+ *     unlock( mutex.morph );  unlock( cv );
+ *     make sure mutex unlock takes the slow path;
+ *   } else {
+ *     dequeue every WAITING node as SIGNALLED;
+ *     unlock( cv );
+ *     set( every w.event );
  *   }
- * 
- *   lock( mtxExternal );
- * 
- *   return ( bTimedOut ) ? ETIMEOUT : 0;
  * }
- * 
- * signal(bAll) {
- * 
- *   [auto: register int result         ]
- *   [auto: register int nSignalsToIssue]
- * 
- *   lock( mtxUnblockLock );
- * 
- *   if ( 0 != nWaitersToUnblock ) {        // the gate is closed!!!
- *     if ( 0 == nWaitersBlocked ) {        // NO-OP
- *       return unlock( mtxUnblockLock );
- *     }
- *     if (bAll) {
- *       nWaitersToUnblock += nSignalsToIssue=nWaitersBlocked;
- *       nWaitersBlocked = 0;
- *     }
- *     else {
- *       nSignalsToIssue = 1;
- *       ++nWaitersToUnblock;
- *       --nWaitersBlocked;
- *     }
- *   }
- *   else if ( nWaitersBlocked > nWaitersGone ) { // HARMLESS RACE CONDITION!
- *     sem_wait( semBlockLock );                  // close the gate
- *     if ( 0 != nWaitersGone ) {
- *       nWaitersBlocked -= nWaitersGone;
- *       nWaitersGone = 0;
- *     }
- *     if (bAll) {
- *       nSignalsToIssue = nWaitersToUnblock = nWaitersBlocked;
- *       nWaitersBlocked = 0;
- *     }
- *     else {
- *       nSignalsToIssue = nWaitersToUnblock = 1;
- *       --nWaitersBlocked;
- *     }
- *   }
- *   else { // NO-OP
- *     return unlock( mtxUnblockLock );
- *   }
  *
- *   unlock( mtxUnblockLock );
- *   sem_post( semBlockQueue,nSignalsToIssue );
- *   return result;
- * }
+ * A mutex unlock that finds morphed waiters passes ownership straight
+ * to the first of them (state OWNER) instead of releasing the mutex,
+ * so broadcast wakes nobody itself and each waiter wakes exactly once,
+ * already holding the mutex. See ptw32_cond_queue.c.
+ *
+ * Signalled waiters never touch the condition variable again, so it
+ * may be destroyed as soon as its FIFO is empty.
+ *
+ * The Terekhov/Thomas "Algorithm 8a" on two semaphores that was used
+ * previously is discussed in README.CV.
  * -------------------------------------------------------------
  */
 
@@ -273,7 +106,9 @@ typedef struct
 {
   pthread_mutex_t *mutexPtr;
   pthread_cond_t cv;
+  ptw32_cond_waiter_t *waiter;
   int *resultPtr;
+  int woken;			/* The wait consumed our wake-up */
 } ptw32_cond_wait_cleanup_args_t;
 
 static void PTW32_CDECL
@@ -281,65 +116,57 @@ ptw32_cond_wait_cleanup (void *args)
 {
   ptw32_cond_wait_cleanup_args_t *cleanup_args =
     (ptw32_cond_wait_cleanup_args_t *) args;
-  pthread_cond_t cv = cleanup_args->cv;
+  ptw32_cond_waiter_t *w = cleanup_args->waiter;
   int *resultPtr = cleanup_args->resultPtr;
-  int nSignalsWasLeft;
+  LONG state;
   int result;
 
   /*
    * Whether we got here as a result of signal/broadcast or because of
    * timeout on wait or thread cancellation we indicate that we are no
-   * longer waiting. The waiter is responsible for adjusting waiters
-   * (to)unblock(ed) counts (protected by unblock lock).
+   * longer waiting. If nobody has dequeued us yet we withdraw our node.
+   * Otherwise a signal or broadcast has already counted us as woken and
+   * we must consume its wake-up, if the wait didn't, so that our event
+   * is unsignalled for the next wait. In the case of a timeout that
+   * wake-up makes the wait successful; in the case of a cancellation,
+   * as before, the wake-up is consumed and we cancel anyway.
    */
-  if ((result = pthread_mutex_lock (&(cv->mtxUnblockLock))) != 0)
-    {
-      *resultPtr = result;
-      return;
-    }
+  state = (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                   (PTW32_INTERLOCKED_LONGPTR) &w->state,
+                   (PTW32_INTERLOCKED_LONG) PTW32_COND_WITHDRAWN,
+                   (PTW32_INTERLOCKED_LONG) PTW32_COND_WAITING);
 
-  if (0 != (nSignalsWasLeft = cv->nWaitersToUnblock))
+  if (state == PTW32_COND_WAITING)
     {
-      --(cv->nWaitersToUnblock);
+      ptw32_mcs_local_node_t node;
+      pthread_cond_t cv = cleanup_args->cv;
+
+      ptw32_mcs_lock_acquire (&cv->lock, &node);
+      ptw32_cond_queue_remove (&cv->head, &cv->tail, w);
+      ptw32_mcs_lock_release (&node);
     }
-  else if (INT_MAX / 2 == ++(cv->nWaitersGone))
+  else
     {
-      /* Use the non-cancellable version of sem_wait() */
-      if (ptw32_semwait (&(cv->semBlockLock)) != 0)
+      if (state == PTW32_COND_MORPHED)
 	{
-	  *resultPtr = PTW32_GET_ERRNO();
-	  /*
-	   * This is a fatal error for this CV,
-	   * so we deliberately don't unlock
-	   * cv->mtxUnblockLock before returning.
-	   */
-	  return;
+	  state = ptw32_cond_morph_withdraw (w);
 	}
-      cv->nWaitersBlocked -= cv->nWaitersGone;
-      if (sem_post (&(cv->semBlockLock)) != 0)
+
+      if (state != PTW32_COND_WITHDRAWN && !cleanup_args->woken)
 	{
-	  *resultPtr = PTW32_GET_ERRNO();
-	  /*
-	   * This is a fatal error for this CV,
-	   * so we deliberately don't unlock
-	   * cv->mtxUnblockLock before returning.
-	   */
-	  return;
+	  (void) WaitForSingleObject (w->event, INFINITE);
 	}
-      cv->nWaitersGone = 0;
-    }
 
-  if ((result = pthread_mutex_unlock (&(cv->mtxUnblockLock))) != 0)
-    {
-      *resultPtr = result;
-      return;
-    }
+      if (*resultPtr == ETIMEDOUT)
+	{
+	  *resultPtr = 0;
+	}
 
-  if (1 == nSignalsWasLeft)
-    {
-      if (sem_post (&(cv->semBlockLock)) != 0)
+      if (state == PTW32_COND_OWNER)
 	{
-	  *resultPtr = PTW32_GET_ERRNO();
+	  /*
+	   * The mutex was handed to us by pthread_mutex_unlock.
+	   */
 	  return;
 	}
     }
@@ -352,6 +179,13 @@ ptw32_cond_wait_cleanup (void *args)
     {
       *resultPtr = result;
     }
+  else if (!PTW32_PSHARED_IS_HANDLE(*cleanup_args->mutexPtr))
+    {
+      /*
+       * Other waiters may still be queued on the mutex by a broadcast.
+       */
+      ptw32_cond_morph_arm (*cleanup_args->mutexPtr);
+    }
 }				/* ptw32_cond_wait_cleanup */
 
 static INLINE int
@@ -360,7 +194,11 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
 {
   int result = 0;
   pthread_cond_t cv;
+  ptw32_thread_t *sp;
+  ptw32_cond_waiter_t waiter;
   ptw32_cond_wait_cleanup_args_t cleanup_args;
+  ptw32_mcs_local_node_t node;
+  DWORD milliseconds;
 
   if (cond == NULL || *cond == NULL)
     {
@@ -385,25 +223,72 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
 
   cv = *cond;
 
-  /* Thread can be cancelled in sem_wait() but this is OK */
-  if (sem_wait (&(cv->semBlockLock)) != 0)
+  if (PTW32_PSHARED_IS_HANDLE(cv))
     {
-      return PTW32_GET_ERRNO();
+      return ptw32_pshared_cond_wait (cv, mutex, abstime);
     }
 
-  ++(cv->nWaitersBlocked);
+#if defined(PTW32_SRW)
+  /*
+   * Waits with an SRW-backed mutex sleep on the native condition
+   * variable instead of joining the waiter FIFO.
+   */
+  if (mutex != NULL
+      && *mutex < PTHREAD_ERRORCHECK_MUTEX_INITIALIZER
+      && !PTW32_PSHARED_IS_HANDLE(*mutex)
+      && (*mutex)->kind >= 0)
+    {
+      return ptw32_srw_cond_wait (cv, *mutex, abstime);
+    }
+#endif
+
+  /*
+   * The calling thread's wake-up event is created the first time it
+   * waits on any condition variable and kept until it exits.
+   */
+  sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp == NULL)
+    {
+      return ENOSPC;
+    }
 
-  if (sem_post (&(cv->semBlockLock)) != 0)
+  if (sp->condEvent == NULL
+      && (sp->condEvent = CreateEvent (NULL, PTW32_FALSE,	/* auto reset */
+				       PTW32_FALSE, NULL)) == NULL)
     {
-      return PTW32_GET_ERRNO();
+      return ENOSPC;
     }
 
+  if (abstime == NULL)
+    {
+      milliseconds = INFINITE;
+    }
+  else
+    {
+      /*
+       * Calculate timeout as milliseconds from current system time.
+       */
+      milliseconds = ptw32_relmillisecs (abstime);
+    }
+
+  waiter.event = sp->condEvent;
+  waiter.self = sp->ptHandle;
+  waiter.mx = *mutex;
+  waiter.state = PTW32_COND_WAITING;
+
+  ptw32_mcs_lock_acquire (&cv->lock, &node);
+  ptw32_cond_queue_add (&cv->head, &cv->tail, &waiter);
+  ptw32_mcs_lock_release (&node);
+
   /*
    * Setup this waiter cleanup handler
    */
   cleanup_args.mutexPtr = mutex;
   cleanup_args.cv = cv;
+  cleanup_args.waiter = &waiter;
   cleanup_args.resultPtr = &result;
+  cleanup_args.woken = 0;
 
 #if defined(PTW32_CONFIG_MSVC7)
 #pragma inline_depth(0)
@@ -425,17 +310,15 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
        *
        * Note:
        *
-       *      sem_timedwait is a cancellation point,
+       *      pthreadCancelableTimedWait is a cancellation point,
        *      hence providing the mechanism for making
        *      pthread_cond_wait a cancellation point.
        *      We use the cleanup mechanism to ensure we
-       *      re-lock the mutex and adjust (to)unblock(ed) waiters
-       *      counts if we are cancelled, timed out or signalled.
+       *      leave the queue and re-lock the mutex if we are
+       *      cancelled, timed out or signalled.
        */
-      if (sem_timedwait (&(cv->semBlockQueue), abstime) != 0)
-	{
-	  result = PTW32_GET_ERRNO();
-	}
+      result = pthreadCancelableTimedWait (waiter.event, milliseconds);
+      cleanup_args.woken = (result == 0);
     }
 
   /*
@@ -82,7 +82,7 @@ pthread_condattr_destroy (pthread_condattr_t * attr)
     }
   else
     {
-      (void) free (*attr);
+      ptw32_slab_free (*attr, sizeof (**attr));
 
       *attr = NULL;
       result = 0;
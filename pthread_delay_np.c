@@ -142,7 +142,7 @@ pthread_delay_np (struct timespec *interval)
        * Deferred cancellation will cancel us immediately.
        */
       if (WAIT_OBJECT_0 ==
-	  (status = WaitForSingleObject (sp->cancelEvent, wait_time)))
+	  (status = WaitForSingleObject (ptw32_get_cancel_event (sp), wait_time)))
 	{
           ptw32_mcs_local_node_t stateLock;
 	  /*
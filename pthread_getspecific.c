@@ -70,11 +70,30 @@ pthread_getspecific (pthread_key_t key)
       * ------------------------------------------------------
       */
 {
-  void * ptr;
+  void * ptr = NULL;
+  ptw32_thread_t * sp;
 
   if (key == NULL)
     {
-      ptr = NULL;
+      return NULL;
+    }
+
+  if (key->index >= 0)
+    {
+      /*
+       * Don't use pthread_self(): a thread that has no ptw32_thread_t
+       * yet has set no values.
+       */
+#if defined(PTW32_SELF_TLS)
+      sp = ptw32_selfThread;
+#else
+      sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+#endif
+
+      if (sp != NULL)
+        {
+          ptr = PTW32_TSD_GET (sp, key);
+        }
     }
   else
     {
@@ -80,10 +80,12 @@ pthread_key_create (pthread_key_t * key, void (PTW32_CDECL *destructor) (void *)
       *      thread with a non-NULL value for key terminates, 'destructor'
       *      is called with key's current value for that thread.
       *
+      *      Keys don't use Win32 TLS slots, and there is no limit
+      *      on their number other than memory.
+      *
       * RESULTS
       *              0               successfully created semaphore,
-      *              EAGAIN          insufficient resources or PTHREAD_KEYS_MAX
-      *                              exceeded,
+      *              EAGAIN          insufficient resources,
       *              ENOMEM          insufficient memory to create the key,
       *
       * ------------------------------------------------------
@@ -96,14 +98,29 @@ pthread_key_create (pthread_key_t * key, void (PTW32_CDECL *destructor) (void *)
     {
       result = ENOMEM;
     }
-  else if ((newkey->key = TlsAlloc ()) == TLS_OUT_OF_INDEXES)
+  else if (key == &ptw32_selfThreadKey)
     {
-      result = EAGAIN;
+      /*
+       * Called from ptw32_processInitialize. The key that finds a
+       * thread's ptw32_thread_t can't be kept in it.
+       */
+      newkey->index = -1;
+
+      if ((newkey->key = TlsAlloc ()) == TLS_OUT_OF_INDEXES)
+        {
+          result = EAGAIN;
 
+          free (newkey);
+          newkey = NULL;
+        }
+    }
+  else if ((result = ptw32_key_index_alloc (newkey)) != 0)
+    {
       free (newkey);
       newkey = NULL;
     }
-  else if (destructor != NULL)
+
+  if (newkey != NULL && destructor != NULL)
     {
       /*
        * Have to manage associations between thread and key;
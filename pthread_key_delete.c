@@ -114,7 +114,14 @@ pthread_key_delete (pthread_key_t key)
           ptw32_mcs_lock_release (&keyLock);
         }
 
-      TlsFree (key->key);
+      if (key->index < 0)
+        {
+          TlsFree (key->key);
+        }
+      else
+        {
+          ptw32_key_index_free (key);
+        }
       if (key->destructor != NULL)
         {
           /* A thread could be holding the keyLock */
@@ -183,6 +183,11 @@ pthread_mutex_consistent (pthread_mutex_t* mutex)
       return EINVAL;
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(mx))
+    {
+      return ptw32_pshared_mutex_consistent (mx);
+    }
+
   if (mx->kind >= 0
         || (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_INCONSISTENT != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
                                                 (PTW32_INTERLOCKED_LONGPTR)&mx->robustNode->stateInconsistent,
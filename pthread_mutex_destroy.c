@@ -55,6 +55,11 @@ pthread_mutex_destroy (pthread_mutex_t * mutex)
    * Let the system deal with invalid pointers.
    */
 
+  if (PTW32_PSHARED_IS_HANDLE(*mutex))
+    {
+      return ptw32_pshared_mutex_destroy (mutex);
+    }
+
   /*
    * Check to see if we have something to delete.
    */
@@ -70,7 +75,19 @@ pthread_mutex_destroy (pthread_mutex_t * mutex)
        */
       if (0 == result || ENOTRECOVERABLE == result)
 	{
-	  if (mx->kind != PTHREAD_MUTEX_RECURSIVE || 1 == mx->recursive_count)
+	  if (PTW32_MUTEX_MORPH_PENDING(mx))
+	    {
+	      /*
+	       * Condition variable waiters are still queued to
+	       * acquire the mutex. Let the first of them have it.
+	       */
+	      if (0 == result)
+	        {
+	          (void) pthread_mutex_unlock (&mx);
+	        }
+	      result = EBUSY;
+	    }
+	  else if (mx->kind != PTHREAD_MUTEX_RECURSIVE || 1 == mx->recursive_count)
 	    {
 	      /*
 	       * FIXME!!!
@@ -89,14 +106,14 @@ pthread_mutex_destroy (pthread_mutex_t * mutex)
                     {
                       free(mx->robustNode);
                     }
-		  if (!CloseHandle (mx->event))
+		  if (mx->event != NULL && !CloseHandle (mx->event))
 		    {
 		      *mutex = mx;
 		      result = EINVAL;
 		    }
 		  else
 		    {
-		      free (mx);
+		      ptw32_slab_free (mx, sizeof (*mx));
 		    }
 		}
 	      else
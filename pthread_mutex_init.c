@@ -62,25 +62,13 @@ pthread_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr)
         {
           /*
            * Creating mutex that can be shared between
-           * processes.
+           * processes. See ptw32_pshared.c.
            */
-#if _POSIX_THREAD_PROCESS_SHARED >= 0
-
-          /*
-           * Not implemented yet.
-           */
-
-#error ERROR [__FILE__, line __LINE__]: Process shared mutexes are not supported yet.
-
-#else
-
-          return ENOSYS;
-
-#endif /* _POSIX_THREAD_PROCESS_SHARED */
+          return ptw32_pshared_mutex_init (mutex, attr);
         }
     }
 
-  mx = (pthread_mutex_t) calloc (1, sizeof (*mx));
+  mx = (pthread_mutex_t) ptw32_slab_calloc (sizeof (*mx));
 
   if (mx == NULL)
     {
@@ -90,7 +78,11 @@ pthread_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr)
     {
       mx->lock_idx = 0;
       mx->recursive_count = 0;
+      mx->spinCount = 0;
       mx->robustNode = NULL;
+      mx->morphLock = NULL;
+      mx->morphHead = NULL;
+      mx->morphTail = NULL;
       if (attr == NULL || *attr == NULL)
         {
           mx->kind = PTHREAD_MUTEX_DEFAULT;
@@ -128,14 +120,25 @@ pthread_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr)
 	{
 	  mx->ownerThread.p = NULL;
 
-	  mx->event = CreateEvent (NULL,  PTW32_FALSE,    /* manual reset = No */
-				    PTW32_FALSE,           /* initial state = not signalled */
-				   NULL);                 /* event name */
+	  /*
+	   * The event that contended waiters block on is created on first
+	   * contention, or never if the system supports waiting on the
+	   * lock word itself. See ptw32_mutex_wait.c.
+	   */
+	  mx->event = NULL;
 
-	  if (0 == mx->event)
+#if defined(PTW32_SRW)
+	  if (mx->kind >= 0)
 	    {
-	      result = ENOSPC;
+	      /*
+	       * Backed by mx->srw. Keep the inline fast paths out.
+	       * See ptw32_srw.c.
+	       */
+	      InitializeSRWLock (&mx->srw);
+	      ptw32_srw_timed_init (&mx->srwTimed);
+	      mx->lock_idx = -1;
 	    }
+#endif
 	}
     }
 
@@ -145,7 +148,7 @@ pthread_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr)
 	{
 	  free (mx->robustNode);
 	}
-      free (mx);
+      ptw32_slab_free (mx, sizeof (*mx));
       mx = NULL;
     }
 
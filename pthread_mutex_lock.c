@@ -62,6 +62,11 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
       return EINVAL;
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(mx))
+    {
+      return ptw32_pshared_mutex_lock (mx, PTW32_FALSE, NULL);
+    }
+
   /*
    * We do a quick check to see if we need to do more work
    * to initialise a static mutex. We check
@@ -79,6 +84,13 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
 
   kind = mx->kind;
 
+#if defined(PTW32_SRW)
+  if (kind >= 0)
+    {
+      return ptw32_srw_mutex_lock (mx, NULL);
+    }
+#endif
+
   if (kind >= 0)
     {
       /* Non-robust */
@@ -92,9 +104,32 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                               (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			      (PTW32_INTERLOCKED_LONG) -1) != 0)
 	        {
-	          if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+	          if (0 != (result = ptw32_mutex_wait (mx, NULL)))
+	            {
+		      break;
+	            }
+	        }
+	    }
+        }
+      else if (PTHREAD_MUTEX_ADAPTIVE_NP == kind)
+        {
+          /*
+           * Like NORMAL but spin for a while before sleeping. The first
+           * attempt must not overwrite a -1 (waiters) lock_idx because
+           * we may not get to re-assert it until after spinning.
+           */
+          if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+		       (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+		       (PTW32_INTERLOCKED_LONG) 1,
+		       (PTW32_INTERLOCKED_LONG) 0) != 0
+	      && !ptw32_mutex_adaptive_spin (mx))
+	    {
+	      while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                              (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+			      (PTW32_INTERLOCKED_LONG) -1) != 0)
+	        {
+	          if (0 != (result = ptw32_mutex_wait (mx, NULL)))
 	            {
-	              result = EINVAL;
 		      break;
 	            }
 	        }
@@ -131,9 +166,8 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                                   (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			          (PTW32_INTERLOCKED_LONG) -1) != 0)
 		    {
-	              if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+	              if (0 != (result = ptw32_mutex_wait (mx, NULL)))
 		        {
-	                  result = EINVAL;
 		          break;
 		        }
 		    }
@@ -168,7 +202,7 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
 
           kind = -kind - 1; /* Convert to non-robust range */
     
-          if (PTHREAD_MUTEX_NORMAL == kind)
+          if (PTHREAD_MUTEX_NORMAL == kind || PTHREAD_MUTEX_ADAPTIVE_NP == kind)
             {
               if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                            (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
@@ -179,9 +213,8 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                                        (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
                                        (PTW32_INTERLOCKED_LONG) -1) != 0)
                     {
-                      if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+                      if (0 != (result = ptw32_mutex_wait (mx, NULL)))
                         {
-                          result = EINVAL;
                           break;
                         }
                       if ((PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE ==
@@ -190,7 +223,7 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                                     (PTW32_INTERLOCKED_LONG)0))
                         {
                           /* Unblock the next thread */
-                          SetEvent(mx->event);
+                          (void) ptw32_mutex_wake (mx);
                           result = ENOTRECOVERABLE;
                           break;
                         }
@@ -239,9 +272,8 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                                            (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
                                            (PTW32_INTERLOCKED_LONG) -1) != 0)
                         {
-                          if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+                          if (0 != (result = ptw32_mutex_wait (mx, NULL)))
                             {
-                              result = EINVAL;
                               break;
                             }
                           if ((PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE ==
@@ -250,7 +282,7 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                                         (PTW32_INTERLOCKED_LONG)0))
                             {
                               /* Unblock the next thread */
-                              SetEvent(mx->event);
+                              (void) ptw32_mutex_wake (mx);
                               result = ENOTRECOVERABLE;
                               break;
                             }
@@ -45,72 +45,6 @@
 #include "implement.h"
 
 
-static INLINE int
-ptw32_timed_eventwait (HANDLE event, const struct timespec *abstime)
-     /*
-      * ------------------------------------------------------
-      * DESCRIPTION
-      *      This function waits on an event until signaled or until
-      *      abstime passes.
-      *      If abstime has passed when this routine is called then
-      *      it returns a result to indicate this.
-      *
-      *      If 'abstime' is a NULL pointer then this function will
-      *      block until it can successfully decrease the value or
-      *      until interrupted by a signal.
-      *
-      *      This routine is not a cancellation point.
-      *
-      * RESULTS
-      *              0               successfully signaled,
-      *              ETIMEDOUT       abstime passed
-      *              EINVAL          'event' is not a valid event,
-      *
-      * ------------------------------------------------------
-      */
-{
-
-  DWORD milliseconds;
-  DWORD status;
-
-  if (event == NULL)
-    {
-      return EINVAL;
-    }
-  else
-    {
-      if (abstime == NULL)
-	{
-	  milliseconds = INFINITE;
-	}
-      else
-	{
-	  /* 
-	   * Calculate timeout as milliseconds from current system time. 
-	   */
-	  milliseconds = ptw32_relmillisecs (abstime);
-	}
-
-      status = WaitForSingleObject (event, milliseconds);
-
-      if (status != WAIT_OBJECT_0)
-        {
-          if (status == WAIT_TIMEOUT)
-            {
-              return ETIMEDOUT;
-            }
-          else
-            {
-              return EINVAL;
-            }
-        }
-    }
-
-  return 0;
-
-}				/* ptw32_timed_semwait */
-
-
 int
 pthread_mutex_timedlock (pthread_mutex_t * mutex,
 			 const struct timespec *abstime)
@@ -127,6 +61,11 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
       return EINVAL;
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(mx))
+    {
+      return ptw32_pshared_mutex_lock (mx, PTW32_FALSE, abstime);
+    }
+
   /*
    * We do a quick check to see if we need to do more work
    * to initialise a static mutex. We check
@@ -144,6 +83,13 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 
   kind = mx->kind;
 
+#if defined(PTW32_SRW)
+  if (kind >= 0)
+    {
+      return ptw32_srw_mutex_lock (mx, abstime);
+    }
+#endif
+
   if (kind >= 0)
     {
       if (mx->kind == PTHREAD_MUTEX_NORMAL)
@@ -156,7 +102,29 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
                               (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			      (PTW32_INTERLOCKED_LONG) -1) != 0)
                 {
-	          if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
+	          if (0 != (result = ptw32_mutex_wait (mx, abstime)))
+		    {
+		      return result;
+		    }
+	        }
+	    }
+        }
+      else if (mx->kind == PTHREAD_MUTEX_ADAPTIVE_NP)
+        {
+          /*
+           * See pthread_mutex_lock.c
+           */
+          if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+		       (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+		       (PTW32_INTERLOCKED_LONG) 1,
+		       (PTW32_INTERLOCKED_LONG) 0) != 0
+	      && !ptw32_mutex_adaptive_spin (mx))
+	    {
+              while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                              (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+			      (PTW32_INTERLOCKED_LONG) -1) != 0)
+                {
+	          if (0 != (result = ptw32_mutex_wait (mx, abstime)))
 		    {
 		      return result;
 		    }
@@ -194,7 +162,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
                                   (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			          (PTW32_INTERLOCKED_LONG) -1) != 0)
                     {
-		      if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
+		      if (0 != (result = ptw32_mutex_wait (mx, abstime)))
 		        {
 		          return result;
 		        }
@@ -227,7 +195,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 
           kind = -kind - 1; /* Convert to non-robust range */
 
-          if (PTHREAD_MUTEX_NORMAL == kind)
+          if (PTHREAD_MUTEX_NORMAL == kind || PTHREAD_MUTEX_ADAPTIVE_NP == kind)
             {
               if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
 		           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
@@ -238,7 +206,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
                                   (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			          (PTW32_INTERLOCKED_LONG) -1) != 0)
                     {
-	              if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
+	              if (0 != (result = ptw32_mutex_wait (mx, abstime)))
 		        {
 		          return result;
 		        }
@@ -248,7 +216,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
                                     (PTW32_INTERLOCKED_LONG)0))
                         {
                           /* Unblock the next thread */
-                          SetEvent(mx->event);
+                          (void) ptw32_mutex_wake (mx);
                           result = ENOTRECOVERABLE;
                           break;
                         }
@@ -298,7 +266,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
                                           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			                  (PTW32_INTERLOCKED_LONG) -1) != 0)
                         {
-		          if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
+		          if (0 != (result = ptw32_mutex_wait (mx, abstime)))
 		            {
 		              return result;
 		            }
@@ -310,7 +278,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
                                     (PTW32_INTERLOCKED_LONG)0))
                         {
                           /* Unblock the next thread */
-                          SetEvent(mx->event);
+                          (void) ptw32_mutex_wake (mx);
                           result = ENOTRECOVERABLE;
                         }
                       else if (0 == result || EOWNERDEAD == result)
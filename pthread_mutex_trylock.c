@@ -60,6 +60,11 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
       return EINVAL;
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(mx))
+    {
+      return ptw32_pshared_mutex_lock (mx, PTW32_TRUE, NULL);
+    }
+
   /*
    * We do a quick check to see if we need to do more work
    * to initialise a static mutex. We check
@@ -77,6 +82,13 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
 
   kind = mx->kind;
 
+#if defined(PTW32_SRW)
+  if (kind >= 0)
+    {
+      return ptw32_srw_mutex_trylock (mx);
+    }
+#endif
+
   if (kind >= 0)
     {
       /* Non-robust */
@@ -85,7 +97,7 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
 		         (PTW32_INTERLOCKED_LONG) 1,
 		         (PTW32_INTERLOCKED_LONG) 0))
         {
-          if (kind != PTHREAD_MUTEX_NORMAL)
+          if (kind != PTHREAD_MUTEX_NORMAL && kind != PTHREAD_MUTEX_ADAPTIVE_NP)
 	    {
 	      mx->recursive_count = 1;
 	      mx->ownerThread = pthread_self ();
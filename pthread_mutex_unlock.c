@@ -55,6 +55,11 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
   int kind;
   int result = 0;
 
+  if (PTW32_PSHARED_IS_HANDLE(mx))
+    {
+      return ptw32_pshared_mutex_unlock (mx);
+    }
+
   /*
    * If the thread calling us holds the mutex then there is no
    * race condition. If another thread holds the
@@ -64,12 +69,30 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
     {
       kind = mx->kind;
 
+#if defined(PTW32_SRW)
       if (kind >= 0)
         {
-          if (kind == PTHREAD_MUTEX_NORMAL)
+          return ptw32_srw_mutex_unlock (mx);
+        }
+#endif
+
+      if (kind >= 0)
+        {
+          if (kind == PTHREAD_MUTEX_NORMAL || kind == PTHREAD_MUTEX_ADAPTIVE_NP)
 	    {
 	      LONG idx;
 
+	      if (PTW32_MUTEX_MORPH_PENDING(mx)
+	          && *(PTW32_INTERLOCKED_VOLATILE LONG *) &mx->lock_idx != 0
+	          && ptw32_cond_morph_handoff (mx))
+	        {
+	          /*
+	           * Ownership passed straight to a waiter that
+	           * pthread_cond_broadcast requeued on this mutex.
+	           */
+	          return 0;
+	        }
+
 	      idx = (LONG) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
 							    (PTW32_INTERLOCKED_LONG)0);
 	      if (idx != 0)
@@ -79,11 +102,20 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 		      /*
 		       * Someone may be waiting on that mutex.
 		       */
-		      if (SetEvent (mx->event) == 0)
+		      if (ptw32_mutex_wake (mx) != 0)
 		        {
 		          result = EINVAL;
 		        }
 		    }
+
+	          /*
+	           * A broadcast may have requeued waiters just as we
+	           * released the mutex. See ptw32_cond_queue.c.
+	           */
+	          if (PTW32_MUTEX_MORPH_PENDING(mx))
+		    {
+		      ptw32_cond_morph_kick (mx);
+		    }
 	        }
 	      else	/* [i_a] when unlocking an unlocked mutex, pthread_mutex_unlock() should always produce EPERM for any type of mutex -- see test mutex7.c */
 	        {
@@ -94,8 +126,10 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 	    {
 	      if (pthread_equal (mx->ownerThread, pthread_self()))
 	        {
-	          if (kind != PTHREAD_MUTEX_RECURSIVE
-		      || 0 == --mx->recursive_count)
+	          if ((kind != PTHREAD_MUTEX_RECURSIVE
+		       || 0 == --mx->recursive_count)
+		      && !(PTW32_MUTEX_MORPH_PENDING(mx)
+		           && ptw32_cond_morph_handoff (mx)))
 		    {
 		      mx->ownerThread.p = NULL;
 
@@ -103,11 +137,17 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 							          (PTW32_INTERLOCKED_LONG)0) < 0L)
 		        {
 		          /* Someone may be waiting on that mutex */
-		          if (SetEvent (mx->event) == 0)
+		          if (ptw32_mutex_wake (mx) != 0)
 			    {
 			      result = EINVAL;
 			    }
 		        }
+
+		      /* A broadcast may have requeued waiters meanwhile. */
+		      if (PTW32_MUTEX_MORPH_PENDING(mx))
+		        {
+		          ptw32_cond_morph_kick (mx);
+		        }
 		    }
 	        }
 	      else
@@ -131,7 +171,7 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
               PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &mx->robustNode->stateInconsistent,
                                                       (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE,
                                                       (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_INCONSISTENT);
-              if (PTHREAD_MUTEX_NORMAL == kind)
+              if (PTHREAD_MUTEX_NORMAL == kind || PTHREAD_MUTEX_ADAPTIVE_NP == kind)
                 {
                   ptw32_robust_mutex_remove(mutex, NULL);
 
@@ -141,7 +181,7 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
                       /*
                        * Someone may be waiting on that mutex.
                        */
-                      if (SetEvent (mx->event) == 0)
+                      if (ptw32_mutex_wake (mx) != 0)
                         {
                           result = EINVAL;
                         }
@@ -160,7 +200,7 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
                           /*
                            * Someone may be waiting on that mutex.
                            */
-                          if (SetEvent (mx->event) == 0)
+                          if (ptw32_mutex_wake (mx) != 0)
                             {
                               result = EINVAL;
                             }
@@ -83,7 +83,7 @@ pthread_mutexattr_destroy (pthread_mutexattr_t * attr)
       pthread_mutexattr_t ma = *attr;
 
       *attr = NULL;
-      free (ma);
+      ptw32_slab_free (ma, sizeof (*ma));
     }
 
   return (result);
@@ -75,7 +75,7 @@ pthread_mutexattr_init (pthread_mutexattr_t * attr)
   int result = 0;
   pthread_mutexattr_t ma;
 
-  ma = (pthread_mutexattr_t) calloc (1, sizeof (*ma));
+  ma = (pthread_mutexattr_t) ptw32_slab_calloc (sizeof (*ma));
 
   if (ma == NULL)
     {
@@ -71,6 +71,8 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
       *
       *                      PTHREAD_MUTEX_RECURSIVE
       *
+      *                      PTHREAD_MUTEX_ADAPTIVE_NP
+      *
       * DESCRIPTION
       * The pthread_mutexattr_settype() and
       * pthread_mutexattr_gettype() functions  respectively set and
@@ -118,6 +120,13 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
       *          process        shared         attribute         is
       *          PTHREAD_PROCESS_PRIVATE.
       *
+      * PTHREAD_MUTEX_ADAPTIVE_NP
+      *          Non-portable. Behaves as PTHREAD_MUTEX_NORMAL except
+      *          that a thread finding the mutex locked spins for a
+      *          bounded, self-tuning number of iterations before
+      *          blocking. Suited to short critical sections on
+      *          multi-processor systems.
+      *
       * RESULTS
       *              0               successfully set attribute,
       *              EINVAL          'attr' or 'type' is invalid,
@@ -134,6 +143,7 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
 	case PTHREAD_MUTEX_FAST_NP:
 	case PTHREAD_MUTEX_RECURSIVE_NP:
 	case PTHREAD_MUTEX_ERRORCHECK_NP:
+	case PTHREAD_MUTEX_ADAPTIVE_NP:
 	  (*attr)->kind = kind;
 	  break;
 	default:
@@ -57,6 +57,11 @@ pthread_rwlock_destroy (pthread_rwlock_t * rwlock)
       return EINVAL;
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(*rwlock))
+    {
+      return ptw32_pshared_rwlock_destroy (rwlock);
+    }
+
   if (*rwlock != PTHREAD_RWLOCK_INITIALIZER)
     {
       rwl = *rwlock;
@@ -66,6 +71,29 @@ pthread_rwlock_destroy (pthread_rwlock_t * rwlock)
 	  return EINVAL;
 	}
 
+      if (rwl->readers != NULL && ptw32_rwlock_bias_busy (rwl))
+	{
+	  return EBUSY;
+	}
+
+      if (PTW32_RWLOCK_IS_POLICY (rwl)
+	  && (result = ptw32_rwlock_policy_destroy (rwl)) != 0)
+	{
+	  return result;
+	}
+
+#if defined(PTW32_SRW)
+      /*
+       * The counters below are unused in this mode; the lock is busy
+       * if it can't be taken exclusively right now.
+       */
+      if (!TryAcquireSRWLockExclusive (&rwl->srw))
+	{
+	  return EBUSY;
+	}
+      ReleaseSRWLockExclusive (&rwl->srw);
+#endif
+
       if ((result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess))) != 0)
 	{
 	  return result;
@@ -110,7 +138,8 @@ pthread_rwlock_destroy (pthread_rwlock_t * rwlock)
 	  result = pthread_cond_destroy (&(rwl->cndSharedAccessCompleted));
 	  result1 = pthread_mutex_destroy (&(rwl->mtxSharedAccessCompleted));
 	  result2 = pthread_mutex_destroy (&(rwl->mtxExclusiveAccess));
-	  (void) free (rwl);
+	  (void) free (rwl->readersMem);
+	  ptw32_slab_free (rwl, sizeof (*rwl));
 	}
     }
   else
@@ -0,0 +1,134 @@
+/*
+ * pthread_rwlock_downgrade_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_rwlock_downgrade_np (pthread_rwlock_t * rwlock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Downgrades a write lock to a read lock.
+      *
+      * PARAMETERS
+      *      rwlock
+      *              pointer to an instance of pthread_rwlock_t
+      *              on which the caller holds the write lock.
+      *
+      *
+      * DESCRIPTION
+      *      Atomically converts the calling thread's write lock into
+      *      a read lock: no writer can acquire the lock in between.
+      *      Waiting readers may be let in at the same time.
+      *
+      * RESULTS
+      *              0               the caller now holds a read lock,
+      *              EINVAL          'rwlock' is invalid,
+      *              EPERM           the caller does not hold the write lock,
+      *              ENOTSUP         not available for this lock (a
+      *                              process-shared lock, or see
+      *                              PTW32_SRW in config.h).
+      *
+      * ------------------------------------------------------
+      */
+{
+#if !defined(PTW32_SRW)
+  int result, result1;
+#endif
+  pthread_rwlock_t rwl;
+
+  if (rwlock == NULL || *rwlock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*rwlock == PTHREAD_RWLOCK_INITIALIZER)
+    {
+      return EPERM;
+    }
+
+  rwl = *rwlock;
+
+  if (PTW32_PSHARED_IS_HANDLE(rwl))
+    {
+      return ENOTSUP;
+    }
+
+  if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_RWLOCK_IS_POLICY (rwl))
+    {
+      return ptw32_rwlock_policy_downgrade (rwl);
+    }
+
+#if defined(PTW32_SRW)
+  return ENOTSUP;
+#else
+  /*
+   * The writer holds both mutexes. Become an ordinary reader and let
+   * the next waiter in.
+   */
+  if (rwl->nExclusiveAccessCount == 0)
+    {
+      return EPERM;
+    }
+
+  rwl->nExclusiveAccessCount--;
+  rwl->nSharedAccessCount++;
+
+  if (rwl->readers != NULL)
+    {
+      ptw32_rwlock_bias_rearm (rwl);
+    }
+
+  result = pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+  result1 = pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+
+  return ((result != 0) ? result : result1);
+#endif
+}
@@ -58,13 +58,20 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
       return EINVAL;
     }
 
-  if (attr != NULL && *attr != NULL)
+  if (attr != NULL && *attr != NULL
+      && (*attr)->pshared == PTHREAD_PROCESS_SHARED)
     {
-      result = EINVAL;		/* Not supported */
-      goto DONE;
+      /*
+       * Always writer-preferring; see ptw32_pshared_rwlock.c.
+       */
+      if ((*attr)->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+	{
+	  return EINVAL;
+	}
+      return ptw32_pshared_rwlock_init (rwlock);
     }
 
-  rwl = (pthread_rwlock_t) calloc (1, sizeof (*rwl));
+  rwl = (pthread_rwlock_t) ptw32_slab_calloc (sizeof (*rwl));
 
   if (rwl == NULL)
     {
@@ -72,9 +79,22 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
       goto DONE;
     }
 
+  rwl->kind = (attr != NULL && *attr != NULL) ? (*attr)->kind : PTHREAD_RWLOCK_DEFAULT_NP;
+
+  if (rwl->kind == PTHREAD_RWLOCK_READ_MOSTLY_NP
+      && (result = ptw32_rwlock_bias_init (rwl)) != 0)
+    {
+      goto FAIL0;
+    }
+
   rwl->nSharedAccessCount = 0;
   rwl->nExclusiveAccessCount = 0;
   rwl->nCompletedSharedAccessCount = 0;
+#if defined(PTW32_SRW)
+  InitializeSRWLock (&rwl->srw);
+  rwl->srwExclusive = 0;
+  ptw32_srw_timed_init (&rwl->srwTimed);
+#endif
 
   result = pthread_mutex_init (&rwl->mtxExclusiveAccess, NULL);
   if (result != 0)
@@ -94,11 +114,20 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
       goto FAIL2;
     }
 
+  if (PTW32_RWLOCK_IS_POLICY (rwl)
+      && (result = ptw32_rwlock_policy_init (rwl)) != 0)
+    {
+      goto FAIL3;
+    }
+
   rwl->nMagic = PTW32_RWLOCK_MAGIC;
 
   result = 0;
   goto DONE;
 
+FAIL3:
+  (void) pthread_cond_destroy (&(rwl->cndSharedAccessCompleted));
+
 FAIL2:
   (void) pthread_mutex_destroy (&(rwl->mtxSharedAccessCompleted));
 
@@ -106,7 +135,8 @@ FAIL1:
   (void) pthread_mutex_destroy (&(rwl->mtxExclusiveAccess));
 
 FAIL0:
-  (void) free (rwl);
+  (void) free (rwl->readersMem);
+  ptw32_slab_free (rwl, sizeof (*rwl));
   rwl = NULL;
 
 DONE:
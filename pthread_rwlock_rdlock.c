@@ -75,11 +75,30 @@ pthread_rwlock_rdlock (pthread_rwlock_t * rwlock)
 
   rwl = *rwlock;
 
+  if (PTW32_PSHARED_IS_HANDLE(rwl))
+    {
+      return ptw32_pshared_rwlock_lock (rwl, PTW32_FALSE, PTW32_FALSE, NULL);
+    }
+
   if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
     {
       return EINVAL;
     }
 
+  if (rwl->readers != NULL && ptw32_rwlock_bias_rdlock (rwl))
+    {
+      return 0;
+    }
+
+  if (PTW32_RWLOCK_IS_POLICY (rwl))
+    {
+      return ptw32_rwlock_policy_lock (rwl, PTW32_FALSE, PTW32_FALSE, NULL);
+    }
+
+#if defined(PTW32_SRW)
+  return ptw32_srw_rwlock_lock (rwl, 0, NULL);
+#endif
+
   if ((result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess))) != 0)
     {
       return result;
@@ -105,5 +124,11 @@ pthread_rwlock_rdlock (pthread_rwlock_t * rwlock)
 	}
     }
 
+  if (rwl->readers != NULL)
+    {
+      /* Still holding mtxExclusiveAccess, so no writer is revoking. */
+      ptw32_rwlock_bias_rearm (rwl);
+    }
+
   return (pthread_mutex_unlock (&(rwl->mtxExclusiveAccess)));
 }
@@ -76,11 +76,25 @@ pthread_rwlock_timedwrlock (pthread_rwlock_t * rwlock,
 
   rwl = *rwlock;
 
+  if (PTW32_PSHARED_IS_HANDLE(rwl))
+    {
+      return ptw32_pshared_rwlock_lock (rwl, PTW32_TRUE, PTW32_FALSE, abstime);
+    }
+
   if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
     {
       return EINVAL;
     }
 
+  if (PTW32_RWLOCK_IS_POLICY (rwl))
+    {
+      return ptw32_rwlock_policy_lock (rwl, PTW32_TRUE, PTW32_FALSE, abstime);
+    }
+
+#if defined(PTW32_SRW)
+  return ptw32_srw_rwlock_lock (rwl, 1, abstime);
+#endif
+
   if ((result =
        pthread_mutex_timedlock (&(rwl->mtxExclusiveAccess), abstime)) != 0)
     {
@@ -140,6 +154,12 @@ pthread_rwlock_timedwrlock (pthread_rwlock_t * rwlock,
   if (result == 0)
     {
       rwl->nExclusiveAccessCount++;
+
+      if (rwl->readers != NULL
+	  && (result = ptw32_rwlock_bias_revoke (rwl, PTW32_FALSE, abstime)) != 0)
+	{
+	  (void) pthread_rwlock_unlock (rwlock);
+	}
     }
 
   return result;
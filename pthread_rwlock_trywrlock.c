@@ -75,11 +75,25 @@ pthread_rwlock_trywrlock (pthread_rwlock_t * rwlock)
 
   rwl = *rwlock;
 
+  if (PTW32_PSHARED_IS_HANDLE(rwl))
+    {
+      return ptw32_pshared_rwlock_lock (rwl, PTW32_TRUE, PTW32_TRUE, NULL);
+    }
+
   if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
     {
       return EINVAL;
     }
 
+  if (PTW32_RWLOCK_IS_POLICY (rwl))
+    {
+      return ptw32_rwlock_policy_lock (rwl, PTW32_TRUE, PTW32_TRUE, NULL);
+    }
+
+#if defined(PTW32_SRW)
+  return ptw32_srw_rwlock_trylock (rwl, 1);
+#endif
+
   if ((result = pthread_mutex_trylock (&(rwl->mtxExclusiveAccess))) != 0)
     {
       return result;
@@ -118,6 +132,12 @@ pthread_rwlock_trywrlock (pthread_rwlock_t * rwlock)
       else
 	{
 	  rwl->nExclusiveAccessCount = 1;
+
+	  if (rwl->readers != NULL
+	      && (result = ptw32_rwlock_bias_revoke (rwl, PTW32_TRUE, NULL)) != 0)
+	    {
+	      (void) pthread_rwlock_unlock (rwlock);
+	    }
 	}
     }
   else
@@ -67,11 +67,30 @@ pthread_rwlock_unlock (pthread_rwlock_t * rwlock)
 
   rwl = *rwlock;
 
+  if (PTW32_PSHARED_IS_HANDLE(rwl))
+    {
+      return ptw32_pshared_rwlock_unlock (rwl);
+    }
+
   if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
     {
       return EINVAL;
     }
 
+  if (rwl->readers != NULL && ptw32_rwlock_bias_rdunlock (rwl))
+    {
+      return 0;
+    }
+
+  if (PTW32_RWLOCK_IS_POLICY (rwl))
+    {
+      return ptw32_rwlock_policy_unlock (rwl);
+    }
+
+#if defined(PTW32_SRW)
+  return ptw32_srw_rwlock_unlock (rwl);
+#endif
+
   if (rwl->nExclusiveAccessCount == 0)
     {
       if ((result =
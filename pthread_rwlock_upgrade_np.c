@@ -0,0 +1,84 @@
+/*
+ * pthread_rwlock_upgrade_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_rwlock_upgrade_np (pthread_rwlock_t * rwlock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Upgrades a read lock to a write lock.
+      *
+      * PARAMETERS
+      *      rwlock
+      *              pointer to an instance of pthread_rwlock_t
+      *              on which the caller holds a read lock.
+      *
+      *
+      * DESCRIPTION
+      *      Atomically converts the calling thread's read lock into
+      *      a write lock: no other writer can acquire the lock in
+      *      between. Waits for the other readers to release it.
+      *      Only one thread may be upgrading at a time.
+      *
+      *      On failure the caller still holds its read lock.
+      *
+      * RESULTS
+      *              0               the caller now holds a write lock,
+      *              EINVAL          'rwlock' is invalid,
+      *              EPERM           the caller does not hold a read lock,
+      *              EDEADLK         another thread is already upgrading, or
+      *                              (default kinds) a writer is already
+      *                              waiting for the caller's read lock,
+      *              ENOTSUP         not available for this lock (a
+      *                              process-shared lock, or see
+      *                              PTW32_SRW in config.h).
+      *
+      * ------------------------------------------------------
+      */
+{
+  return ptw32_rwlock_upgrade (rwlock, PTW32_FALSE);
+}
@@ -75,11 +75,25 @@ pthread_rwlock_wrlock (pthread_rwlock_t * rwlock)
 
   rwl = *rwlock;
 
+  if (PTW32_PSHARED_IS_HANDLE(rwl))
+    {
+      return ptw32_pshared_rwlock_lock (rwl, PTW32_TRUE, PTW32_FALSE, NULL);
+    }
+
   if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
     {
       return EINVAL;
     }
 
+  if (PTW32_RWLOCK_IS_POLICY (rwl))
+    {
+      return ptw32_rwlock_policy_lock (rwl, PTW32_TRUE, PTW32_FALSE, NULL);
+    }
+
+#if defined(PTW32_SRW)
+  return ptw32_srw_rwlock_lock (rwl, 1, NULL);
+#endif
+
   if ((result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess))) != 0)
     {
       return result;
@@ -134,6 +148,11 @@ pthread_rwlock_wrlock (pthread_rwlock_t * rwlock)
   if (result == 0)
     {
       rwl->nExclusiveAccessCount++;
+
+      if (rwl->readers != NULL)
+	{
+	  (void) ptw32_rwlock_bias_revoke (rwl, PTW32_FALSE, NULL);
+	}
     }
 
   return result;
@@ -84,7 +84,7 @@ pthread_rwlockattr_destroy (pthread_rwlockattr_t * attr)
       pthread_rwlockattr_t rwa = *attr;
 
       *attr = NULL;
-      free (rwa);
+      ptw32_slab_free (rwa, sizeof (*rwa));
     }
 
   return (result);
@@ -73,7 +73,7 @@ pthread_rwlockattr_init (pthread_rwlockattr_t * attr)
   int result = 0;
   pthread_rwlockattr_t rwa;
 
-  rwa = (pthread_rwlockattr_t) calloc (1, sizeof (*rwa));
+  rwa = (pthread_rwlockattr_t) ptw32_slab_calloc (sizeof (*rwa));
 
   if (rwa == NULL)
     {
@@ -82,6 +82,7 @@ pthread_rwlockattr_init (pthread_rwlockattr_t * attr)
   else
     {
       rwa->pshared = PTHREAD_PROCESS_PRIVATE;
+      rwa->kind = PTHREAD_RWLOCK_DEFAULT_NP;
     }
 
   *attr = rwa;
@@ -0,0 +1,125 @@
+/*
+ * pthread_rwlockattr_setkind_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_rwlockattr_setkind_np (pthread_rwlockattr_t * attr, int pref)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Selects the implementation used by rwlocks created
+      *      with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_rwlockattr_t
+      *
+      *      pref
+      *              must be one of:
+      *
+      *                      PTHREAD_RWLOCK_DEFAULT_NP
+      *                              The standard implementation.
+      *
+      *                      PTHREAD_RWLOCK_READ_MOSTLY_NP
+      *                              Readers normally acquire and release
+      *                              the lock without touching any shared
+      *                              cache line. Writers are slower, and
+      *                              each lock carries a few KB of reader
+      *                              slots.
+      *
+      *                      PTHREAD_RWLOCK_PREFER_READER_NP
+      *                              Readers never wait while only
+      *                              writers are waiting. Writers may
+      *                              starve.
+      *
+      *                      PTHREAD_RWLOCK_PREFER_WRITER_NP
+      *                              As in glibc, the same as
+      *                              PTHREAD_RWLOCK_PREFER_READER_NP.
+      *
+      *                      PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP
+      *                              Readers wait while a writer waits,
+      *                              and writers go before waiting
+      *                              readers. A thread must not take a
+      *                              second read lock. Readers may starve.
+      *
+      *                      PTHREAD_RWLOCK_PHASE_FAIR_NP
+      *                              Read and write phases alternate
+      *                              while both are waiting, so neither
+      *                              side can starve the other. A thread
+      *                              must not take a second read lock.
+      *
+      * DESCRIPTION
+      *      Selects the implementation used by rwlocks created
+      *      with 'attr'. The kinds differ only in performance
+      *      and in the order in which waiting threads are let in.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'pref' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (attr == NULL || *attr == NULL)
+    {
+      return EINVAL;
+    }
+
+  switch (pref)
+    {
+    case PTHREAD_RWLOCK_DEFAULT_NP:
+    case PTHREAD_RWLOCK_READ_MOSTLY_NP:
+    case PTHREAD_RWLOCK_PREFER_READER_NP:
+    case PTHREAD_RWLOCK_PREFER_WRITER_NP:
+    case PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP:
+    case PTHREAD_RWLOCK_PHASE_FAIR_NP:
+      (*attr)->kind = pref;
+      return 0;
+    default:
+      return EINVAL;
+    }
+
+}				/* pthread_rwlockattr_setkind_np */
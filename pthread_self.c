@@ -70,6 +70,17 @@ pthread_self (void)
   pthread_t nil = {NULL, 0};
   ptw32_thread_t * sp;
 
+#if defined(PTW32_SELF_TLS)
+  /*
+   * Fast path: the thread has been seen before. The library must
+   * already be initialised for the cache to have been set.
+   */
+  if ((sp = ptw32_selfThread) != NULL)
+    {
+      return sp->ptHandle;
+    }
+#endif
+
   if (!ptw32_processInitialize())
 	return nil;
 
@@ -0,0 +1,95 @@
+/*
+ * pthread_seqlock_init_np.c
+ *
+ * Description:
+ * This translation unit implements sequence lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_seqlock_init_np (pthread_seqlock_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a sequence lock.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_seqlock_t
+      *
+      * DESCRIPTION
+      *      Initialises a sequence lock. Writers exclude each other;
+      *      readers take no lock at all but must retry their read
+      *      if a writer was active meanwhile (see
+      *      pthread_seqlock_read_begin_np).
+      *
+      *      There is no static initializer.
+      *
+      * RESULTS
+      *              0               successfully initialised,
+      *              EINVAL          'lock' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_seqlock_t sl;
+
+  if (lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  sl = (pthread_seqlock_t) ptw32_slab_calloc (sizeof (*sl));
+
+  if (sl == NULL)
+    {
+      *lock = NULL;
+      return ENOMEM;
+    }
+
+  sl->seq = 0;
+  sl->lock = NULL;
+  *lock = sl;
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * pthread_seqlock_read_np.c
+ *
+ * Description:
+ * This translation unit implements sequence lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * A sequence lock is a counter that writers increment on entry and
+ * again on exit, so that it is odd while a write is in progress.
+ * A reader notes an even value, reads the protected data and checks
+ * that the counter hasn't changed; if it has, the data may be torn and
+ * the reader starts over. Readers never store to the lock, so any
+ * number of them run in parallel without contending for a cache line.
+ *
+ * Writers are serialised by an MCS queue lock, whose node is moved into
+ * the seqlock so that it can be released from a separate call.
+ *
+ * Intended for small, frequently read data that can be copied out
+ * cheaply. The read section may observe inconsistent values and must
+ * not act on them (e.g. follow pointers) before the retry check.
+ */
+
+unsigned int
+pthread_seqlock_read_begin_np (pthread_seqlock_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Starts an optimistic read.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an initialised pthread_seqlock_t
+      *
+      * DESCRIPTION
+      *      Waits while a writer is active and returns the
+      *      sequence to pass to pthread_seqlock_read_retry_np
+      *      after reading the protected data:
+      *
+      *          do
+      *            {
+      *              seq = pthread_seqlock_read_begin_np (&lock);
+      *              copy = data;
+      *            }
+      *          while (pthread_seqlock_read_retry_np (&lock, seq));
+      *
+      *      The lock is not validated.
+      *
+      * RESULTS
+      *              The current (even) sequence.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_seqlock_t sl = *lock;
+  LONG seq;
+
+  while ((seq = *(PTW32_INTERLOCKED_VOLATILE LONG *) &sl->seq) & 1)
+    {
+      PTW32_SPIN_PAUSE ();
+    }
+
+  PTW32_READ_BARRIER ();
+
+  return (unsigned int) seq;
+}
+
+int
+pthread_seqlock_read_retry_np (pthread_seqlock_t * lock, unsigned int seq)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Ends an optimistic read.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an initialised pthread_seqlock_t
+      *
+      *      seq
+      *              the value returned by the matching
+      *              pthread_seqlock_read_begin_np
+      *
+      * RESULTS
+      *              0               the data read is consistent,
+      *              non-zero        a writer intervened: read again.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_seqlock_t sl = *lock;
+
+  PTW32_READ_BARRIER ();
+
+  return (unsigned int) *(PTW32_INTERLOCKED_VOLATILE LONG *) &sl->seq != seq;
+}
@@ -114,6 +114,7 @@ pthread_setcancelstate (int state, int *oldstate)
    */
   if (state == PTHREAD_CANCEL_ENABLE
       && sp->cancelType == PTHREAD_CANCEL_ASYNCHRONOUS
+      && sp->cancelEvent != NULL
       && WaitForSingleObject (sp->cancelEvent, 0) == WAIT_OBJECT_0)
     {
       sp->state = PThreadStateCanceling;
@@ -115,6 +115,7 @@ pthread_setcanceltype (int type, int *oldtype)
    */
   if (sp->cancelState == PTHREAD_CANCEL_ENABLE
       && type == PTHREAD_CANCEL_ASYNCHRONOUS
+      && sp->cancelEvent != NULL
       && WaitForSingleObject (sp->cancelEvent, 0) == WAIT_OBJECT_0)
     {
       sp->state = PThreadStateCanceling;
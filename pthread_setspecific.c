@@ -45,6 +45,83 @@
 #include "implement.h"
 
 
+/*
+ * Store 'value' for index key 'key' in thread 'sp', growing its
+ * 'tsd' array if need be, and create the thread's association with
+ * the key the first time it stores a value for a key with a
+ * destructor. Only the thread itself calls this.
+ */
+static int
+ptw32_tsd_set (ptw32_thread_t * sp, pthread_key_t key, const void *value)
+{
+  ptw32_tsd_t * slot;
+
+  if (key->index >= sp->tsdSize)
+    {
+      ptw32_mcs_local_node_t threadLock;
+      LONG newSize;
+      ptw32_tsd_t * newTsd;
+
+      if (value == NULL)
+        {
+          /* Already reads as NULL */
+          return 0;
+        }
+
+      newSize = PTW32_MAX (key->index + 1, sp->tsdSize * 2);
+      newSize = PTW32_MAX (newSize, 8);
+
+      /*
+       * pthread_key_delete may be clearing an association in the
+       * array from another thread.
+       */
+      ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
+      if ((newTsd = (ptw32_tsd_t *) realloc (sp->tsd, newSize * sizeof (*newTsd))) != NULL)
+        {
+          memset (newTsd + sp->tsdSize, 0, (newSize - sp->tsdSize) * sizeof (*newTsd));
+          sp->tsd = newTsd;
+          sp->tsdSize = newSize;
+        }
+      ptw32_mcs_lock_release(&threadLock);
+
+      if (newTsd == NULL)
+        {
+          return EAGAIN;
+        }
+    }
+
+  slot = &sp->tsd[key->index];
+
+  /*
+   * Only require associations if we have to call the user's
+   * destroy routine. The slot's 'assoc' is cleared whenever the
+   * association is destroyed, including when a previous key with
+   * this index was deleted, so it is only set if it is ours.
+   */
+  if (slot->assoc == NULL && key->destructor != NULL && value != NULL)
+    {
+      ptw32_mcs_local_node_t keyLock;
+      ptw32_mcs_local_node_t threadLock;
+      int result;
+
+      ptw32_mcs_lock_acquire(&(key->keyLock), &keyLock);
+      ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
+      result = ptw32_tkAssocCreate (sp, key);
+      ptw32_mcs_lock_release(&threadLock);
+      ptw32_mcs_lock_release(&keyLock);
+
+      if (result != 0)
+        {
+          return result;
+        }
+    }
+
+  slot->value = (void *) value;
+  slot->gen = key->gen;
+
+  return 0;
+}
+
 int
 pthread_setspecific (pthread_key_t key, const void *value)
      /*
@@ -114,59 +191,17 @@ pthread_setspecific (pthread_key_t key, const void *value)
 
   if (key != NULL)
     {
-      if (self.p != NULL && key->destructor != NULL && value != NULL)
+      if (key->index >= 0)
 	{
-          ptw32_mcs_local_node_t keyLock;
-          ptw32_mcs_local_node_t threadLock;
-	  ptw32_thread_t * sp = (ptw32_thread_t *) self.p;
-	  /*
-	   * Only require associations if we have to
-	   * call user destroy routine.
-	   * Don't need to locate an existing association
-	   * when setting data to NULL for WIN32 since the
-	   * data is stored with the operating system; not
-	   * on the association; setting assoc to NULL short
-	   * circuits the search.
-	   */
-	  ThreadKeyAssoc *assoc;
-
-	  ptw32_mcs_lock_acquire(&(key->keyLock), &keyLock);
-	  ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
-
-	  assoc = (ThreadKeyAssoc *) sp->keys;
-	  /*
-	   * Locate existing association
-	   */
-	  while (assoc != NULL)
-	    {
-	      if (assoc->key == key)
-		{
-		  /*
-		   * Association already exists
-		   */
-		  break;
-		}
-		assoc = assoc->nextKey;
-	    }
-
-	  /*
-	   * create an association if not found
-	   */
-	  if (assoc == NULL)
-	    {
-	      result = ptw32_tkAssocCreate (sp, key);
-	    }
-
-	  ptw32_mcs_lock_release(&threadLock);
-	  ptw32_mcs_lock_release(&keyLock);
+	  result = ptw32_tsd_set ((ptw32_thread_t *) self.p, key, value);
 	}
-
-      if (result == 0)
+      else if (!TlsSetValue (key->key, (LPVOID) value))
 	{
-	  if (!TlsSetValue (key->key, (LPVOID) value))
-	    {
-	      result = EAGAIN;
-	    }
+	  result = EAGAIN;
+	}
+      else
+	{
+	  PTW32_SELF_CACHE_SET((ptw32_thread_t *) value);
 	}
     }
 
@@ -56,12 +56,28 @@ pthread_spin_destroy (pthread_spinlock_t * lock)
       return EINVAL;
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(*lock))
+    {
+      return pthread_mutex_destroy ((pthread_mutex_t *) lock);
+    }
+
   if ((s = *lock) != PTHREAD_SPINLOCK_INITIALIZER)
     {
       if (s->interlock == PTW32_SPIN_USE_MUTEX)
 	{
 	  result = pthread_mutex_destroy (&(s->u.mutex));
 	}
+      else if (s->interlock == PTW32_SPIN_TICKET)
+	{
+	  if (s->owner != s->next
+	      || (PTW32_INTERLOCKED_LONG) PTW32_SPIN_TICKET !=
+	         PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
+						         (PTW32_INTERLOCKED_LONG) PTW32_SPIN_INVALID,
+						         (PTW32_INTERLOCKED_LONG) PTW32_SPIN_TICKET))
+	    {
+	      result = EINVAL;
+	    }
+	}
       else if ((PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED !=
 	       PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
 						   (PTW32_INTERLOCKED_LONG) PTW32_SPIN_INVALID,
@@ -77,7 +93,7 @@ pthread_spin_destroy (pthread_spinlock_t * lock)
 	   * have finished with the spinlock before destroying it.
 	   */
 	  *lock = NULL;
-	  (void) free (s);
+	  ptw32_slab_free (s, sizeof (*s));
 	}
     }
   else
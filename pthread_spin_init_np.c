@@ -0,0 +1,160 @@
+/*
+ * pthread_spin_init_np.c
+ *
+ * Description:
+ * This translation unit implements spin lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_spin_init_np (pthread_spinlock_t * lock, int pshared, int kind)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a spinlock of the given kind.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_spinlock_t
+      *
+      *      pshared
+      *              PTHREAD_PROCESS_PRIVATE or PTHREAD_PROCESS_SHARED
+      *
+      *      kind
+      *              PTHREAD_SPINLOCK_DEFAULT_NP
+      *                      (test-and-test-and-set with backoff)
+      *              PTHREAD_SPINLOCK_FAIR_NP
+      *                      (ticket lock: acquired in FIFO order)
+      *
+      * DESCRIPTION
+      *      On a single cpu both kinds are implemented with a mutex
+      *      since spinning can't make progress there. A process-shared
+      *      spin lock of either kind is a process-shared mutex (see
+      *      ptw32_pshared.c), since the lock itself is too small to
+      *      hold shared state.
+      *
+      * RESULTS
+      *              0               successfully initialised,
+      *              EINVAL          'lock' or 'kind' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_spinlock_t s;
+  int cpus = 0;
+  int result = 0;
+
+  if (lock == NULL
+      || (kind != PTHREAD_SPINLOCK_DEFAULT_NP
+          && kind != PTHREAD_SPINLOCK_FAIR_NP))
+    {
+      return EINVAL;
+    }
+
+  if (0 != ptw32_getprocessors (&cpus))
+    {
+      cpus = 1;
+    }
+
+  if (pshared == PTHREAD_PROCESS_SHARED)
+    {
+      pthread_mutexattr_t ma;
+      pthread_mutex_t mx;
+
+      if ((result = pthread_mutexattr_init (&ma)) == 0)
+	{
+	  ma->pshared = pshared;
+	  if ((result = pthread_mutex_init (&mx, &ma)) == 0)
+	    {
+	      /* The encoded id, which the spin lock routines recognise. */
+	      *lock = (pthread_spinlock_t) mx;
+	    }
+	  (void) pthread_mutexattr_destroy (&ma);
+	}
+
+      return result;
+    }
+
+  s = (pthread_spinlock_t) ptw32_slab_calloc (sizeof (*s));
+
+  if (s == NULL)
+    {
+      return ENOMEM;
+    }
+
+  if (cpus > 1)
+    {
+      s->u.cpus = cpus;
+      s->interlock = (kind == PTHREAD_SPINLOCK_FAIR_NP
+                      ? PTW32_SPIN_TICKET
+                      : PTW32_SPIN_UNLOCKED);
+    }
+  else
+    {
+      pthread_mutexattr_t ma;
+      result = pthread_mutexattr_init (&ma);
+
+      if (0 == result)
+	{
+	  ma->pshared = pshared;
+	  result = pthread_mutex_init (&(s->u.mutex), &ma);
+	  if (0 == result)
+	    {
+	      s->interlock = PTW32_SPIN_USE_MUTEX;
+	    }
+	}
+      (void) pthread_mutexattr_destroy (&ma);
+    }
+
+  if (0 == result)
+    {
+      *lock = s;
+    }
+  else
+    {
+      ptw32_slab_free (s, sizeof (*s));
+      *lock = NULL;
+    }
+
+  return (result);
+}
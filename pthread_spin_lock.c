@@ -45,16 +45,76 @@
 #include "implement.h"
 
 
+/*
+ * Pause for 'n' iterations, yielding the time slice instead once
+ * '*spins' passes PTW32_SPIN_YIELD_LIMIT in case the holder has been
+ * preempted and is waiting for this cpu.
+ */
+static INLINE void
+ptw32_spin_backoff (int n, int * spins)
+{
+  if ((*spins += n) < PTW32_SPIN_YIELD_LIMIT)
+    {
+      while (n-- > 0)
+	{
+	  PTW32_SPIN_PAUSE ();
+	}
+    }
+  else
+    {
+      *spins = 0;
+      Sleep (0);
+    }
+}
+
+static int
+ptw32_spin_lock_ticket (pthread_spinlock_t s)
+{
+  LONG ticket;
+  LONG ahead;
+  int spins = 0;
+
+  ticket = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->next,
+                                                       (PTW32_INTERLOCKED_LONG) 1);
+
+  /*
+   * Only read "owner" while waiting. Each waiter knows how many
+   * holders are ahead of it and backs off in proportion, so that
+   * the line is mostly quiet until its turn is near.
+   */
+  while ((ahead = ticket - *(PTW32_INTERLOCKED_VOLATILE LONG *) &s->owner) != 0)
+    {
+      ptw32_spin_backoff (PTW32_MIN (PTW32_SPIN_BACKOFF_MAX,
+                                     ahead * PTW32_SPIN_BACKOFF_PER_CPU),
+                          &spins);
+    }
+
+  /*
+   * The critical section must not be read ahead of seeing our turn.
+   */
+  PTW32_READ_BARRIER ();
+
+  return 0;
+}
+
 int
 pthread_spin_lock (pthread_spinlock_t * lock)
 {
   pthread_spinlock_t s;
+  int backoff;
+  int cap;
+  int spins = 0;
 
   if (NULL == lock || NULL == *lock)
     {
       return (EINVAL);
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(*lock))
+    {
+      return pthread_mutex_lock ((pthread_mutex_t *) lock);
+    }
+
   if (*lock == PTHREAD_SPINLOCK_INITIALIZER)
     {
       int result;
@@ -67,21 +127,61 @@ pthread_spin_lock (pthread_spinlock_t * lock)
 
   s = *lock;
 
-  while ((PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED ==
-	 PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
-					          (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
-					          (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED))
-    {
-    }
-
-  if (s->interlock == PTW32_SPIN_LOCKED)
+  /*
+   * Uncontended fast path.
+   */
+  switch ((long)
+	  PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
+					           (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
+					           (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED))
     {
+    case PTW32_SPIN_UNLOCKED:
       return 0;
-    }
-  else if (s->interlock == PTW32_SPIN_USE_MUTEX)
-    {
+    case PTW32_SPIN_LOCKED:
+      break;
+    case PTW32_SPIN_USE_MUTEX:
       return pthread_mutex_lock (&(s->u.mutex));
+    case PTW32_SPIN_TICKET:
+      return ptw32_spin_lock_ticket (s);
+    default:
+      return EINVAL;
     }
 
-  return EINVAL;
+  /*
+   * Test-and-test-and-set: spin reading the lock so that waiters
+   * share the cache line, and only attempt the interlocked write
+   * once it looks free. A thread that loses that race backs off
+   * exponentially, up to a limit proportional to the number of
+   * cpus that could be contending.
+   */
+  backoff = 1;
+  cap = PTW32_MIN (PTW32_SPIN_BACKOFF_MAX, PTW32_SPIN_BACKOFF_PER_CPU * s->u.cpus);
+
+  for (;;)
+    {
+      while (*(PTW32_INTERLOCKED_VOLATILE long *) &s->interlock == PTW32_SPIN_LOCKED)
+	{
+	  ptw32_spin_backoff (1, &spins);
+	}
+
+      switch ((long)
+	      PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
+					               (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
+					               (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED))
+	{
+	case PTW32_SPIN_UNLOCKED:
+	  return 0;
+	case PTW32_SPIN_LOCKED:
+	  break;
+	default:
+	  return EINVAL;
+	}
+
+      ptw32_spin_backoff (backoff, &spins);
+
+      if (backoff < cap)
+	{
+	  backoff <<= 1;
+	}
+    }
 }
@@ -55,6 +55,11 @@ pthread_spin_trylock (pthread_spinlock_t * lock)
       return (EINVAL);
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(*lock))
+    {
+      return pthread_mutex_trylock ((pthread_mutex_t *) lock);
+    }
+
   if (*lock == PTHREAD_SPINLOCK_INITIALIZER)
     {
       int result;
@@ -78,6 +83,19 @@ pthread_spin_trylock (pthread_spinlock_t * lock)
       return EBUSY;
     case PTW32_SPIN_USE_MUTEX:
       return pthread_mutex_trylock (&(s->u.mutex));
+    case PTW32_SPIN_TICKET:
+      {
+        /*
+         * Only take a ticket if it would be served immediately.
+         */
+        LONG owner = *(PTW32_INTERLOCKED_VOLATILE LONG *) &s->owner;
+
+        return ((PTW32_INTERLOCKED_LONG) owner ==
+                PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->next,
+                                                         (PTW32_INTERLOCKED_LONG) (owner + 1),
+                                                         (PTW32_INTERLOCKED_LONG) owner)
+                ? 0 : EBUSY);
+      }
     }
 
   return EINVAL;
@@ -55,6 +55,11 @@ pthread_spin_unlock (pthread_spinlock_t * lock)
       return (EINVAL);
     }
 
+  if (PTW32_PSHARED_IS_HANDLE(*lock))
+    {
+      return pthread_mutex_unlock ((pthread_mutex_t *) lock);
+    }
+
   s = *lock;
 
   if (s == PTHREAD_SPINLOCK_INITIALIZER)
@@ -72,6 +77,17 @@ pthread_spin_unlock (pthread_spinlock_t * lock)
       return 0;
     case PTW32_SPIN_USE_MUTEX:
       return pthread_mutex_unlock (&(s->u.mutex));
+    case PTW32_SPIN_TICKET:
+      if (s->owner == s->next)
+	{
+	  return EPERM;
+	}
+      /*
+       * Serve the next ticket. Only the holder writes "owner".
+       */
+      (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->owner,
+                                                  (PTW32_INTERLOCKED_LONG) 1);
+      return 0;
     }
 
   return EINVAL;
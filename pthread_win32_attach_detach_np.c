@@ -158,6 +158,65 @@ pthread_win32_process_attach_np ()
       ptw32_features |= PTW32_ALERTABLE_ASYNC_CANCEL;
     }
 
+#if !defined(PTW32_MUTEX_NO_WAIT_ON_ADDRESS) && !defined(WINCE) && !defined(ENABLE_WINRT)
+  /*
+   * Try to get the addresses of WaitOnAddress and WakeByAddressSingle
+   * (Windows 8 or later). If both exist then mutexes wait on their
+   * lock word instead of a per-mutex event. See ptw32_mutex_wait.c.
+   *
+   * The API set resolves to a system DLL that stays mapped for the
+   * life of the process. The handle is intentionally never freed
+   * because mutexes without an event may be used until process exit.
+   */
+  if (ptw32_wait_on_address == NULL)
+    {
+      HINSTANCE h_synch = LoadLibrary(_T("api-ms-win-core-synch-l1-2-0.dll"));
+
+      if (h_synch != NULL)
+        {
+          BOOL (WINAPI *wait_on_address) (volatile VOID *, PVOID, SIZE_T, DWORD);
+          VOID (WINAPI *wake_by_address_single) (PVOID);
+
+          wait_on_address = (BOOL (WINAPI *)(volatile VOID *, PVOID, SIZE_T, DWORD))
+            GetProcAddress (h_synch, (LPCSTR) "WaitOnAddress");
+          wake_by_address_single = (VOID (WINAPI *)(PVOID))
+            GetProcAddress (h_synch, (LPCSTR) "WakeByAddressSingle");
+
+          if (wait_on_address != NULL && wake_by_address_single != NULL)
+            {
+              ptw32_wake_by_address_single = wake_by_address_single;
+              ptw32_wait_on_address = wait_on_address;
+            }
+          else
+            {
+              (void) FreeLibrary (h_synch);
+            }
+        }
+    }
+#endif
+
+  if (ptw32_wait_on_address != NULL)
+    {
+      ptw32_features |= PTW32_WAIT_ON_ADDRESS;
+    }
+
+#if !defined(WINCE) && !defined(ENABLE_WINRT)
+  /*
+   * kernel32 is always loaded, so its handle needs no reference.
+   */
+  {
+    HMODULE h_kernel32 = GetModuleHandle (_T("kernel32.dll"));
+
+    if (h_kernel32 != NULL)
+      {
+        ptw32_get_current_processor_number = (DWORD (WINAPI *)(void))
+          GetProcAddress (h_kernel32, (LPCSTR) "GetCurrentProcessorNumber");
+        ptw32_get_logical_processor_information = (BOOL (WINAPI *)(PVOID, PDWORD))
+          GetProcAddress (h_kernel32, (LPCSTR) "GetLogicalProcessorInformation");
+      }
+  }
+#endif
+
   return result;
 }
 
@@ -181,6 +240,7 @@ pthread_win32_process_detach_np ()
 	      if (ptw32_selfThreadKey)
 	        {
 	    	  TlsSetValue (ptw32_selfThreadKey->key, NULL);
+	    	  PTW32_SELF_CACHE_SET(NULL);
 	        }
 	    }
 	}
@@ -259,7 +319,7 @@ pthread_win32_thread_detach_np ()
                * sleep, wake up immediately and then go back to sleep.
                * See pthread_mutex_lock.c.
                */
-              SetEvent(mx->event);
+              (void) ptw32_mutex_wake (mx);
             }
 
 
@@ -270,11 +330,29 @@ pthread_win32_thread_detach_np ()
 	      if (ptw32_selfThreadKey)
 	        {
 	    	  TlsSetValue (ptw32_selfThreadKey->key, NULL);
+	    	  PTW32_SELF_CACHE_SET(NULL);
 	        }
 	    }
 	}
     }
 
+#if defined(PTW32_SELF_TLS)
+  /*
+   * Release this thread's MCS lock park event, if it ever needed one.
+   */
+  if (ptw32_mcsParkEvent != NULL)
+    {
+      (void) CloseHandle (ptw32_mcsParkEvent);
+      ptw32_mcsParkEvent = NULL;
+    }
+#endif
+
+  /*
+   * Hand back this thread's cached slab objects. Done last, after
+   * the key destructors and ptw32_threadDestroy have freed theirs.
+   */
+  ptw32_slab_flush ();
+
   return TRUE;
 }
 
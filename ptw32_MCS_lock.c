@@ -133,32 +133,72 @@ ptw32_mcs_flag_set (HANDLE * flag)
 /*
  * ptw32_mcs_flag_wait -- wait for notification from another.
  *
- * Store an event handle in the flag and wait on it if the flag has not been
- * set, and proceed without creating an event otherwise.
+ * Poll the flag briefly, then store an event handle in the flag and wait
+ * on it if the flag has still not been set.
+ *
+ * Where compiler TLS is available each thread parks on its own cached
+ * auto-reset event instead of creating and closing one per wait. This is
+ * safe because a thread waits on at most one flag at a time, and an event
+ * that was stored in a flag is signalled exactly once (by the single
+ * ptw32_mcs_flag_set on that flag) and that signal is always consumed
+ * here before we return, so the event is unsignalled when reused.
  */
 INLINE void
 ptw32_mcs_flag_wait (HANDLE * flag)
 {
-  if ((PTW32_INTERLOCKED_SIZE)0 ==
+  int spins;
+  HANDLE e;
+
+  for (spins = 0; spins < PTW32_MCS_SPIN_COUNT; spins++)
+    {
+      if (0 != *(PTW32_INTERLOCKED_VOLATILE HANDLE *) flag)
+        {
+          return;
+        }
+      PTW32_SPIN_PAUSE ();
+    }
+
+  if ((PTW32_INTERLOCKED_SIZE)0 !=
         PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE((PTW32_INTERLOCKED_SIZEPTR)flag,
                                             (PTW32_INTERLOCKED_SIZE)0)) /* MBR fence */
     {
-      /* the flag is not set. create event. */
+      return;
+    }
 
-      HANDLE e = CreateEvent(NULL, PTW32_FALSE, PTW32_FALSE, NULL);
-      if (e)
-      {
-          if ((PTW32_INTERLOCKED_SIZE)0 == PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE(
-              (PTW32_INTERLOCKED_SIZEPTR)flag,
-              (PTW32_INTERLOCKED_SIZE)e,
-              (PTW32_INTERLOCKED_SIZE)0))
-          {
-              /* stored handle in the flag. wait on it now. */
-              WaitForSingleObject(e, INFINITE);
-          }
+  /* the flag is not set. get an event to park on. */
+#if defined(PTW32_SELF_TLS)
+  if ((e = ptw32_mcsParkEvent) == NULL)
+    {
+      e = ptw32_mcsParkEvent = CreateEvent(NULL, PTW32_FALSE, PTW32_FALSE, NULL);
+    }
+#else
+  e = CreateEvent(NULL, PTW32_FALSE, PTW32_FALSE, NULL);
+#endif
 
-          CloseHandle(e);
-      }
+  if (e)
+    {
+      if ((PTW32_INTERLOCKED_SIZE)0 == PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE(
+          (PTW32_INTERLOCKED_SIZEPTR)flag,
+          (PTW32_INTERLOCKED_SIZE)e,
+          (PTW32_INTERLOCKED_SIZE)0))
+        {
+          /* stored handle in the flag. wait on it now. */
+          WaitForSingleObject(e, INFINITE);
+        }
+
+#if !defined(PTW32_SELF_TLS)
+      CloseHandle(e);
+#endif
+    }
+  else
+    {
+      /* No event available. Fall back to yielding until the flag is set. */
+      while ((PTW32_INTERLOCKED_SIZE)0 ==
+               PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE((PTW32_INTERLOCKED_SIZEPTR)flag,
+                                                   (PTW32_INTERLOCKED_SIZE)0))
+        {
+          Sleep(0);
+        }
     }
 }
 
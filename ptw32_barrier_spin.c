@@ -0,0 +1,243 @@
+/*
+ * ptw32_barrier_spin.c
+ *
+ * Description:
+ * Spin-then-block barrier kind.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Barriers of kind PTHREAD_BARRIER_SPIN_NP, and PTHREAD_BARRIER_TREE_NP,
+ * which only differs in how threads arrive (see ptw32_barrier_tree.c).
+ *
+ * A sense-reversing barrier: each thread arrives with one interlocked
+ * decrement of 'remaining'. The thread that takes it to zero re-arms it
+ * and flips 'sense', which the others watch. A thread reads 'sense' on
+ * arrival; it can't change until that thread has arrived, so the value
+ * the thread is waiting for is simply the opposite one, and waiters need
+ * no per-thread state.
+ *
+ * Waiters spin for a budget that adapts as for PTHREAD_MUTEX_ADAPTIVE_NP
+ * mutexes: twice the running estimate of spins needed plus a small
+ * constant, capped at PTW32_BARRIER_SPIN_MAX. Only the first thread to
+ * arrive, which waits longest, updates the estimate, so the waiters
+ * write nothing shared while they spin. There is no spinning at all if
+ * the barrier has more threads than the process has CPUs.
+ *
+ * A waiter that runs out of budget counts itself in nSleepers[sense],
+ * checks 'sense' again and sleeps on the manual-reset event[sense]. The
+ * releaser sets the event only if it then finds a sleeper. Both sides
+ * write one location and then read the other with interlocked operations
+ * in between, so either the releaser sees the sleeper or the sleeper
+ * sees the flip. The event is reset for reuse by the releaser of the
+ * following phase, by which time every thread has left this one.
+ *
+ * nLeaving counts the released threads that may still be looking at the
+ * barrier, so that pthread_barrier_destroy can wait for them.
+ */
+
+int
+ptw32_barrier_spin_init (pthread_barrier_t b)
+{
+  int cpus;
+
+  b->remaining = (LONG) b->nInitialBarrierHeight;
+  b->sense = 0;
+  b->nLeaving = 0;
+  b->nSleepers[0] = b->nSleepers[1] = 0;
+
+  if (ptw32_getprocessors (&cpus) != 0)
+    {
+      cpus = 1;
+    }
+
+  b->spinMax = ((unsigned int) cpus >= b->nInitialBarrierHeight
+                ? PTW32_BARRIER_SPIN_MAX : 0);
+  b->spinCount = b->spinMax / 2;
+
+  b->event[0] = CreateEvent (NULL, PTW32_TRUE, PTW32_FALSE, NULL);
+  b->event[1] = CreateEvent (NULL, PTW32_TRUE, PTW32_FALSE, NULL);
+
+  if (b->event[0] == NULL || b->event[1] == NULL
+      || (b->kind == PTHREAD_BARRIER_TREE_NP
+          && ptw32_barrier_tree_init (b) != 0))
+    {
+      if (b->event[0] != NULL)
+        {
+          (void) CloseHandle (b->event[0]);
+        }
+      if (b->event[1] != NULL)
+        {
+          (void) CloseHandle (b->event[1]);
+        }
+      return EAGAIN;
+    }
+
+  return 0;
+}
+
+int
+ptw32_barrier_spin_destroy (pthread_barrier_t b)
+{
+  if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &b->remaining
+      != (LONG) b->nInitialBarrierHeight)
+    {
+      return EBUSY;
+    }
+
+  if (b->nodes != NULL)
+    {
+      int i;
+
+      for (i = 0; i < b->nLeaves; i++)
+        {
+          if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &b->nodes[i].count != 0)
+            {
+              return EBUSY;
+            }
+        }
+    }
+
+  /*
+   * The last phase is complete. Wait for its threads to return.
+   */
+  while (*(PTW32_INTERLOCKED_VOLATILE LONG *) &b->nLeaving != 0)
+    {
+      Sleep (0);
+    }
+
+  (void) CloseHandle (b->event[0]);
+  (void) CloseHandle (b->event[1]);
+
+  if (b->nodes != NULL)
+    {
+      ptw32_barrier_tree_destroy (b);
+    }
+
+  return 0;
+}
+
+int
+ptw32_barrier_spin_wait (pthread_barrier_t b)
+{
+  LONG n = (LONG) b->nInitialBarrierHeight;
+  LONG mySense = 1 - *(PTW32_INTERLOCKED_VOLATILE LONG *) &b->sense;
+  int last;
+  int first;
+  int spins;
+  int maxSpins;
+
+  if (b->nodes != NULL)
+    {
+      last = ptw32_barrier_tree_arrive (b, &first);
+    }
+  else
+    {
+      LONG left = (LONG) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &b->remaining);
+
+      last = (left == 0);
+      first = (left == n - 1);
+    }
+
+  if (last)
+    {
+      /*
+       * Last to arrive. Nobody can be waiting on the other sense's
+       * event any more: re-arm it and the counters before opening.
+       */
+      if (b->nodes != NULL)
+        {
+          ptw32_barrier_tree_rearm (b);
+        }
+      if (b->nSleepers[1 - mySense] != 0)
+        {
+          b->nSleepers[1 - mySense] = 0;
+          (void) ResetEvent (b->event[1 - mySense]);
+        }
+      b->nLeaving = n - 1;
+      b->remaining = n;
+
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &b->sense,
+                                              (PTW32_INTERLOCKED_LONG) mySense);
+
+      if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &b->nSleepers[mySense] != 0)
+        {
+          (void) SetEvent (b->event[mySense]);
+        }
+
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  maxSpins = (b->spinMax == 0 ? 0
+              : PTW32_MIN (b->spinMax, b->spinCount * 2 + 10));
+
+  for (spins = 0; spins < maxSpins; spins++)
+    {
+      if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &b->sense == mySense)
+        {
+          break;
+        }
+      PTW32_SPIN_PAUSE ();
+    }
+
+  if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &b->sense != mySense)
+    {
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &b->nSleepers[mySense]);
+
+      while (*(PTW32_INTERLOCKED_VOLATILE LONG *) &b->sense != mySense)
+        {
+          (void) WaitForSingleObject (b->event[mySense], INFINITE);
+        }
+    }
+
+  if (first && b->spinMax != 0)
+    {
+      /*
+       * Exponential moving average with weight 1/8, as for adaptive
+       * mutexes. Only one thread per phase writes it.
+       */
+      b->spinCount += (spins - b->spinCount) / 8;
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &b->nLeaving);
+
+  return 0;
+}
@@ -0,0 +1,344 @@
+/*
+ * ptw32_barrier_tree.c
+ *
+ * Description:
+ * Combining-tree barrier kind.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Barriers of kind PTHREAD_BARRIER_TREE_NP.
+ *
+ * These work as PTHREAD_BARRIER_SPIN_NP barriers (see ptw32_barrier_spin.c)
+ * except for how threads arrive. Instead of one counter that every thread
+ * decrements, a combining tree of counters, each in its own cache line,
+ * takes up to PTW32_BARRIER_TREE_FANIN arrivals per node. The thread that
+ * completes a node goes on to its parent, and the one that completes the
+ * root opens the barrier.
+ *
+ * The threads of a barrier are not known in advance, so they are not
+ * assigned to leaves. A thread starts at the leaf that belongs to the CPU
+ * it is running on and takes a place there if there is one, else tries
+ * the next leaf. The leaves' places add up to the barrier's count, so
+ * every thread finds one. Leaves are filled by compare-exchange and
+ * emptied by the thread that opens the barrier; inner nodes, which always
+ * complete, are emptied by the thread that completes them.
+ *
+ * CPUs are given to leaves in topology order - NUMA node, then shared
+ * last level cache, then shared L2 cache - so that threads on CPUs close
+ * to each other share leaves and subtrees, and most arrival traffic stays
+ * within one cache or NUMA domain. Only the process's affinity mask is
+ * considered, and only the first processor group. Without
+ * GetLogicalProcessorInformation the CPUs stay in number order; without
+ * GetCurrentProcessorNumber threads are spread over the leaves by id.
+ */
+
+static int
+ptw32_barrier_tree_cpu_order (int * order)
+     /*
+      * Fills 'order' with the process's CPUs in topology order
+      * and returns how many there are.
+      */
+{
+  DWORD_PTR processCPUs = 1;
+  DWORD_PTR systemCPUs;
+  DWORD numa[PTW32_BARRIER_MAX_CPUS];
+  DWORD llc[PTW32_BARRIER_MAX_CPUS];
+  DWORD l2[PTW32_BARRIER_MAX_CPUS];
+  int nCPUs = 0;
+  int cpu;
+  int i, j;
+
+#if !defined(NEED_PROCESS_AFFINITY_MASK)
+  if (!GetProcessAffinityMask (GetCurrentProcess (), &processCPUs, &systemCPUs))
+    {
+      processCPUs = 1;
+    }
+#endif
+
+  for (cpu = 0; cpu < PTW32_BARRIER_MAX_CPUS; cpu++)
+    {
+      numa[cpu] = 0;
+      llc[cpu] = 0;
+      l2[cpu] = (DWORD) cpu;
+    }
+
+#if !defined(WINCE) && !defined(ENABLE_WINRT)
+  if (ptw32_get_logical_processor_information != NULL)
+    {
+      SYSTEM_LOGICAL_PROCESSOR_INFORMATION * info = NULL;
+      DWORD size = 0;
+
+      if (!ptw32_get_logical_processor_information (NULL, &size)
+          && GetLastError () == ERROR_INSUFFICIENT_BUFFER
+          && (info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION *) malloc (size)) != NULL
+          && ptw32_get_logical_processor_information (info, &size))
+        {
+          DWORD n = size / sizeof (*info);
+          DWORD k;
+
+          for (k = 0; k < n; k++)
+            {
+              ULONG_PTR mask = info[k].ProcessorMask;
+              DWORD first = 0;
+
+              while (first < PTW32_BARRIER_MAX_CPUS - 1
+                     && !(mask & ((ULONG_PTR) 1 << first)))
+                {
+                  first++;
+                }
+
+              for (cpu = 0; cpu < PTW32_BARRIER_MAX_CPUS
+                            && cpu < (int) (8 * sizeof (mask)); cpu++)
+                {
+                  if (!(mask & ((ULONG_PTR) 1 << cpu)))
+                    {
+                      continue;
+                    }
+                  if (info[k].Relationship == RelationNumaNode)
+                    {
+                      numa[cpu] = info[k].NumaNode.NodeNumber;
+                    }
+                  else if (info[k].Relationship == RelationCache)
+                    {
+                      /* A cache is named after its first CPU. */
+                      if (info[k].Cache.Level == 3)
+                        {
+                          llc[cpu] = first;
+                        }
+                      else if (info[k].Cache.Level == 2)
+                        {
+                          l2[cpu] = first;
+                        }
+                    }
+                }
+            }
+        }
+
+      free (info);
+    }
+#endif
+
+  for (cpu = 0; cpu < PTW32_BARRIER_MAX_CPUS
+                && cpu < (int) (8 * sizeof (processCPUs)); cpu++)
+    {
+      if (!(processCPUs & ((DWORD_PTR) 1 << cpu)))
+        {
+          continue;
+        }
+
+      /*
+       * Insertion sort by (numa, llc, l2, cpu): at most 64 entries.
+       */
+      for (i = nCPUs; i > 0; i--)
+        {
+          j = order[i - 1];
+          if (numa[j] < numa[cpu]
+              || (numa[j] == numa[cpu]
+                  && (llc[j] < llc[cpu]
+                      || (llc[j] == llc[cpu] && l2[j] <= l2[cpu]))))
+            {
+              break;
+            }
+          order[i] = j;
+        }
+      order[i] = cpu;
+      nCPUs++;
+    }
+
+  return nCPUs;
+}
+
+int
+ptw32_barrier_tree_init (pthread_barrier_t b)
+{
+  int n = (int) b->nInitialBarrierHeight;
+  int fanIn = PTW32_BARRIER_TREE_FANIN;
+  int order[PTW32_BARRIER_MAX_CPUS];
+  int nLeaves = (n + fanIn - 1) / fanIn;
+  int nNodes = nLeaves;
+  int level, next, width;
+  int nCPUs;
+  int i;
+
+  for (width = nLeaves; width > 1; )
+    {
+      width = (width + fanIn - 1) / fanIn;
+      nNodes += width;
+    }
+
+  /*
+   * One spare node's worth to align the nodes to a cache line.
+   */
+  b->nodeBlock = calloc (nNodes + 1, sizeof (ptw32_barrier_node_t));
+
+  if (b->nodeBlock == NULL)
+    {
+      return ENOMEM;
+    }
+
+  b->nodes = (ptw32_barrier_node_t *)
+               (((size_t) b->nodeBlock + sizeof (ptw32_barrier_node_t) - 1)
+                & ~(sizeof (ptw32_barrier_node_t) - 1));
+  b->nLeaves = nLeaves;
+
+  /*
+   * Share the places evenly among the leaves, then link each level
+   * to the next one up.
+   */
+  for (i = 0; i < nLeaves; i++)
+    {
+      b->nodes[i].size = n / nLeaves + (i < n % nLeaves ? 1 : 0);
+    }
+
+  for (level = 0, width = nLeaves; width > 1; level = next)
+    {
+      next = level + width;
+
+      for (i = 0; i < width; i++)
+        {
+          b->nodes[level + i].parent = &b->nodes[next + i / fanIn];
+          b->nodes[next + i / fanIn].size++;
+        }
+
+      width = (width + fanIn - 1) / fanIn;
+    }
+
+  /*
+   * Spread the CPUs over the leaves in topology order.
+   */
+  for (i = 0; i < PTW32_BARRIER_MAX_CPUS; i++)
+    {
+      b->cpuLeaf[i] = i % nLeaves;
+    }
+
+  nCPUs = ptw32_barrier_tree_cpu_order (order);
+
+  for (i = 0; i < nCPUs; i++)
+    {
+      b->cpuLeaf[order[i]] = i * nLeaves / nCPUs;
+    }
+
+  return 0;
+}
+
+void
+ptw32_barrier_tree_destroy (pthread_barrier_t b)
+{
+  free (b->nodeBlock);
+}
+
+int
+ptw32_barrier_tree_arrive (pthread_barrier_t b, int * first)
+     /*
+      * Returns PTW32_TRUE to the thread that completes the root.
+      * Sets *first for one thread per phase: the one that takes
+      * the first place of the first leaf.
+      */
+{
+  ptw32_barrier_node_t * node;
+  LONG c = 0;
+  int leaf;
+  int i;
+
+  if (ptw32_get_current_processor_number != NULL)
+    {
+      leaf = b->cpuLeaf[ptw32_get_current_processor_number () % PTW32_BARRIER_MAX_CPUS];
+    }
+  else
+    {
+      leaf = (int) (GetCurrentThreadId () % (DWORD) b->nLeaves);
+    }
+
+  for (i = 0; ; i++)
+    {
+      node = &b->nodes[(leaf + i) % b->nLeaves];
+      c = *(PTW32_INTERLOCKED_VOLATILE LONG *) &node->count;
+
+      while (c < node->size)
+        {
+          LONG seen = (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+                                (PTW32_INTERLOCKED_LONGPTR) &node->count,
+                                (PTW32_INTERLOCKED_LONG) (c + 1),
+                                (PTW32_INTERLOCKED_LONG) c);
+          if (seen == c)
+            {
+              goto PLACED;
+            }
+          c = seen;
+        }
+    }
+
+PLACED:
+
+  *first = (c == 0 && node == &b->nodes[0]);
+
+  if (c + 1 < node->size)
+    {
+      return PTW32_FALSE;
+    }
+
+  for (node = node->parent; node != NULL; node = node->parent)
+    {
+      if ((LONG) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &node->count)
+          < node->size)
+        {
+          return PTW32_FALSE;
+        }
+      node->count = 0;
+    }
+
+  return PTW32_TRUE;
+}
+
+void
+ptw32_barrier_tree_rearm (pthread_barrier_t b)
+     /*
+      * Called by the thread that opens the barrier, before it does.
+      */
+{
+  int i;
+
+  for (i = 0; i < b->nLeaves; i++)
+    {
+      b->nodes[i].count = 0;
+    }
+}
@@ -87,38 +87,35 @@ ptw32_callUserDestroyRoutines (pthread_t thread)
     {
       ptw32_mcs_local_node_t threadLock;
       ptw32_mcs_local_node_t keyLock;
-      int assocsRemaining;
+      int valuesRemaining;
       int iterations = 0;
+      LONG i;
       ptw32_thread_t * sp = (ptw32_thread_t *) thread.p;
 
       /*
-       * Run through all Thread<-->Key associations
-       * for the current thread.
+       * Run through the thread's 'tsd' array and call the destructor
+       * for each value that has one. Only this thread changes values,
+       * so slots without a value or without an association are
+       * skipped without taking any lock.
        *
-       * Do this process at most PTHREAD_DESTRUCTOR_ITERATIONS times.
+       * Destructors may set values again, so do this process at most
+       * PTHREAD_DESTRUCTOR_ITERATIONS times.
        */
       do
 	{
-	  assocsRemaining = 0;
+	  valuesRemaining = 0;
 	  iterations++;
 
-	  ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
-	  /*
-	   * The pointer to the next assoc is stored in the thread struct so that
-	   * the assoc destructor in pthread_key_delete can adjust it
-	   * if it deletes this assoc. This can happen if we fail to acquire
-	   * both locks below, and are forced to release all of our locks,
-	   * leaving open the opportunity for pthread_key_delete to get in
-	   * before us.
-	   */
-	  sp->nextAssoc = sp->keys;
-	  ptw32_mcs_lock_release(&threadLock);
-
-	  for (;;)
+	  /* A destructor may grow 'tsd', so reload it for each slot */
+	  for (i = 0; i < sp->tsdSize; i++)
 	    {
 	      void * value;
-	      pthread_key_t k;
-	      void (*destructor) (void *);
+	      void (PTW32_CDECL *destructor) (void *);
+
+	      if (sp->tsd[i].value == NULL || sp->tsd[i].assoc == NULL)
+		{
+		  continue;
+		}
 
 	      /*
 	       * First we need to serialise with pthread_key_delete by locking
@@ -127,113 +124,121 @@ ptw32_callUserDestroyRoutines (pthread_t thread)
 	       */
 	      ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
 
-	      if ((assoc = (ThreadKeyAssoc *)sp->nextAssoc) == NULL)
+	      if ((assoc = (ThreadKeyAssoc *) sp->tsd[i].assoc) == NULL)
 		{
-		  /* Finished */
+		  /* The key was deleted in the meantime */
 		  ptw32_mcs_lock_release(&threadLock);
-		  break;
+		  continue;
 		}
-	      else
+
+	      /*
+	       * assoc->key must be valid because the assoc can't be removed
+	       * while we hold at least one lock. Now try to acquire the
+	       * second lock without deadlocking. If we fail, we need to
+	       * relinquish the first lock and the processor and then try
+	       * this slot again.
+	       */
+	      if (ptw32_mcs_lock_try_acquire(&(assoc->key->keyLock), &keyLock) == EBUSY)
 		{
-		  /*
-		   * assoc->key must be valid because assoc can't change or be
-		   * removed from our chain while we hold at least one lock. If
-		   * the assoc was on our key chain then the key has not been
-		   * deleted yet.
-		   *
-		   * Now try to acquire the second lock without deadlocking.
-		   * If we fail, we need to relinquish the first lock and the
-		   * processor and then try to acquire them all again.
-		   */
-		  if (ptw32_mcs_lock_try_acquire(&(assoc->key->keyLock), &keyLock) == EBUSY)
-		    {
-		      ptw32_mcs_lock_release(&threadLock);
-		      Sleep(0);
-		      /*
-		       * Go around again.
-		       * If pthread_key_delete has removed this assoc in the meantime,
-		       * sp->nextAssoc will point to a new assoc.
-		       */
-		      continue;
-		    }
+		  ptw32_mcs_lock_release(&threadLock);
+		  Sleep(0);
+		  i--;
+		  continue;
 		}
 
-	      /* We now hold both locks */
-
-	      sp->nextAssoc = assoc->nextKey;
-
 	      /*
 	       * Key still active; pthread_key_delete
-	       * will block on these same mutexes before
+	       * will block on these same locks before
 	       * it can release actual key; therefore,
-	       * key is valid and we can call the destroy
-	       * routine;
+	       * key is valid and we can take the value
+	       * and the destroy routine.
 	       */
-	      k = assoc->key;
-	      destructor = k->destructor;
-	      value = TlsGetValue(k->key);
-	      TlsSetValue (k->key, NULL);
+	      value = PTW32_TSD_GET (sp, assoc->key);
+	      destructor = assoc->key->destructor;
+	      sp->tsd[i].value = NULL;
 
-	      // Every assoc->key exists and has a destructor
-	      if (value != NULL && iterations <= PTHREAD_DESTRUCTOR_ITERATIONS)
+	      /*
+	       * Unlock both locks before the destructor runs.
+	       * POSIX says pthread_key_delete can be run from destructors,
+	       * and that probably includes with this key as target.
+	       * pthread_setspecific can also be run from destructors and
+	       * also needs to be able to access the assocs.
+	       */
+	      ptw32_mcs_lock_release(&threadLock);
+	      ptw32_mcs_lock_release(&keyLock);
+
+	      if (value == NULL)
 		{
-		  /*
-		   * Unlock both locks before the destructor runs.
-		   * POSIX says pthread_key_delete can be run from destructors,
-		   * and that probably includes with this key as target.
-		   * pthread_setspecific can also be run from destructors and
-		   * also needs to be able to access the assocs.
-		   */
-		  ptw32_mcs_lock_release(&threadLock);
-		  ptw32_mcs_lock_release(&keyLock);
+		  continue;
+		}
 
-		  assocsRemaining++;
+	      valuesRemaining++;
 
 #if defined(__cplusplus)
 
-		  try
-		    {
-		      /*
-		       * Run the caller's cleanup routine.
-		       */
-		      destructor (value);
-		    }
-		  catch (...)
-		    {
-		      /*
-		       * A system unexpected exception has occurred
-		       * running the user's destructor.
-		       * We get control back within this block in case
-		       * the application has set up it's own terminate
-		       * handler. Since we are leaving the thread we
-		       * should not get any internal pthreads
-		       * exceptions.
-		       */
-		      terminate ();
-		    }
-
-#else /* __cplusplus */
-
+	      try
+		{
 		  /*
 		   * Run the caller's cleanup routine.
 		   */
 		  destructor (value);
-
-#endif /* __cplusplus */
-
 		}
-	      else
+	      catch (...)
 		{
 		  /*
-		   * Remove association from both the key and thread chains
-		   * and reclaim it's memory resources.
+		   * A system unexpected exception has occurred
+		   * running the user's destructor.
+		   * We get control back within this block in case
+		   * the application has set up it's own terminate
+		   * handler. Since we are leaving the thread we
+		   * should not get any internal pthreads
+		   * exceptions.
 		   */
-		  ptw32_tkAssocDestroy (assoc);
+		  terminate ();
+		}
+
+#else /* __cplusplus */
+
+	      /*
+	       * Run the caller's cleanup routine.
+	       */
+	      destructor (value);
+
+#endif /* __cplusplus */
+
+	    }
+	}
+      while (valuesRemaining && iterations < PTHREAD_DESTRUCTOR_ITERATIONS);
+
+      /*
+       * Remove the thread's remaining associations from their keys'
+       * chains and reclaim their memory, locking as above. Values
+       * still set after the last iteration are dropped.
+       */
+      for (i = 0; i < sp->tsdSize; i++)
+	{
+	  if (sp->tsd[i].assoc == NULL)
+	    {
+	      continue;
+	    }
+
+	  ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
+
+	  if ((assoc = (ThreadKeyAssoc *) sp->tsd[i].assoc) != NULL)
+	    {
+	      if (ptw32_mcs_lock_try_acquire(&(assoc->key->keyLock), &keyLock) == EBUSY)
+		{
 		  ptw32_mcs_lock_release(&threadLock);
-		  ptw32_mcs_lock_release(&keyLock);
+		  Sleep(0);
+		  i--;
+		  continue;
 		}
+
+	      ptw32_tkAssocDestroy (assoc);
+	      ptw32_mcs_lock_release(&keyLock);
 	    }
+
+	  ptw32_mcs_lock_release(&threadLock);
 	}
-      while (assocsRemaining);
     }
 }				/* ptw32_callUserDestroyRoutines */
@@ -0,0 +1,226 @@
+/*
+ * ptw32_cond_queue.c
+ *
+ * Description:
+ * This translation unit implements condition variables and their primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Waiter FIFOs.
+ *
+ * Condition variables queue their blocked waiters in a doubly linked
+ * FIFO of ptw32_cond_waiter_t nodes, each on its waiter's stack. A
+ * broadcast moves the waiters it wakes, in order, onto a FIFO in the
+ * mutex they are waiting to re-acquire instead of waking them all at
+ * once (wait morphing). The caller holds the lock guarding the FIFO.
+ */
+
+void
+ptw32_cond_queue_add (ptw32_cond_waiter_t ** head,
+                      ptw32_cond_waiter_t ** tail,
+                      ptw32_cond_waiter_t * w)
+{
+  w->next = NULL;
+  w->prev = *tail;
+
+  if (*tail != NULL)
+    {
+      (*tail)->next = w;
+    }
+  else
+    {
+      *head = w;
+    }
+
+  *tail = w;
+}
+
+void
+ptw32_cond_queue_remove (ptw32_cond_waiter_t ** head,
+                         ptw32_cond_waiter_t ** tail,
+                         ptw32_cond_waiter_t * w)
+{
+  if (w->prev != NULL)
+    {
+      w->prev->next = w->next;
+    }
+  else
+    {
+      *head = w->next;
+    }
+
+  if (w->next != NULL)
+    {
+      w->next->prev = w->prev;
+    }
+  else
+    {
+      *tail = w->prev;
+    }
+}
+
+
+/*
+ * Morphed waiters.
+ *
+ * Waiters queued on a mutex by pthread_cond_broadcast are handed the
+ * mutex directly by pthread_mutex_unlock (ptw32_cond_morph_handoff), so
+ * a broadcast wakes each of them exactly once and only when it can run.
+ *
+ * Only the generic unlock path knows about them, so while any are
+ * queued the mutex lock_idx is kept at -1 (locked, possible waiters),
+ * which no inline or fast unlock path releases by itself. If the mutex
+ * turns out to be unlocked, one waiter is woken to lock it the normal
+ * way (ptw32_cond_morph_kick) and re-arms the mutex once it holds it.
+ */
+
+void
+ptw32_cond_morph_arm (pthread_mutex_t mx)
+{
+  LONG idx;
+
+  while (PTW32_MUTEX_MORPH_PENDING(mx))
+    {
+      idx = *(PTW32_INTERLOCKED_VOLATILE LONG *) &mx->lock_idx;
+
+      if (idx < 0)
+        {
+          break;
+        }
+
+      if (idx == 0)
+        {
+          ptw32_cond_morph_kick (mx);
+          break;
+        }
+
+      if ((PTW32_INTERLOCKED_LONG) 1 == PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                                          (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                          (PTW32_INTERLOCKED_LONG) -1,
+                                          (PTW32_INTERLOCKED_LONG) 1))
+        {
+          break;
+        }
+    }
+}
+
+void
+ptw32_cond_morph_kick (pthread_mutex_t mx)
+{
+  ptw32_mcs_local_node_t node;
+  ptw32_cond_waiter_t * w;
+  HANDLE event = NULL;
+
+  ptw32_mcs_lock_acquire (&mx->morphLock, &node);
+  if ((w = mx->morphHead) != NULL)
+    {
+      ptw32_cond_queue_remove (&mx->morphHead, &mx->morphTail, w);
+      event = w->event;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->state,
+                                             (PTW32_INTERLOCKED_LONG) PTW32_COND_SIGNALLED);
+    }
+  ptw32_mcs_lock_release (&node);
+
+  /* 'w' may be gone as soon as it is signalled. */
+  if (event != NULL)
+    {
+      (void) SetEvent (event);
+    }
+}
+
+int
+ptw32_cond_morph_handoff (pthread_mutex_t mx)
+     /*
+      * Called by the owner of 'mx' in place of releasing it.
+      * Returns PTW32_TRUE if ownership was passed to a morphed
+      * waiter, or PTW32_FALSE if there were none.
+      */
+{
+  ptw32_mcs_local_node_t node;
+  ptw32_cond_waiter_t * w;
+  HANDLE event = NULL;
+
+  ptw32_mcs_lock_acquire (&mx->morphLock, &node);
+  if ((w = mx->morphHead) != NULL)
+    {
+      ptw32_cond_queue_remove (&mx->morphHead, &mx->morphTail, w);
+      event = w->event;
+      mx->recursive_count = 1;
+      mx->ownerThread = w->self;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->state,
+                                             (PTW32_INTERLOCKED_LONG) PTW32_COND_OWNER);
+    }
+  ptw32_mcs_lock_release (&node);
+
+  if (event == NULL)
+    {
+      return PTW32_FALSE;
+    }
+
+  (void) SetEvent (event);
+
+  return PTW32_TRUE;
+}
+
+LONG
+ptw32_cond_morph_withdraw (ptw32_cond_waiter_t * w)
+     /*
+      * Called by a morphed waiter that timed out or was cancelled.
+      * Returns PTW32_COND_WITHDRAWN if it was still queued on the
+      * mutex, otherwise the state it was woken with.
+      */
+{
+  ptw32_mcs_local_node_t node;
+  pthread_mutex_t mx = w->mx;
+  LONG state;
+
+  ptw32_mcs_lock_acquire (&mx->morphLock, &node);
+  if ((state = w->state) == PTW32_COND_MORPHED)
+    {
+      ptw32_cond_queue_remove (&mx->morphHead, &mx->morphTail, w);
+      w->state = state = PTW32_COND_WITHDRAWN;
+    }
+  ptw32_mcs_lock_release (&node);
+
+  return state;
+}
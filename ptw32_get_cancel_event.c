@@ -0,0 +1,103 @@
+/*
+ * ptw32_get_cancel_event.c
+ *
+ * Description:
+ * This translation unit implements miscellaneous thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+HANDLE
+ptw32_get_cancel_event (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the thread's manual-reset cancel event,
+      *      creating it on first use.
+      *
+      *      ptw32_new() does not create the event because most
+      *      threads are never cancelled and many never reach a
+      *      blocking cancellation point. It is created by whichever
+      *      comes first: the thread blocking in a cancellation
+      *      point or another thread calling pthread_cancel(). If
+      *      both race, each installs its event with a
+      *      compare-exchange and the loser closes its own, so a
+      *      cancel request is never lost.
+      *
+      * RESULTS
+      *              The event, or NULL if it could not be created.
+      *
+      * ------------------------------------------------------
+      */
+{
+  HANDLE event = (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(
+                            (PTW32_INTERLOCKED_PVOID_PTR) &tp->cancelEvent,
+                            (PTW32_INTERLOCKED_PVOID) 0,
+                            (PTW32_INTERLOCKED_PVOID) 0);
+
+  if (event == NULL)
+    {
+      HANDLE newEvent = CreateEvent (0, (int) PTW32_TRUE,	/* manualReset  */
+				     (int) PTW32_FALSE,	/* setSignaled  */
+				     NULL);
+
+      if (newEvent == NULL)
+        {
+          return NULL;
+        }
+
+      event = (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(
+                         (PTW32_INTERLOCKED_PVOID_PTR) &tp->cancelEvent,
+                         (PTW32_INTERLOCKED_PVOID) newEvent,
+                         (PTW32_INTERLOCKED_PVOID) 0);
+
+      if (event == NULL)
+        {
+          event = newEvent;
+        }
+      else
+        {
+          (void) CloseHandle (newEvent);
+        }
+    }
+
+  return event;
+}
@@ -0,0 +1,122 @@
+/*
+ * ptw32_key_index.c
+ *
+ * Description:
+ * This translation unit allocates thread-specific data key indices.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Give 'key' a free index, and the next generation of that index.
+ * Freed indices are reused before new ones are handed out, so that
+ * threads' 'tsd' arrays grow no longer than the peak number of keys.
+ */
+int
+ptw32_key_index_alloc (pthread_key_t key)
+{
+  int result = 0;
+  LONG i;
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_key_lock, &node);
+
+  if ((i = ptw32_keyIndexFree) >= 0)
+    {
+      ptw32_keyIndexFree = ptw32_keyIndex[i].nextFree;
+    }
+  else
+    {
+      if (ptw32_keyIndexUsed == ptw32_keyIndexSize)
+        {
+          LONG newSize = (ptw32_keyIndexSize == 0 ? 64 : ptw32_keyIndexSize * 2);
+          ptw32_key_index_t * newIndex;
+
+          if (newSize < ptw32_keyIndexSize
+              || (newIndex = (ptw32_key_index_t *)
+                  realloc (ptw32_keyIndex, newSize * sizeof (*newIndex))) == NULL)
+            {
+              result = EAGAIN;
+              goto FAIL0;
+            }
+
+          memset (newIndex + ptw32_keyIndexSize, 0,
+                  (newSize - ptw32_keyIndexSize) * sizeof (*newIndex));
+          ptw32_keyIndex = newIndex;
+          ptw32_keyIndexSize = newSize;
+        }
+
+      i = ptw32_keyIndexUsed++;
+    }
+
+  /*
+   * Generation 0 is what a zeroed 'tsd' entry holds, so never use it.
+   */
+  if (++ptw32_keyIndex[i].gen == 0)
+    {
+      ptw32_keyIndex[i].gen = 1;
+    }
+
+  key->index = i;
+  key->gen = ptw32_keyIndex[i].gen;
+
+FAIL0:
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+/*
+ * Return the index of a deleted key. Values set for it remain in
+ * threads' 'tsd' arrays, but under a generation no key will match.
+ */
+void
+ptw32_key_index_free (pthread_key_t key)
+{
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_key_lock, &node);
+
+  ptw32_keyIndex[key->index].nextFree = ptw32_keyIndexFree;
+  ptw32_keyIndexFree = key->index;
+
+  ptw32_mcs_lock_release (&node);
+}
@@ -0,0 +1,105 @@
+/*
+ * ptw32_mutex_adaptive_spin.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+INLINE int
+ptw32_mutex_adaptive_spin (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Busy-waits for a bounded number of iterations trying
+      *      to acquire a contended PTHREAD_MUTEX_ADAPTIVE_NP mutex
+      *      before the caller falls back to blocking.
+      *
+      *      The spin budget adapts per mutex: it is twice the
+      *      running estimate of spins needed for recent acquisitions
+      *      (plus a small constant), capped at
+      *      PTW32_MUTEX_ADAPTIVE_SPIN_MAX. Short critical sections
+      *      therefore converge on a budget just large enough to
+      *      avoid sleeping, while long hold times shrink the budget
+      *      back toward the minimum.
+      *
+      *      The lock word is only read while it is held so that
+      *      spinning threads share the cache line with the owner.
+      *      Acquisition uses a compare-exchange from 0 (free, no
+      *      waiters) so that a -1 "possible waiters" marker is
+      *      never overwritten by a spinning thread.
+      *
+      * RESULTS
+      *              1               the lock was acquired (lock_idx == 1),
+      *              0               the caller must block.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int count = 0;
+  int maxCount = PTW32_MIN (PTW32_MUTEX_ADAPTIVE_SPIN_MAX, mx->spinCount * 2 + 10);
+  int acquired = 0;
+
+  while (count < maxCount)
+    {
+      count++;
+      PTW32_SPIN_PAUSE ();
+
+      if (0 == *(PTW32_INTERLOCKED_VOLATILE LONG *) &mx->lock_idx
+          && 0 == (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+                        (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                        (PTW32_INTERLOCKED_LONG) 1,
+                        (PTW32_INTERLOCKED_LONG) 0))
+        {
+          acquired = 1;
+          break;
+        }
+    }
+
+  /*
+   * Exponential moving average with weight 1/8, as glibc does.
+   * A racy update only perturbs the estimate, never correctness.
+   */
+  mx->spinCount += (count - mx->spinCount) / 8;
+
+  return acquired;
+}
@@ -0,0 +1,216 @@
+/*
+ * ptw32_mutex_wait.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+static INLINE HANDLE
+ptw32_mutex_get_event (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the mutex's auto-reset event, creating it on
+      *      first use. Mutexes are initialised without an event so
+      *      that mutexes which are never contended never cost a
+      *      kernel object.
+      *
+      *      Both the first waiter and the unlocking thread may get
+      *      here at the same time. Each creates an event and tries
+      *      to install it with a compare-exchange; the loser closes
+      *      its own event and uses the winner's, so a wakeup posted
+      *      before the waiter blocks is never lost.
+      *
+      * RESULTS
+      *              The event, or NULL if it could not be created.
+      *
+      * ------------------------------------------------------
+      */
+{
+  HANDLE event = (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(
+                            (PTW32_INTERLOCKED_PVOID_PTR) &mx->event,
+                            (PTW32_INTERLOCKED_PVOID) 0,
+                            (PTW32_INTERLOCKED_PVOID) 0);
+
+  if (event == NULL)
+    {
+      HANDLE newEvent = CreateEvent (NULL,  PTW32_FALSE,    /* manual reset = No */
+                                      PTW32_FALSE,           /* initial state = not signalled */
+                                     NULL);                 /* event name */
+
+      if (newEvent == NULL)
+        {
+          return NULL;
+        }
+
+      event = (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(
+                         (PTW32_INTERLOCKED_PVOID_PTR) &mx->event,
+                         (PTW32_INTERLOCKED_PVOID) newEvent,
+                         (PTW32_INTERLOCKED_PVOID) 0);
+
+      if (event == NULL)
+        {
+          event = newEvent;
+        }
+      else
+        {
+          (void) CloseHandle (newEvent);
+        }
+    }
+
+  return event;
+}
+
+
+INLINE int
+ptw32_mutex_wait (pthread_mutex_t mx, const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Blocks the calling thread until the mutex is released
+      *      or until abstime passes. The caller has just set
+      *      mx->lock_idx to -1 (locked with waiters) and must
+      *      retry the acquisition when this routine returns 0.
+      *
+      *      If the system provides WaitOnAddress() then
+      *      non-robust mutexes park directly on lock_idx. The wait
+      *      returns as soon as lock_idx is no longer -1, so an
+      *      unlock that races with this call is never lost.
+      *      Wakeups may be spurious; the caller's retry loop
+      *      absorbs them. Otherwise the thread waits on the
+      *      mutex's event, which is created on first contention.
+      *
+      *      If 'abstime' is a NULL pointer then this function will
+      *      block without a timeout.
+      *
+      *      This routine is not a cancellation point.
+      *
+      * RESULTS
+      *              0               woken (or spurious wakeup),
+      *              ETIMEDOUT       abstime passed
+      *              EINVAL          the wait failed
+      *
+      * ------------------------------------------------------
+      */
+{
+  DWORD milliseconds;
+
+  if (abstime == NULL)
+    {
+      milliseconds = INFINITE;
+    }
+  else
+    {
+      /*
+       * Calculate timeout as milliseconds from current system time.
+       */
+      milliseconds = ptw32_relmillisecs (abstime);
+    }
+
+  if (mx->kind >= 0 && ptw32_wait_on_address != NULL)
+    {
+      LONG waiters = -1;
+
+      if (!ptw32_wait_on_address ((volatile VOID *) &mx->lock_idx,
+                                  (PVOID) &waiters,
+                                  sizeof(mx->lock_idx),
+                                  milliseconds))
+        {
+          return (GetLastError () == ERROR_TIMEOUT) ? ETIMEDOUT : EINVAL;
+        }
+    }
+  else
+    {
+      HANDLE event = ptw32_mutex_get_event (mx);
+      DWORD status;
+
+      if (event == NULL)
+        {
+          return EINVAL;
+        }
+
+      status = WaitForSingleObject (event, milliseconds);
+
+      if (status != WAIT_OBJECT_0)
+        {
+          return (status == WAIT_TIMEOUT) ? ETIMEDOUT : EINVAL;
+        }
+    }
+
+  return 0;
+}
+
+
+INLINE int
+ptw32_mutex_wake (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Wakes one thread blocked in ptw32_mutex_wait().
+      *      Called after the unlocking thread has exchanged
+      *      mx->lock_idx from -1 to 0, and to pass on the
+      *      wakeup of a robust mutex whose owner died.
+      *
+      * RESULTS
+      *              0               success,
+      *              EINVAL          the event could not be set
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (mx->kind >= 0 && ptw32_wait_on_address != NULL)
+    {
+      ptw32_wake_by_address_single ((PVOID) &mx->lock_idx);
+    }
+  else
+    {
+      HANDLE event = ptw32_mutex_get_event (mx);
+
+      if (event == NULL || SetEvent (event) == 0)
+        {
+          return EINVAL;
+        }
+    }
+
+  return 0;
+}
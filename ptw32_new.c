@@ -90,15 +90,10 @@ ptw32_new (void)
 #if defined(HAVE_CPU_AFFINITY)
   CPU_ZERO((cpu_set_t*)&tp->cpuset);
 #endif
-  tp->cancelEvent = CreateEvent (0, (int) PTW32_TRUE,	/* manualReset  */
-				 (int) PTW32_FALSE,	/* setSignaled  */
-				 NULL);
-
-  if (tp->cancelEvent == NULL)
-    {
-      ptw32_threadReusePush (tp->ptHandle);
-      return nil;
-    }
+  /* Created on demand. See ptw32_get_cancel_event.c */
+  tp->cancelEvent = NULL;
+  /* Created by the thread's first condition variable wait. */
+  tp->condEvent = NULL;
 
   return t;
 }
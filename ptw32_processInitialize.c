@@ -78,8 +78,7 @@ ptw32_processInitialize (void)
   /*
    * Explicitly initialise all variables from global.c
    */
-  ptw32_threadReuseTop = PTW32_THREAD_REUSE_EMPTY;
-  ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
+  InitializeSListHead (&ptw32_threadReuseStack);
   ptw32_selfThreadKey = NULL;
   ptw32_cleanupKey = NULL;
   ptw32_cond_list_head = NULL;
@@ -103,7 +102,7 @@ ptw32_processInitialize (void)
   ptw32_register_cancellation = NULL;
 
   /*
-   * Global lock for managing pthread_t struct reuse.
+   * Global lock for retiring pthread_t handles.
    */
   ptw32_thread_reuse_lock = 0;
 
@@ -71,8 +71,7 @@ ptw32_processTerminate (void)
 {
   if (ptw32_processInitialized)
     {
-      ptw32_thread_t * tp, * tpNext;
-      ptw32_mcs_local_node_t node;
+      PSLIST_ENTRY e, eNext;
 
       if (ptw32_selfThreadKey != NULL)
 	{
@@ -82,6 +81,7 @@ ptw32_processTerminate (void)
 	  pthread_key_delete (ptw32_selfThreadKey);
 
 	  ptw32_selfThreadKey = NULL;
+	  PTW32_SELF_CACHE_SET(NULL);
 	}
 
       if (ptw32_cleanupKey != NULL)
@@ -94,27 +94,27 @@ ptw32_processTerminate (void)
 	  ptw32_cleanupKey = NULL;
 	}
 
-      ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
-
-      tp = ptw32_threadReuseTop;
-      while (tp != PTW32_THREAD_REUSE_EMPTY)
+      e = InterlockedFlushSList (&ptw32_threadReuseStack);
+      while (e != NULL)
 	{
-	  tpNext = tp->prevReuse;
-	  free (tp);
-	  tp = tpNext;
+	  eNext = e->Next;
+	  free (CONTAINING_RECORD (e, ptw32_thread_t, reuseEntry));
+	  e = eNext;
 	}
 
-	  ptw32_threadReuseTop = PTW32_THREAD_REUSE_EMPTY;
-	  ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
-
-      ptw32_mcs_lock_release(&node);
-
 	  /* ptw32_cond_list_head = NULL; */
 	  /* ptw32_cond_list_tail = NULL; */
 
 	  /* reset the thread sequence number. */
 	  ptw32_threadSeqNumber = 0;
 
+      ptw32_pshared_terminate ();
+
+      /*
+       * Last: the key deletions above still free slab objects.
+       */
+      ptw32_slab_destroy ();
+
       ptw32_processInitialized = PTW32_FALSE;
     }
 
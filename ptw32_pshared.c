@@ -0,0 +1,530 @@
+/*
+ * ptw32_pshared.c
+ *
+ * Description:
+ * This translation unit implements process-shared object support.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Process-shared synchronisation objects.
+ *
+ * pthread_mutex_t and friends are pointer-sized handles, too small to
+ * hold an object's state in the memory that the application shares.
+ * Instead a PTHREAD_PROCESS_SHARED object is a page-file backed section
+ * named after a machine-wide id, plus the named events that its waiters
+ * block on, and the handle stores the encoded id (see
+ * PTW32_PSHARED_IS_HANDLE). Any process that finds the handle in shared
+ * memory maps the section by name the first time it uses the object.
+ * The state in the section holds only counters, lock words and Windows
+ * thread ids, never pointers.
+ *
+ * Each process keeps its views in a small hash table. Lookups walk the
+ * chains without locking; views are added and removed under
+ * ptw32_pshared_lock and removed views are only freed when the process
+ * detaches, so a concurrent walk never touches freed memory.
+ *
+ * The section and events disappear with the last process that has
+ * them open. pthread_*_destroy only closes the caller's view and marks
+ * the object invalid for everybody else.
+ */
+
+/*
+ * Change the layout number whenever ptw32_pshared_t (or the meaning of
+ * its fields) changes so that
+ * processes using different versions never share an object.
+ */
+#define PTW32_PSHARED_NAME "pthreads4w-pshared-2-"
+
+static void
+ptw32_pshared_name (char * name, LONG id, int event)
+{
+  if (event < 0)
+    {
+      (void) sprintf (name, PTW32_PSHARED_NAME "%ld", (long) id);
+    }
+  else
+    {
+      (void) sprintf (name, PTW32_PSHARED_NAME "%ld-%d", (long) id, event);
+    }
+}
+
+/*
+ * The number of events the object type needs and whether they are
+ * auto-reset (mutex waiters) or manual-reset (condition waiters).
+ */
+static int
+ptw32_pshared_event_count (LONG type, BOOL * manualReset)
+{
+  *manualReset = (type != PTW32_PSHARED_MUTEX);
+
+  return (type == PTW32_PSHARED_RWLOCK ? 2 : 1);
+}
+
+static void
+ptw32_pshared_close (ptw32_pshared_local_t * local)
+{
+  int i;
+
+  for (i = 0; i < PTW32_PSHARED_EVENTS; i++)
+    {
+      if (local->event[i] != NULL)
+	{
+	  (void) CloseHandle (local->event[i]);
+	  local->event[i] = NULL;
+	}
+    }
+
+  if (local->shared != NULL)
+    {
+      (void) UnmapViewOfFile (local->shared);
+      local->shared = NULL;
+    }
+
+  if (local->section != NULL)
+    {
+      (void) CloseHandle (local->section);
+      local->section = NULL;
+    }
+}
+
+static void
+ptw32_pshared_publish (ptw32_pshared_local_t * local)
+     /*
+      * Must be called holding ptw32_pshared_lock.
+      */
+{
+  ptw32_pshared_local_t ** bucket =
+    &ptw32_pshared_cache[local->id & (PTW32_PSHARED_CACHE_SIZE - 1)];
+
+  local->next = *bucket;
+  (void) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) bucket,
+                                         (PTW32_INTERLOCKED_PVOID) local);
+}
+
+static ptw32_pshared_local_t *
+ptw32_pshared_lookup (LONG id)
+{
+  ptw32_pshared_local_t * local;
+
+  local = *(ptw32_pshared_local_t * PTW32_INTERLOCKED_VOLATILE *)
+            &ptw32_pshared_cache[id & (PTW32_PSHARED_CACHE_SIZE - 1)];
+
+  while (local != NULL && local->id != id)
+    {
+      local = local->next;
+    }
+
+  return local;
+}
+
+int
+ptw32_pshared_create (LONG type, ptw32_pshared_local_t ** local)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Creates the section and events of a new process-shared
+      *      object and maps it into this process. The caller
+      *      initialises the type-specific state before storing
+      *      the handle where other processes can see it.
+      *
+      * RESULTS
+      *              0               success,
+      *              ENOMEM          insufficient memory,
+      *              EAGAIN          the system lacked the necessary
+      *                              resources.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_local_t * lp;
+  ptw32_mcs_local_node_t node;
+  char name[64];
+  BOOL manualReset;
+  int nEvents;
+  int i;
+  LONG id;
+  int result = 0;
+
+  ptw32_processInitialize ();
+
+  if ((lp = (ptw32_pshared_local_t *) calloc (1, sizeof (*lp))) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_pshared_lock, &node);
+
+  if (ptw32_pshared_nextId == NULL)
+    {
+      (void) sprintf (name, PTW32_PSHARED_NAME "ids");
+      ptw32_pshared_idSection = CreateFileMappingA (INVALID_HANDLE_VALUE, NULL,
+                                                    PAGE_READWRITE, 0,
+                                                    sizeof (LONG), name);
+      if (ptw32_pshared_idSection == NULL
+          || (ptw32_pshared_nextId = (LONG *) MapViewOfFile (ptw32_pshared_idSection,
+                                                             FILE_MAP_ALL_ACCESS,
+                                                             0, 0, 0)) == NULL)
+	{
+	  result = EAGAIN;
+	  goto FAIL0;
+	}
+    }
+
+  /*
+   * The counter restarts when the last process using it exits, while
+   * other processes may still hold objects. Skip ids whose section
+   * still exists.
+   */
+  for (;;)
+    {
+      id = (LONG) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) ptw32_pshared_nextId)
+           & PTW32_PSHARED_MAX_ID;
+
+      if (id == 0)
+	{
+	  continue;
+	}
+
+      ptw32_pshared_name (name, id, -1);
+      lp->section = CreateFileMappingA (INVALID_HANDLE_VALUE, NULL,
+                                        PAGE_READWRITE, 0,
+                                        sizeof (ptw32_pshared_t), name);
+      if (lp->section == NULL)
+	{
+	  result = EAGAIN;
+	  goto FAIL0;
+	}
+
+      if (GetLastError () != ERROR_ALREADY_EXISTS)
+	{
+	  break;
+	}
+
+      (void) CloseHandle (lp->section);
+    }
+
+  lp->id = id;
+
+  if ((lp->shared = (ptw32_pshared_t *) MapViewOfFile (lp->section,
+                                                       FILE_MAP_ALL_ACCESS,
+                                                       0, 0, 0)) == NULL)
+    {
+      result = EAGAIN;
+      goto FAIL0;
+    }
+
+  nEvents = ptw32_pshared_event_count (type, &manualReset);
+
+  for (i = 0; i < nEvents; i++)
+    {
+      ptw32_pshared_name (name, id, i);
+      if ((lp->event[i] = CreateEventA (NULL, manualReset, PTW32_FALSE, name)) == NULL)
+	{
+	  result = EAGAIN;
+	  goto FAIL0;
+	}
+    }
+
+  /* A new section is zero-filled. */
+  lp->shared->type = type;
+  lp->shared->magic = PTW32_PSHARED_MAGIC;
+
+  ptw32_pshared_publish (lp);
+  ptw32_mcs_lock_release (&node);
+
+  *local = lp;
+
+  return 0;
+
+FAIL0:
+  ptw32_mcs_lock_release (&node);
+  ptw32_pshared_close (lp);
+  free (lp);
+
+  return result;
+}
+
+ptw32_pshared_local_t *
+ptw32_pshared_find (void * handle, LONG type)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Returns this process's view of the process-shared
+      *      object 'handle', mapping it on first use, or NULL if
+      *      the object doesn't exist, has been destroyed or is
+      *      not of the given type.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_local_t * lp;
+  ptw32_mcs_local_node_t node;
+  char name[64];
+  BOOL manualReset;
+  int nEvents;
+  int i;
+  LONG id = PTW32_PSHARED_ID (handle);
+
+  if ((lp = ptw32_pshared_lookup (id)) == NULL)
+    {
+      ptw32_mcs_lock_acquire (&ptw32_pshared_lock, &node);
+
+      if ((lp = ptw32_pshared_lookup (id)) == NULL
+          && (lp = (ptw32_pshared_local_t *) calloc (1, sizeof (*lp))) != NULL)
+	{
+	  lp->id = id;
+	  ptw32_pshared_name (name, id, -1);
+
+	  if ((lp->section = OpenFileMappingA (FILE_MAP_ALL_ACCESS, PTW32_FALSE, name)) == NULL
+	      || (lp->shared = (ptw32_pshared_t *) MapViewOfFile (lp->section,
+                                                                  FILE_MAP_ALL_ACCESS,
+                                                                  0, 0, 0)) == NULL
+	      || lp->shared->magic != PTW32_PSHARED_MAGIC)
+	    {
+	      goto FAIL0;
+	    }
+
+	  nEvents = ptw32_pshared_event_count (lp->shared->type, &manualReset);
+
+	  for (i = 0; i < nEvents; i++)
+	    {
+	      ptw32_pshared_name (name, id, i);
+	      if ((lp->event[i] = OpenEventA (EVENT_MODIFY_STATE | SYNCHRONIZE,
+                                              PTW32_FALSE, name)) == NULL)
+		{
+		  goto FAIL0;
+		}
+	    }
+
+	  ptw32_pshared_publish (lp);
+	}
+
+      ptw32_mcs_lock_release (&node);
+    }
+
+  if (lp == NULL
+      || lp->shared == NULL
+      || lp->shared->magic != PTW32_PSHARED_MAGIC
+      || lp->shared->type != type)
+    {
+      return NULL;
+    }
+
+  return lp;
+
+FAIL0:
+  ptw32_mcs_lock_release (&node);
+  ptw32_pshared_close (lp);
+  free (lp);
+
+  return NULL;
+}
+
+void
+ptw32_pshared_destroy (ptw32_pshared_local_t * local)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Invalidates a process-shared object for all processes
+      *      and closes this process's view of it.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_local_t ** lpp;
+  ptw32_mcs_local_node_t node;
+
+  local->shared->magic = 0;
+
+  ptw32_mcs_lock_acquire (&ptw32_pshared_lock, &node);
+
+  lpp = &ptw32_pshared_cache[local->id & (PTW32_PSHARED_CACHE_SIZE - 1)];
+
+  while (*lpp != local)
+    {
+      lpp = &(*lpp)->next;
+    }
+
+  *lpp = local->next;
+  ptw32_pshared_close (local);
+
+  /*
+   * A concurrent lookup may still be looking at this node. If it
+   * follows 'next' into the retired list it won't find its id there
+   * and will search again under the lock.
+   */
+  local->next = ptw32_pshared_retired;
+  ptw32_pshared_retired = local;
+
+  ptw32_mcs_lock_release (&node);
+}
+
+void
+ptw32_pshared_terminate (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Closes all of this process's views of process-shared
+      *      objects. Called when the process detaches.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_local_t * lp;
+  ptw32_pshared_local_t * next;
+  ptw32_mcs_local_node_t node;
+  int i;
+
+  ptw32_mcs_lock_acquire (&ptw32_pshared_lock, &node);
+
+  for (i = 0; i <= PTW32_PSHARED_CACHE_SIZE; i++)
+    {
+      if (i < PTW32_PSHARED_CACHE_SIZE)
+	{
+	  lp = ptw32_pshared_cache[i];
+	  ptw32_pshared_cache[i] = NULL;
+	}
+      else
+	{
+	  lp = ptw32_pshared_retired;
+	  ptw32_pshared_retired = NULL;
+	}
+
+      for (; lp != NULL; lp = next)
+	{
+	  next = lp->next;
+	  ptw32_pshared_close (lp);
+	  free (lp);
+	}
+    }
+
+  if (ptw32_pshared_nextId != NULL)
+    {
+      (void) UnmapViewOfFile (ptw32_pshared_nextId);
+      ptw32_pshared_nextId = NULL;
+    }
+
+  if (ptw32_pshared_idSection != NULL)
+    {
+      (void) CloseHandle (ptw32_pshared_idSection);
+      ptw32_pshared_idSection = NULL;
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
+
+int
+ptw32_pshared_thread_dead (DWORD tid)
+     /*
+      * True if Windows thread 'tid', possibly in another process,
+      * has exited.
+      */
+{
+  HANDLE h;
+  int dead;
+
+  if (tid == 0)
+    {
+      return PTW32_FALSE;
+    }
+
+  if ((h = OpenThread (SYNCHRONIZE, PTW32_FALSE, tid)) == NULL)
+    {
+      return (GetLastError () == ERROR_INVALID_PARAMETER);
+    }
+
+  dead = (WaitForSingleObject (h, 0) == WAIT_OBJECT_0);
+  (void) CloseHandle (h);
+
+  return dead;
+}
+
+void
+ptw32_pshared_guard_acquire (LONG * guard)
+     /*
+      * Spin lock for the few instructions that update the counters
+      * of a shared condition, rwlock or barrier.
+      *
+      * The guard holds the holder's Windows thread id. A waiter that
+      * has been yielding for a while checks that the holder is still
+      * alive, and takes the guard over from a thread that died holding
+      * it (e.g. its process was terminated), as a robust mutex does.
+      * The counters may then be off by the dead thread's update.
+      */
+{
+  LONG self = (LONG) GetCurrentThreadId ();
+  LONG holder;
+  int spins = 0;
+
+  while ((holder = (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                            (PTW32_INTERLOCKED_LONGPTR) guard,
+                            (PTW32_INTERLOCKED_LONG) self,
+                            (PTW32_INTERLOCKED_LONG) 0)) != 0)
+    {
+      if (++spins < PTW32_MCS_SPIN_COUNT)
+	{
+	  PTW32_SPIN_PAUSE ();
+	  continue;
+	}
+
+      if (spins % PTW32_MCS_SPIN_COUNT == 0
+	  && ptw32_pshared_thread_dead ((DWORD) holder)
+	  && (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                      (PTW32_INTERLOCKED_LONGPTR) guard,
+                      (PTW32_INTERLOCKED_LONG) self,
+                      (PTW32_INTERLOCKED_LONG) holder) == holder)
+	{
+	  return;
+	}
+
+      Sleep (0);
+    }
+}
+
+void
+ptw32_pshared_guard_release (LONG * guard)
+{
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) guard,
+                                          (PTW32_INTERLOCKED_LONG) 0);
+}
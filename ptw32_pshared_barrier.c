@@ -0,0 +1,143 @@
+/*
+ * ptw32_pshared_barrier.c
+ *
+ * Description:
+ * This translation unit implements process-shared barriers.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+ptw32_pshared_barrier_init (pthread_barrier_t * barrier, unsigned int count)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_barrier_t * b;
+  int result;
+
+  if ((result = ptw32_pshared_create (PTW32_PSHARED_BARRIER, &local)) == 0)
+    {
+      b = &local->shared->u.barrier;
+      b->count = b->remaining = (LONG) count;
+      *barrier = (pthread_barrier_t) PTW32_PSHARED_HANDLE (local->id);
+    }
+
+  return result;
+}
+
+int
+ptw32_pshared_barrier_destroy (pthread_barrier_t * barrier)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_barrier_t * b;
+  int busy;
+
+  if ((local = ptw32_pshared_find (*barrier, PTW32_PSHARED_BARRIER)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  b = &local->shared->u.barrier;
+
+  ptw32_pshared_guard_acquire (&b->guard);
+  busy = (b->remaining != b->count || b->cv.nWaiters > 0);
+  ptw32_pshared_guard_release (&b->guard);
+
+  if (busy)
+    {
+      return EBUSY;
+    }
+
+  *barrier = NULL;
+  ptw32_pshared_destroy (local);
+
+  return 0;
+}
+
+int
+ptw32_pshared_barrier_wait (pthread_barrier_t barrier)
+     /*
+      * The last thread to arrive starts a new generation and releases
+      * the others, who wait until they see it. Not a cancellation
+      * point, as for process-private barriers.
+      */
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_barrier_t * b;
+  LONG generation;
+  LONG cvGeneration;
+
+  if ((local = ptw32_pshared_find (barrier, PTW32_PSHARED_BARRIER)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  b = &local->shared->u.barrier;
+
+  ptw32_pshared_guard_acquire (&b->guard);
+
+  if (--b->remaining == 0)
+    {
+      b->remaining = b->count;
+      b->generation++;
+      ptw32_pshared_cond_release (&b->cv, local->event[0], PTW32_TRUE);
+      ptw32_pshared_guard_release (&b->guard);
+
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  generation = b->generation;
+
+  do
+    {
+      cvGeneration = ptw32_pshared_cond_enter (&b->cv);
+      ptw32_pshared_guard_release (&b->guard);
+
+      (void) ptw32_pshared_cond_block (&b->cv, local->event[0],
+                                       cvGeneration, NULL, PTW32_FALSE);
+
+      ptw32_pshared_guard_acquire (&b->guard);
+    }
+  while (b->generation == generation);
+
+  ptw32_pshared_guard_release (&b->guard);
+
+  return 0;
+}
@@ -0,0 +1,335 @@
+/*
+ * ptw32_pshared_cond.c
+ *
+ * Description:
+ * This translation unit implements process-shared condition variables.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Process-shared condition variables, and the waiting used by shared
+ * rwlocks and barriers.
+ *
+ * Waiters can't be queued the way process-private ones are because
+ * nothing in the shared section may point into a process. Instead a
+ * signal or broadcast (a "release") records how many of the current
+ * waiters may go, advances the generation and sets the object's
+ * manual-reset event. A woken waiter that entered before the latest
+ * release takes a token; the one that takes the last token resets the
+ * event. Waiters that entered after the release find no token for them
+ * and go back to sleep, so a late arrival can't steal a wake-up from a
+ * thread that was waiting when it was sent.
+ */
+
+static int
+ptw32_pshared_cond_take (ptw32_pshared_cond_t * cv, HANDLE event, LONG generation)
+     /*
+      * Must be called holding cv->guard.
+      */
+{
+  if (cv->nRelease > 0 && cv->generation != generation)
+    {
+      cv->nWaiters--;
+      if (--cv->nRelease == 0)
+	{
+	  (void) ResetEvent (event);
+	}
+      return PTW32_TRUE;
+    }
+
+  return PTW32_FALSE;
+}
+
+LONG
+ptw32_pshared_cond_enter (ptw32_pshared_cond_t * cv)
+     /*
+      * Registers the caller as a waiter. Must be called before
+      * releasing the lock that protects the caller's predicate.
+      * Returns the generation to pass to ptw32_pshared_cond_block.
+      */
+{
+  LONG generation;
+
+  ptw32_pshared_guard_acquire (&cv->guard);
+  cv->nWaiters++;
+  generation = cv->generation;
+  ptw32_pshared_guard_release (&cv->guard);
+
+  return generation;
+}
+
+int
+ptw32_pshared_cond_leave (ptw32_pshared_cond_t * cv, HANDLE event, LONG generation)
+     /*
+      * Withdraws a waiter that won't block again. Returns true if
+      * a release was consumed in the process.
+      */
+{
+  int released;
+
+  ptw32_pshared_guard_acquire (&cv->guard);
+  if (!(released = ptw32_pshared_cond_take (cv, event, generation)))
+    {
+      cv->nWaiters--;
+    }
+  ptw32_pshared_guard_release (&cv->guard);
+
+  return released;
+}
+
+int
+ptw32_pshared_cond_block (ptw32_pshared_cond_t * cv, HANDLE event,
+                          LONG generation, const struct timespec * abstime,
+                          int cancelable)
+     /*
+      * Waits for a release after ptw32_pshared_cond_enter. Returns 0
+      * when released, otherwise the caller is no longer a waiter.
+      */
+{
+  DWORD milliseconds;
+  int result;
+
+  for (;;)
+    {
+      milliseconds = (abstime == NULL ? INFINITE : ptw32_relmillisecs (abstime));
+
+      if (cancelable)
+	{
+	  result = pthreadCancelableTimedWait (event, milliseconds);
+	}
+      else
+	{
+	  switch (WaitForSingleObject (event, milliseconds))
+	    {
+	    case WAIT_OBJECT_0:
+	      result = 0;
+	      break;
+	    case WAIT_TIMEOUT:
+	      result = ETIMEDOUT;
+	      break;
+	    default:
+	      result = EINVAL;
+	      break;
+	    }
+	}
+
+      ptw32_pshared_guard_acquire (&cv->guard);
+
+      if (ptw32_pshared_cond_take (cv, event, generation))
+	{
+	  result = 0;
+	  break;
+	}
+
+      /*
+       * The event is still set for waiters that entered before us.
+       */
+      if (result == 0 && milliseconds == 0)
+	{
+	  result = ETIMEDOUT;
+	}
+
+      if (result != 0)
+	{
+	  cv->nWaiters--;
+	  break;
+	}
+
+      ptw32_pshared_guard_release (&cv->guard);
+
+      Sleep (1);
+    }
+
+  ptw32_pshared_guard_release (&cv->guard);
+
+  return result;
+}
+
+void
+ptw32_pshared_cond_release (ptw32_pshared_cond_t * cv, HANDLE event, int all)
+     /*
+      * Releases one, or all, of the current waiters that haven't
+      * already been released.
+      */
+{
+  ptw32_pshared_guard_acquire (&cv->guard);
+
+  if (cv->nWaiters > cv->nRelease)
+    {
+      cv->nRelease = (all ? cv->nWaiters : cv->nRelease + 1);
+      cv->generation++;
+      (void) SetEvent (event);
+    }
+
+  ptw32_pshared_guard_release (&cv->guard);
+}
+
+int
+ptw32_pshared_cond_init (pthread_cond_t * cond)
+{
+  ptw32_pshared_local_t * local;
+  int result;
+
+  if ((result = ptw32_pshared_create (PTW32_PSHARED_COND, &local)) == 0)
+    {
+      *cond = (pthread_cond_t) PTW32_PSHARED_HANDLE (local->id);
+    }
+
+  return result;
+}
+
+int
+ptw32_pshared_cond_destroy (pthread_cond_t * cond)
+{
+  ptw32_pshared_local_t * local;
+
+  if ((local = ptw32_pshared_find (*cond, PTW32_PSHARED_COND)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &local->shared->u.cond.nWaiters > 0)
+    {
+      return EBUSY;
+    }
+
+  *cond = NULL;
+  ptw32_pshared_destroy (local);
+
+  return 0;
+}
+
+/*
+ * Arguments for ptw32_pshared_cond_wait_cleanup.
+ */
+typedef struct
+{
+  ptw32_pshared_cond_t * cv;
+  HANDLE event;
+  LONG generation;
+  pthread_mutex_t * mutexPtr;
+} ptw32_pshared_cond_cleanup_args_t;
+
+static void PTW32_CDECL
+ptw32_pshared_cond_wait_cleanup (void * args)
+     /*
+      * Only runs if the waiter is cancelled. A release that the
+      * waiter had already been given is passed on to another.
+      */
+{
+  ptw32_pshared_cond_cleanup_args_t * cleanup_args =
+    (ptw32_pshared_cond_cleanup_args_t *) args;
+
+  if (ptw32_pshared_cond_leave (cleanup_args->cv, cleanup_args->event,
+                                cleanup_args->generation))
+    {
+      ptw32_pshared_cond_release (cleanup_args->cv, cleanup_args->event, PTW32_FALSE);
+    }
+
+  /*
+   * XSH: Upon successful return, the mutex has been locked and is owned
+   * by the calling thread. This also applies to cancellation.
+   */
+  (void) pthread_mutex_lock (cleanup_args->mutexPtr);
+}
+
+int
+ptw32_pshared_cond_wait (pthread_cond_t cv, pthread_mutex_t * mutex,
+                         const struct timespec * abstime)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_cond_cleanup_args_t cleanup_args;
+  int result;
+  int lockResult;
+
+  if ((local = ptw32_pshared_find (cv, PTW32_PSHARED_COND)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  cleanup_args.cv = &local->shared->u.cond;
+  cleanup_args.event = local->event[0];
+  cleanup_args.mutexPtr = mutex;
+  cleanup_args.generation = ptw32_pshared_cond_enter (cleanup_args.cv);
+
+  if ((result = pthread_mutex_unlock (mutex)) != 0)
+    {
+      (void) ptw32_pshared_cond_leave (cleanup_args.cv, cleanup_args.event,
+                                       cleanup_args.generation);
+      return result;
+    }
+
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+  pthread_cleanup_push (ptw32_pshared_cond_wait_cleanup, (void *) &cleanup_args);
+
+  result = ptw32_pshared_cond_block (cleanup_args.cv, cleanup_args.event,
+                                     cleanup_args.generation, abstime, PTW32_TRUE);
+
+  pthread_cleanup_pop (0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+  if ((lockResult = pthread_mutex_lock (mutex)) != 0)
+    {
+      result = lockResult;
+    }
+
+  return result;
+}
+
+int
+ptw32_pshared_cond_signal (pthread_cond_t cv, int all)
+{
+  ptw32_pshared_local_t * local;
+
+  if ((local = ptw32_pshared_find (cv, PTW32_PSHARED_COND)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_pshared_cond_release (&local->shared->u.cond, local->event[0], all);
+
+  return 0;
+}
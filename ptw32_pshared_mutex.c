@@ -0,0 +1,355 @@
+/*
+ * ptw32_pshared_mutex.c
+ *
+ * Description:
+ * This translation unit implements process-shared mutexes.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Process-shared mutexes.
+ *
+ * The lock word works as for a process-private mutex: 0 unlocked,
+ * 1 locked, -1 locked with possible waiters, who block on the object's
+ * auto-reset named event. Owners are identified by their Windows
+ * thread id, which is unique across processes while the thread runs.
+ *
+ * A robust mutex's waiters also wait on the owner's thread handle.
+ * When that is signalled, or the thread no longer exists, the owner
+ * died holding the mutex, and whoever first replaces the owner's id
+ * with its own takes the mutex over with EOWNERDEAD. This covers both
+ * the owner thread exiting and its whole process terminating. Windows
+ * reuses thread ids, so an owner that died long ago may be mistaken
+ * for a new thread that has its id; the mutex then recovers when that
+ * thread exits.
+ */
+
+static int
+ptw32_pshared_mutex_takeover (ptw32_pshared_mutex_t * m, DWORD owner, DWORD self)
+{
+  if ((DWORD) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                (PTW32_INTERLOCKED_LONGPTR) &m->ownerTid,
+                (PTW32_INTERLOCKED_LONG) self,
+                (PTW32_INTERLOCKED_LONG) owner) != owner)
+    {
+      /* Somebody else got there first. */
+      return 0;
+    }
+
+  m->robustState = PTW32_ROBUST_INCONSISTENT;
+
+  /*
+   * Others may be waiting for the dead owner; make our unlock wake them.
+   */
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &m->lock_idx,
+                                          (PTW32_INTERLOCKED_LONG) -1);
+
+  return EOWNERDEAD;
+}
+
+static int
+ptw32_pshared_mutex_wait (ptw32_pshared_local_t * local, DWORD self,
+                          const struct timespec * abstime)
+     /*
+      * Blocks until the mutex may be free. Returns 0 to try again,
+      * EOWNERDEAD if the caller has taken over a dead owner's lock,
+      * or an error.
+      */
+{
+  ptw32_pshared_mutex_t * m = &local->shared->u.mutex;
+  HANDLE handles[2];
+  DWORD nHandles = 1;
+  DWORD milliseconds = (abstime == NULL ? INFINITE : ptw32_relmillisecs (abstime));
+  DWORD timeout = milliseconds;
+  DWORD owner = 0;
+  DWORD status;
+
+  handles[0] = local->event[0];
+
+  if (m->kind < 0)
+    {
+      if (m->robustState == PTW32_ROBUST_NOTRECOVERABLE)
+	{
+	  /* Pass the wake-up on to the next waiter. */
+	  (void) SetEvent (handles[0]);
+	  return ENOTRECOVERABLE;
+	}
+
+      owner = *(PTW32_INTERLOCKED_VOLATILE DWORD *) &m->ownerTid;
+
+      if (owner == 0)
+	{
+	  /*
+	   * The owner has set the lock word but not yet its id. Poll.
+	   */
+	  if (timeout > 1)
+	    {
+	      timeout = 1;
+	    }
+	}
+      else if ((handles[1] = OpenThread (SYNCHRONIZE, PTW32_FALSE, owner)) != NULL)
+	{
+	  nHandles = 2;
+	}
+      else if (GetLastError () == ERROR_INVALID_PARAMETER)
+	{
+	  /* No such thread. */
+	  return ptw32_pshared_mutex_takeover (m, owner, self);
+	}
+    }
+
+  status = WaitForMultipleObjects (nHandles, handles, PTW32_FALSE, timeout);
+
+  if (nHandles == 2)
+    {
+      (void) CloseHandle (handles[1]);
+    }
+
+  switch (status)
+    {
+    case WAIT_OBJECT_0:
+      return 0;
+    case WAIT_OBJECT_0 + 1:
+      return ptw32_pshared_mutex_takeover (m, owner, self);
+    case WAIT_TIMEOUT:
+      return (timeout < milliseconds ? 0 : ETIMEDOUT);
+    default:
+      return EINVAL;
+    }
+}
+
+int
+ptw32_pshared_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_mutex_t * m;
+  int result;
+
+  if ((result = ptw32_pshared_create (PTW32_PSHARED_MUTEX, &local)) != 0)
+    {
+      return result;
+    }
+
+  m = &local->shared->u.mutex;
+  m->kind = (*attr)->kind;
+  if ((*attr)->robustness == PTHREAD_MUTEX_ROBUST)
+    {
+      m->kind = -m->kind - 1;
+    }
+  m->robustState = PTW32_ROBUST_CONSISTENT;
+
+  *mutex = (pthread_mutex_t) PTW32_PSHARED_HANDLE (local->id);
+
+  return 0;
+}
+
+int
+ptw32_pshared_mutex_destroy (pthread_mutex_t * mutex)
+{
+  ptw32_pshared_local_t * local;
+
+  if ((local = ptw32_pshared_find (*mutex, PTW32_PSHARED_MUTEX)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (local->shared->u.mutex.lock_idx != 0)
+    {
+      return EBUSY;
+    }
+
+  *mutex = NULL;
+  ptw32_pshared_destroy (local);
+
+  return 0;
+}
+
+int
+ptw32_pshared_mutex_lock (pthread_mutex_t mx, int tryOnly,
+                          const struct timespec * abstime)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_mutex_t * m;
+  DWORD self = GetCurrentThreadId ();
+  DWORD owner;
+  int kind;
+  int result = 0;
+
+  if ((local = ptw32_pshared_find (mx, PTW32_PSHARED_MUTEX)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  m = &local->shared->u.mutex;
+  kind = m->kind;
+
+  if (kind < 0 && m->robustState == PTW32_ROBUST_NOTRECOVERABLE)
+    {
+      return ENOTRECOVERABLE;
+    }
+
+  if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                                 (PTW32_INTERLOCKED_LONGPTR) &m->lock_idx,
+                                 (PTW32_INTERLOCKED_LONG) 1,
+                                 (PTW32_INTERLOCKED_LONG) 0) != 0)
+    {
+      owner = *(PTW32_INTERLOCKED_VOLATILE DWORD *) &m->ownerTid;
+
+      if (owner == self)
+	{
+	  switch (kind < 0 ? -kind - 1 : kind)
+	    {
+	    case PTHREAD_MUTEX_RECURSIVE:
+	      m->recursive_count++;
+	      return 0;
+	    case PTHREAD_MUTEX_ERRORCHECK:
+	      return EDEADLK;
+	    default:
+	      /* Self-deadlock, as for a private NORMAL mutex. */
+	      break;
+	    }
+	}
+
+      if (tryOnly)
+	{
+	  if (kind >= 0
+	      || !ptw32_pshared_thread_dead (owner)
+	      || (result = ptw32_pshared_mutex_takeover (m, owner, self)) == 0)
+	    {
+	      return EBUSY;
+	    }
+	}
+      else
+	{
+	  while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                                            (PTW32_INTERLOCKED_LONGPTR) &m->lock_idx,
+                                            (PTW32_INTERLOCKED_LONG) -1) != 0)
+	    {
+	      if ((result = ptw32_pshared_mutex_wait (local, self, abstime)) != 0)
+		{
+		  if (result != EOWNERDEAD)
+		    {
+		      return result;
+		    }
+		  break;
+		}
+	    }
+	}
+    }
+
+  m->ownerTid = self;
+  m->recursive_count = 1;
+
+  return result;
+}
+
+int
+ptw32_pshared_mutex_unlock (pthread_mutex_t mx)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_mutex_t * m;
+  int kind;
+
+  if ((local = ptw32_pshared_find (mx, PTW32_PSHARED_MUTEX)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  m = &local->shared->u.mutex;
+  kind = m->kind;
+
+  if (kind != PTHREAD_MUTEX_NORMAL && kind != PTHREAD_MUTEX_ADAPTIVE_NP)
+    {
+      if (m->ownerTid != GetCurrentThreadId ())
+	{
+	  return EPERM;
+	}
+
+      if ((kind < 0 ? -kind - 1 : kind) == PTHREAD_MUTEX_RECURSIVE
+          && --m->recursive_count > 0)
+	{
+	  return 0;
+	}
+
+      if (kind < 0 && m->robustState == PTW32_ROBUST_INCONSISTENT)
+	{
+	  m->robustState = PTW32_ROBUST_NOTRECOVERABLE;
+	}
+    }
+
+  m->ownerTid = 0;
+
+  if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                                 (PTW32_INTERLOCKED_LONGPTR) &m->lock_idx,
+                                 (PTW32_INTERLOCKED_LONG) 0) < 0
+      || (kind < 0 && m->robustState == PTW32_ROBUST_NOTRECOVERABLE))
+    {
+      (void) SetEvent (local->event[0]);
+    }
+
+  return 0;
+}
+
+int
+ptw32_pshared_mutex_consistent (pthread_mutex_t mx)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_mutex_t * m;
+
+  if ((local = ptw32_pshared_find (mx, PTW32_PSHARED_MUTEX)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  m = &local->shared->u.mutex;
+
+  if (m->kind >= 0
+      || m->ownerTid != GetCurrentThreadId ()
+      || m->robustState != PTW32_ROBUST_INCONSISTENT)
+    {
+      return EINVAL;
+    }
+
+  m->robustState = PTW32_ROBUST_CONSISTENT;
+
+  return 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * ptw32_pshared_rwlock.c
+ *
+ * Description:
+ * This translation unit implements process-shared read/write locks.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Process-shared rwlocks prefer writers, like the default process-private
+ * kind: readers wait while a writer holds or waits for the lock. The
+ * counters are kept under a spin guard; readers block on event 0 and
+ * writers on event 1 (see ptw32_pshared_cond.c). Shared rwlock waits
+ * are not cancellation points.
+ */
+
+static void
+ptw32_pshared_rwlock_wake (ptw32_pshared_local_t * local)
+     /*
+      * Must be called holding the rwlock's guard.
+      */
+{
+  ptw32_pshared_rwlock_t * r = &local->shared->u.rwlock;
+
+  if (r->writerTid != 0)
+    {
+      return;
+    }
+
+  if (r->nWaitingWriters > 0)
+    {
+      if (r->nReaders == 0)
+	{
+	  ptw32_pshared_cond_release (&r->writers, local->event[1], PTW32_FALSE);
+	}
+    }
+  else
+    {
+      ptw32_pshared_cond_release (&r->readers, local->event[0], PTW32_TRUE);
+    }
+}
+
+int
+ptw32_pshared_rwlock_init (pthread_rwlock_t * rwlock)
+{
+  ptw32_pshared_local_t * local;
+  int result;
+
+  if ((result = ptw32_pshared_create (PTW32_PSHARED_RWLOCK, &local)) == 0)
+    {
+      *rwlock = (pthread_rwlock_t) PTW32_PSHARED_HANDLE (local->id);
+    }
+
+  return result;
+}
+
+int
+ptw32_pshared_rwlock_destroy (pthread_rwlock_t * rwlock)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_rwlock_t * r;
+  int busy;
+
+  if ((local = ptw32_pshared_find (*rwlock, PTW32_PSHARED_RWLOCK)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  r = &local->shared->u.rwlock;
+
+  ptw32_pshared_guard_acquire (&r->guard);
+  busy = (r->nReaders > 0 || r->writerTid != 0
+          || r->nWaitingWriters > 0 || r->readers.nWaiters > 0);
+  ptw32_pshared_guard_release (&r->guard);
+
+  if (busy)
+    {
+      return EBUSY;
+    }
+
+  *rwlock = NULL;
+  ptw32_pshared_destroy (local);
+
+  return 0;
+}
+
+int
+ptw32_pshared_rwlock_lock (pthread_rwlock_t rwl, int writer, int tryOnly,
+                           const struct timespec * abstime)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_rwlock_t * r;
+  DWORD self = GetCurrentThreadId ();
+  LONG generation;
+  int result = 0;
+
+  if ((local = ptw32_pshared_find (rwl, PTW32_PSHARED_RWLOCK)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  r = &local->shared->u.rwlock;
+
+  ptw32_pshared_guard_acquire (&r->guard);
+
+  if (r->writerTid == self)
+    {
+      result = EDEADLK;
+    }
+  else if (writer)
+    {
+      while (r->nReaders > 0 || r->writerTid != 0)
+	{
+	  if (tryOnly)
+	    {
+	      result = EBUSY;
+	      break;
+	    }
+
+	  r->nWaitingWriters++;
+	  generation = ptw32_pshared_cond_enter (&r->writers);
+	  ptw32_pshared_guard_release (&r->guard);
+
+	  result = ptw32_pshared_cond_block (&r->writers, local->event[1],
+                                             generation, abstime, PTW32_FALSE);
+
+	  ptw32_pshared_guard_acquire (&r->guard);
+	  r->nWaitingWriters--;
+
+	  if (result != 0)
+	    {
+	      /* Readers may have been waiting only because of us. */
+	      ptw32_pshared_rwlock_wake (local);
+	      break;
+	    }
+	}
+
+      if (result == 0)
+	{
+	  r->writerTid = self;
+	}
+    }
+  else
+    {
+      while (r->writerTid != 0 || r->nWaitingWriters > 0)
+	{
+	  if (tryOnly)
+	    {
+	      result = EBUSY;
+	      break;
+	    }
+
+	  generation = ptw32_pshared_cond_enter (&r->readers);
+	  ptw32_pshared_guard_release (&r->guard);
+
+	  result = ptw32_pshared_cond_block (&r->readers, local->event[0],
+                                             generation, abstime, PTW32_FALSE);
+
+	  ptw32_pshared_guard_acquire (&r->guard);
+
+	  if (result != 0)
+	    {
+	      break;
+	    }
+	}
+
+      if (result == 0)
+	{
+	  r->nReaders++;
+	}
+    }
+
+  ptw32_pshared_guard_release (&r->guard);
+
+  return result;
+}
+
+int
+ptw32_pshared_rwlock_unlock (pthread_rwlock_t rwl)
+{
+  ptw32_pshared_local_t * local;
+  ptw32_pshared_rwlock_t * r;
+  int result = 0;
+
+  if ((local = ptw32_pshared_find (rwl, PTW32_PSHARED_RWLOCK)) == NULL)
+    {
+      return EINVAL;
+    }
+
+  r = &local->shared->u.rwlock;
+
+  ptw32_pshared_guard_acquire (&r->guard);
+
+  if (r->writerTid == GetCurrentThreadId ())
+    {
+      r->writerTid = 0;
+    }
+  else if (r->nReaders > 0)
+    {
+      r->nReaders--;
+    }
+  else
+    {
+      result = EPERM;
+    }
+
+  if (result == 0)
+    {
+      ptw32_pshared_rwlock_wake (local);
+    }
+
+  ptw32_pshared_guard_release (&r->guard);
+
+  return result;
+}
@@ -59,8 +59,12 @@
  * ptw32_thread_t contains the original copy of it's pthread_t (ptHandle).
  * Once malloced, a ptw32_thread_t_ struct is not freed until the process exits.
  *
- * The thread reuse stack is a simple LILO stack managed through a singly
- * linked list element in the ptw32_thread_t.
+ * The thread reuse stack is a Win32 interlocked singly linked list (SList)
+ * of ptw32_thread_t, so that pthread_create and thread exit don't serialise
+ * on a lock. The SList header carries a sequence number that protects pops
+ * against the ABA problem, and since the structs are never freed a pop may
+ * safely read a struct that another thread has just taken. The stack is LIFO,
+ * so that the most recently used, and likely cached, struct is reused first.
  *
  * Each time a thread is destroyed, the ptw32_thread_t address is pushed onto the
  * reuse stack after it's ptHandle's reuse counter has been incremented.
@@ -85,30 +89,15 @@ pthread_t
 ptw32_threadReusePop (void)
 {
   pthread_t t = {NULL, 0};
-  ptw32_mcs_local_node_t node;
+  PSLIST_ENTRY e;
 
-  ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
+  e = InterlockedPopEntrySList (&ptw32_threadReuseStack);
 
-  if (PTW32_THREAD_REUSE_EMPTY != ptw32_threadReuseTop)
+  if (NULL != e)
     {
-      ptw32_thread_t * tp;
-
-      tp = ptw32_threadReuseTop;
-
-      ptw32_threadReuseTop = tp->prevReuse;
-
-      if (PTW32_THREAD_REUSE_EMPTY == ptw32_threadReuseTop)
-        {
-          ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
-        }
-
-      tp->prevReuse = PTW32_THREAD_REUSE_EMPTY;
-
-      t = tp->ptHandle;
+      t = CONTAINING_RECORD (e, ptw32_thread_t, reuseEntry)->ptHandle;
     }
 
-  ptw32_mcs_lock_release(&node);
-
   return t;
 }
 
@@ -125,36 +114,31 @@ ptw32_threadReusePush (pthread_t thread)
   pthread_t t;
   ptw32_mcs_local_node_t node;
 
+  /*
+   * Bump the reuse counter first. Routines such as pthread_join and
+   * pthread_kill validate a handle against ptHandle.x under
+   * ptw32_thread_reuse_lock, so once the lock is released here every
+   * copy of the old handle is refused and the struct can be wiped
+   * without holding it. ptHandle itself is never wiped, so that a
+   * stale handle can't match it in the meantime.
+   */
   ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
 
   t = tp->ptHandle;
-  memset(tp, 0, sizeof(ptw32_thread_t));
-
-  /* Must restore the original POSIX handle that we just wiped. */
-  tp->ptHandle = t;
-
-  /* Bump the reuse counter now */
 #if defined(PTW32_THREAD_ID_REUSE_INCREMENT)
-  tp->ptHandle.x += PTW32_THREAD_ID_REUSE_INCREMENT;
+  t.x += PTW32_THREAD_ID_REUSE_INCREMENT;
 #else
-  tp->ptHandle.x++;
+  t.x++;
 #endif
+  tp->ptHandle.x = t.x;
 
-  tp->state = PThreadStateReuse;
-
-  tp->prevReuse = PTW32_THREAD_REUSE_EMPTY;
+  ptw32_mcs_lock_release(&node);
 
-  if (PTW32_THREAD_REUSE_EMPTY != ptw32_threadReuseBottom)
-    {
-      ptw32_threadReuseBottom->prevReuse = tp;
-    }
-  else
-    {
-      ptw32_threadReuseTop = tp;
-    }
+  memset(tp, 0, FIELD_OFFSET(ptw32_thread_t, ptHandle));
+  memset((char *) tp + FIELD_OFFSET(ptw32_thread_t, ptHandle) + sizeof(pthread_t), 0,
+         sizeof(ptw32_thread_t) - FIELD_OFFSET(ptw32_thread_t, ptHandle) - sizeof(pthread_t));
 
-  ptw32_threadReuseBottom = tp;
+  tp->state = PThreadStateReuse;
 
-  ptw32_mcs_lock_release(&node);
+  (void) InterlockedPushEntrySList (&ptw32_threadReuseStack, &tp->reuseEntry);
 }
-
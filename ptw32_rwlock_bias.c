@@ -0,0 +1,285 @@
+/*
+ * ptw32_rwlock_bias.c
+ *
+ * Description:
+ * Reader bias for PTHREAD_RWLOCK_READ_MOSTLY_NP read-write locks.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * PTHREAD_RWLOCK_READ_MOSTLY_NP read-write locks put a reader bias in
+ * front of the regular lock, in the style of BRAVO (Dice and Kogan,
+ * "BRAVO - Biased Locking for Reader-Writer Locks", USENIX ATC 2019).
+ *
+ * While rwl->bias is set a reader claims the slot that its thread
+ * sequence number hashes to, re-checks bias and is done. It touches
+ * only its own cache line; the regular lock is not involved. Unlocking
+ * clears the slot. A reader whose slot is taken, or that finds bias
+ * clear, takes the regular read lock instead.
+ *
+ * A writer first takes the regular write lock, which excludes all slow
+ * readers and other writers. It then clears bias and waits for every
+ * slot to drain. Readers therefore never see bias set while a writer
+ * holds the lock.
+ *
+ * Revocation is expensive, so bias stays off for PTW32_RWLOCK_BIAS_INHIBIT
+ * times as long as the last revocation took. The first slow reader after
+ * that turns it back on. It does so while holding the regular read lock,
+ * so that no writer can be revoking at the same time.
+ */
+
+static LONGLONG
+ptw32_rwlock_bias_now (void)
+{
+  LARGE_INTEGER t;
+
+  (void) QueryPerformanceCounter (&t);
+
+  return t.QuadPart;
+}
+
+static ptw32_rwlock_slot_t *
+ptw32_rwlock_bias_slot (pthread_rwlock_t rwl, ptw32_thread_t * sp)
+{
+  return &rwl->readers[(size_t) sp->seqNumber & (PTW32_RWLOCK_READER_SLOTS - 1)];
+}
+
+int
+ptw32_rwlock_bias_init (pthread_rwlock_t rwl)
+{
+  /*
+   * Allocate one spare slot so that the array can be aligned
+   * to a cache line boundary.
+   */
+  rwl->readersMem = calloc (PTW32_RWLOCK_READER_SLOTS + 1, sizeof (ptw32_rwlock_slot_t));
+
+  if (rwl->readersMem == NULL)
+    {
+      return ENOMEM;
+    }
+
+  rwl->readers = (ptw32_rwlock_slot_t *)
+    (((size_t) rwl->readersMem + sizeof (ptw32_rwlock_slot_t) - 1)
+     & ~(sizeof (ptw32_rwlock_slot_t) - 1));
+  rwl->inhibitUntil = 0;
+  rwl->bias = 1;
+
+  return 0;
+}
+
+/*
+ * Try the reader fast path. Returns PTW32_TRUE if the caller now
+ * holds a read lock.
+ */
+int
+ptw32_rwlock_bias_rdlock (pthread_rwlock_t rwl)
+{
+  ptw32_thread_t * sp;
+  ptw32_rwlock_slot_t * slot;
+
+  if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &rwl->bias == 0)
+    {
+      return PTW32_FALSE;
+    }
+
+  sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp == NULL)
+    {
+      return PTW32_FALSE;
+    }
+
+  slot = ptw32_rwlock_bias_slot (rwl, sp);
+
+  if (slot->owner != NULL
+      || (PVOID) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &slot->owner,
+                                                         (PTW32_INTERLOCKED_PVOID) sp,
+                                                         (PTW32_INTERLOCKED_PVOID) NULL) != NULL)
+    {
+      return PTW32_FALSE;
+    }
+
+  /*
+   * The interlocked claim is a full barrier, so a writer that cleared
+   * bias before we claimed the slot is seen here, and a writer that
+   * clears it after will see the slot taken and wait for it.
+   */
+  if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &rwl->bias != 0)
+    {
+      return PTW32_TRUE;
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &slot->owner,
+                                         (PTW32_INTERLOCKED_PVOID) NULL);
+
+  return PTW32_FALSE;
+}
+
+/*
+ * Release a read lock taken by ptw32_rwlock_bias_rdlock. Returns
+ * PTW32_FALSE if the caller holds no slot, i.e. its read lock is on
+ * the regular lock.
+ */
+int
+ptw32_rwlock_bias_rdunlock (pthread_rwlock_t rwl)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  ptw32_rwlock_slot_t * slot;
+
+  if (sp == NULL)
+    {
+      return PTW32_FALSE;
+    }
+
+  slot = ptw32_rwlock_bias_slot (rwl, sp);
+
+  if (slot->owner != (PVOID) sp)
+    {
+      return PTW32_FALSE;
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &slot->owner,
+                                         (PTW32_INTERLOCKED_PVOID) NULL);
+
+  return PTW32_TRUE;
+}
+
+/*
+ * True if the caller's read lock is on the fast path.
+ */
+int
+ptw32_rwlock_bias_held (pthread_rwlock_t rwl)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+  return sp != NULL && ptw32_rwlock_bias_slot (rwl, sp)->owner == (PVOID) sp;
+}
+
+/*
+ * Called by a reader holding the regular read lock.
+ */
+void
+ptw32_rwlock_bias_rearm (pthread_rwlock_t rwl)
+{
+  if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &rwl->bias == 0
+      && ptw32_rwlock_bias_now () >= rwl->inhibitUntil)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->bias,
+                                              (PTW32_INTERLOCKED_LONG) 1);
+    }
+}
+
+/*
+ * Called by a writer holding the regular write lock. Clears bias and
+ * waits for fast readers to leave. With tryOnly, or once abstime has
+ * passed, gives up instead (EBUSY or ETIMEDOUT) and restores bias; the
+ * caller still holds the regular write lock and must release it.
+ */
+int
+ptw32_rwlock_bias_revoke (pthread_rwlock_t rwl, int tryOnly,
+                          const struct timespec * abstime)
+{
+  LONGLONG start;
+  LONGLONG end;
+  int i;
+  int spins;
+
+  if (*(PTW32_INTERLOCKED_VOLATILE LONG *) &rwl->bias == 0)
+    {
+      return 0;
+    }
+
+  start = ptw32_rwlock_bias_now ();
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->bias,
+                                          (PTW32_INTERLOCKED_LONG) 0);
+
+  for (i = 0; i < PTW32_RWLOCK_READER_SLOTS; i++)
+    {
+      spins = 0;
+
+      while (rwl->readers[i].owner != NULL)
+        {
+          if (tryOnly
+              || (abstime != NULL && spins >= PTW32_MCS_SPIN_COUNT
+                  && ptw32_relmillisecs (abstime) == 0))
+            {
+              (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->bias,
+                                                      (PTW32_INTERLOCKED_LONG) 1);
+              return tryOnly ? EBUSY : ETIMEDOUT;
+            }
+
+          if (spins++ < PTW32_MCS_SPIN_COUNT)
+            {
+              PTW32_SPIN_PAUSE ();
+            }
+          else
+            {
+              Sleep (0);
+            }
+        }
+    }
+
+  end = ptw32_rwlock_bias_now ();
+  rwl->inhibitUntil = end + (end - start) * PTW32_RWLOCK_BIAS_INHIBIT;
+
+  return 0;
+}
+
+/*
+ * True if any fast reader holds the lock.
+ */
+int
+ptw32_rwlock_bias_busy (pthread_rwlock_t rwl)
+{
+  int i;
+
+  for (i = 0; i < PTW32_RWLOCK_READER_SLOTS; i++)
+    {
+      if (rwl->readers[i].owner != NULL)
+        {
+          return PTW32_TRUE;
+        }
+    }
+
+  return PTW32_FALSE;
+}
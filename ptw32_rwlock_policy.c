@@ -0,0 +1,484 @@
+/*
+ * ptw32_rwlock_policy.c
+ *
+ * Description:
+ * Reader/writer preference and phase-fair read-write lock kinds.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Read-write locks of kind PTHREAD_RWLOCK_PREFER_READER_NP,
+ * PTHREAD_RWLOCK_PREFER_WRITER_NP, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP
+ * and PTHREAD_RWLOCK_PHASE_FAIR_NP.
+ *
+ * The state is guarded by mtxPolicy. Waiting readers are never woken to
+ * compete for the lock: whoever decides that they may run counts them
+ * into nReaders, bumps readerPhase and broadcasts cndReaders ("grants"
+ * them). A waiting reader only waits for readerPhase to change, so it
+ * can't be overtaken once granted. Writers wait on cndWriters for the
+ * lock to be free.
+ *
+ * The kinds differ only in when an arriving reader must wait and whom a
+ * departing writer lets in:
+ *
+ *                       reader waits while        writer leaving grants
+ *   PREFER_READER       a writer holds            waiting readers, else a writer
+ *   PREFER_WRITER       (as PREFER_READER)
+ *   PREFER_WRITER_NONRECURSIVE
+ *                       a writer holds or waits   a waiting writer, else readers
+ *   PHASE_FAIR          a writer holds or waits   waiting readers, else a writer
+ *
+ * As in glibc, PREFER_WRITER behaves as PREFER_READER: a thread that
+ * already holds a read lock and asks for another must not wait behind a
+ * writer, and the lock does not track which threads hold it.
+ *
+ * PHASE_FAIR alternates read and write phases (Brandenburg and Anderson,
+ * "Spin-Based Reader-Writer Synchronization for Multiprocessor Real-Time
+ * Systems", 2010). A writer waits for at most the readers that hold the
+ * lock when it arrives plus those that were waiting for the previous
+ * writer; a reader waits for at most one writer.
+ *
+ * A reader upgrading to writer (pthread_rwlock_upgrade_np) counts as a
+ * waiting writer that goes before all others. Only one may be pending:
+ * a second would wait for the first's read lock and vice versa.
+ */
+
+typedef struct
+{
+  pthread_rwlock_t rwl;
+  int writer;
+  unsigned int phase;
+} ptw32_rwlock_policy_wait_t;
+
+static void
+ptw32_rwlock_policy_grant_readers (pthread_rwlock_t rwl)
+{
+  rwl->nReaders += rwl->nWaitingReaders;
+  rwl->nWaitingReaders = 0;
+  rwl->readerPhase++;
+  (void) pthread_cond_broadcast (&rwl->cndReaders);
+}
+
+/*
+ * Called with mtxPolicy held whenever the lock may have become free or
+ * the set of waiting writers has shrunk. Readers wait while a writer
+ * holds the lock or, for some kinds, while one waits. A writer leaving
+ * lets such readers in unless the kind prefers writers; otherwise they
+ * go in only once no writer is waiting.
+ */
+static void
+ptw32_rwlock_policy_wake (pthread_rwlock_t rwl, int writerLeft)
+{
+  if (rwl->writer)
+    {
+      return;
+    }
+
+  if (rwl->nWaitingReaders > 0
+      && (rwl->nWaitingWriters == 0
+          || (writerLeft
+              && rwl->kind != PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP)))
+    {
+      ptw32_rwlock_policy_grant_readers (rwl);
+    }
+  else if (rwl->nReaders == 0 && rwl->nWaitingWriters > 0)
+    {
+      /*
+       * A pending upgrade must not lose its wake-up to a writer that
+       * can't go before it.
+       */
+      if (rwl->upgrading)
+        {
+          (void) pthread_cond_broadcast (&rwl->cndWriters);
+        }
+      else
+        {
+          (void) pthread_cond_signal (&rwl->cndWriters);
+        }
+    }
+}
+
+static int
+ptw32_rwlock_policy_wait (pthread_cond_t * cv, pthread_mutex_t * mx,
+                          const struct timespec * abstime)
+{
+  return (abstime == NULL) ? pthread_cond_wait (cv, mx)
+                           : pthread_cond_timedwait (cv, mx, abstime);
+}
+
+static int
+ptw32_rwlock_policy_reader_may_enter (pthread_rwlock_t rwl)
+{
+  if (rwl->writer)
+    {
+      return PTW32_FALSE;
+    }
+
+  switch (rwl->kind)
+    {
+    case PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP:
+    case PTHREAD_RWLOCK_PHASE_FAIR_NP:
+      return rwl->nWaitingWriters == 0;
+    default:
+      return PTW32_TRUE;
+    }
+}
+
+/*
+ * Cancellation cleanup, and the path taken when a wait fails. Entered
+ * with mtxPolicy held.
+ */
+static void PTW32_CDECL
+ptw32_rwlock_policy_cancelwait (void *arg)
+{
+  ptw32_rwlock_policy_wait_t * w = (ptw32_rwlock_policy_wait_t *) arg;
+  pthread_rwlock_t rwl = w->rwl;
+
+  if (w->writer)
+    {
+      rwl->nWaitingWriters--;
+      ptw32_rwlock_policy_wake (rwl, PTW32_FALSE);
+    }
+  else if (rwl->readerPhase != w->phase)
+    {
+      /* Granted before we could withdraw: give it back. */
+      if (--rwl->nReaders == 0)
+        {
+          ptw32_rwlock_policy_wake (rwl, PTW32_FALSE);
+        }
+    }
+  else
+    {
+      rwl->nWaitingReaders--;
+    }
+
+  (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+}
+
+int
+ptw32_rwlock_policy_init (pthread_rwlock_t rwl)
+{
+  int result;
+
+  rwl->nReaders = 0;
+  rwl->nWaitingReaders = 0;
+  rwl->nWaitingWriters = 0;
+  rwl->writer = 0;
+  rwl->upgrading = 0;
+  rwl->readerPhase = 0;
+
+  if ((result = pthread_mutex_init (&rwl->mtxPolicy, NULL)) != 0)
+    {
+      return result;
+    }
+
+  if ((result = pthread_cond_init (&rwl->cndReaders, NULL)) != 0)
+    {
+      goto FAIL0;
+    }
+
+  if ((result = pthread_cond_init (&rwl->cndWriters, NULL)) != 0)
+    {
+      goto FAIL1;
+    }
+
+  return 0;
+
+FAIL1:
+  (void) pthread_cond_destroy (&rwl->cndReaders);
+
+FAIL0:
+  (void) pthread_mutex_destroy (&rwl->mtxPolicy);
+
+  return result;
+}
+
+/*
+ * Returns EBUSY, leaving the lock intact, if it is held or waited for.
+ */
+int
+ptw32_rwlock_policy_destroy (pthread_rwlock_t rwl)
+{
+  int result;
+
+  if ((result = pthread_mutex_lock (&rwl->mtxPolicy)) != 0)
+    {
+      return result;
+    }
+
+  if (rwl->writer || rwl->nReaders > 0
+      || rwl->nWaitingReaders > 0 || rwl->nWaitingWriters > 0)
+    {
+      (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+      return EBUSY;
+    }
+
+  (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+  (void) pthread_cond_destroy (&rwl->cndWriters);
+  (void) pthread_cond_destroy (&rwl->cndReaders);
+  (void) pthread_mutex_destroy (&rwl->mtxPolicy);
+
+  return 0;
+}
+
+int
+ptw32_rwlock_policy_lock (pthread_rwlock_t rwl, int writer, int tryOnly,
+                          const struct timespec * abstime)
+{
+  int result;
+  ptw32_rwlock_policy_wait_t w;
+
+  if ((result = pthread_mutex_lock (&rwl->mtxPolicy)) != 0)
+    {
+      return result;
+    }
+
+  if (writer ? (!rwl->writer && rwl->nReaders == 0 && !rwl->upgrading)
+             : ptw32_rwlock_policy_reader_may_enter (rwl))
+    {
+      if (writer)
+        {
+          rwl->writer = 1;
+        }
+      else
+        {
+          rwl->nReaders++;
+        }
+      (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+      return 0;
+    }
+
+  if (tryOnly)
+    {
+      (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+      return EBUSY;
+    }
+
+  w.rwl = rwl;
+  w.writer = writer;
+  w.phase = rwl->readerPhase;
+
+  if (writer)
+    {
+      rwl->nWaitingWriters++;
+    }
+  else
+    {
+      rwl->nWaitingReaders++;
+    }
+
+  /*
+   * This routine may be a cancellation point
+   * according to POSIX 1003.1j section 18.1.2.
+   */
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+  pthread_cleanup_push (ptw32_rwlock_policy_cancelwait, (void *) &w);
+
+  if (writer)
+    {
+      while (result == 0
+             && (rwl->writer || rwl->nReaders > 0 || rwl->upgrading))
+        {
+          result = ptw32_rwlock_policy_wait (&rwl->cndWriters, &rwl->mtxPolicy, abstime);
+        }
+
+      if (result == 0)
+        {
+          rwl->nWaitingWriters--;
+          rwl->writer = 1;
+        }
+    }
+  else
+    {
+      while (result == 0 && rwl->readerPhase == w.phase)
+        {
+          result = ptw32_rwlock_policy_wait (&rwl->cndReaders, &rwl->mtxPolicy, abstime);
+        }
+
+      if (rwl->readerPhase != w.phase)
+        {
+          /* Granted, even if the wait also timed out. */
+          result = 0;
+        }
+    }
+
+  pthread_cleanup_pop (0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+  if (result != 0)
+    {
+      ptw32_rwlock_policy_cancelwait ((void *) &w);
+    }
+  else
+    {
+      (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+    }
+
+  return result;
+}
+
+int
+ptw32_rwlock_policy_unlock (pthread_rwlock_t rwl)
+{
+  int result;
+
+  if ((result = pthread_mutex_lock (&rwl->mtxPolicy)) != 0)
+    {
+      return result;
+    }
+
+  if (rwl->writer)
+    {
+      rwl->writer = 0;
+      ptw32_rwlock_policy_wake (rwl, PTW32_TRUE);
+    }
+  else if (rwl->nReaders > 0)
+    {
+      if (--rwl->nReaders == 0)
+        {
+          ptw32_rwlock_policy_wake (rwl, PTW32_FALSE);
+        }
+    }
+  else
+    {
+      result = EPERM;
+    }
+
+  (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+
+  return result;
+}
+
+/*
+ * The caller holds a read lock. Not a cancellation point: the caller
+ * must keep holding a lock of some kind.
+ */
+int
+ptw32_rwlock_policy_upgrade (pthread_rwlock_t rwl, int tryOnly)
+{
+  int result;
+  int oldState;
+
+  if ((result = pthread_mutex_lock (&rwl->mtxPolicy)) != 0)
+    {
+      return result;
+    }
+
+  if (rwl->writer || rwl->nReaders == 0)
+    {
+      result = EPERM;
+    }
+  else if (rwl->nReaders == 1 && !rwl->upgrading)
+    {
+      rwl->nReaders = 0;
+      rwl->writer = 1;
+    }
+  else if (tryOnly)
+    {
+      result = EBUSY;
+    }
+  else if (rwl->upgrading)
+    {
+      result = EDEADLK;
+    }
+  else
+    {
+      rwl->upgrading = 1;
+      rwl->nWaitingWriters++;
+      rwl->nReaders--;
+
+      (void) pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, &oldState);
+      while (result == 0 && rwl->nReaders > 0)
+        {
+          result = pthread_cond_wait (&rwl->cndWriters, &rwl->mtxPolicy);
+        }
+      (void) pthread_setcancelstate (oldState, NULL);
+
+      rwl->upgrading = 0;
+      rwl->nWaitingWriters--;
+
+      if (result == 0)
+        {
+          rwl->writer = 1;
+        }
+      else
+        {
+          /* Still a reader. */
+          rwl->nReaders++;
+        }
+    }
+
+  (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+
+  return result;
+}
+
+int
+ptw32_rwlock_policy_downgrade (pthread_rwlock_t rwl)
+{
+  int result;
+
+  if ((result = pthread_mutex_lock (&rwl->mtxPolicy)) != 0)
+    {
+      return result;
+    }
+
+  if (!rwl->writer)
+    {
+      result = EPERM;
+    }
+  else
+    {
+      rwl->writer = 0;
+      rwl->nReaders = 1;
+      /* Waiting readers may join us as if the writer had left. */
+      ptw32_rwlock_policy_wake (rwl, PTW32_TRUE);
+    }
+
+  (void) pthread_mutex_unlock (&rwl->mtxPolicy);
+
+  return result;
+}
@@ -0,0 +1,231 @@
+/*
+ * ptw32_rwlock_upgrade.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Upgrade the caller's read lock to a write lock without letting any
+ * other writer in between. Shared by pthread_rwlock_upgrade_np and
+ * pthread_rwlock_tryupgrade_np.
+ *
+ * The default (and READ_MOSTLY) algorithm: a writer holds
+ * mtxExclusiveAccess from the moment it arrives, and while it waits for
+ * readers to finish nCompletedSharedAccessCount is negative. An upgrade
+ * takes mtxExclusiveAccess, hands its own read lock back as a completed
+ * access and then waits for the remaining readers exactly as
+ * pthread_rwlock_wrlock does. If a writer (or another upgrade) already
+ * holds mtxExclusiveAccess it is waiting for our read lock, so we fail
+ * with EDEADLK and the caller keeps its read lock.
+ *
+ * A READ_MOSTLY writer waiting for a fast reader's slot doesn't make
+ * nCompletedSharedAccessCount negative: it spins in
+ * ptw32_rwlock_bias_revoke holding mtxSharedAccessCompleted. So a
+ * caller whose read lock is on the fast path only tries that mutex,
+ * and takes finding it busy as a writer waiting for us.
+ */
+int
+ptw32_rwlock_upgrade (pthread_rwlock_t * rwlock, int tryOnly)
+{
+#if !defined(PTW32_SRW)
+  int result;
+  int oldState;
+  int writerWaiting;
+  int fast = PTW32_FALSE;
+#endif
+  pthread_rwlock_t rwl;
+
+  if (rwlock == NULL || *rwlock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*rwlock == PTHREAD_RWLOCK_INITIALIZER)
+    {
+      /* Never locked, so the caller can't hold it. */
+      return EPERM;
+    }
+
+  rwl = *rwlock;
+
+  if (PTW32_PSHARED_IS_HANDLE(rwl))
+    {
+      return ENOTSUP;
+    }
+
+  if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_RWLOCK_IS_POLICY (rwl))
+    {
+      return ptw32_rwlock_policy_upgrade (rwl, tryOnly);
+    }
+
+#if defined(PTW32_SRW)
+  /* SRW locks can't be converted between shared and exclusive. */
+  return ENOTSUP;
+#else
+  /*
+   * A transient holder of mtxExclusiveAccess (a reader on its way in)
+   * is waited out; a writer holding it is waiting for us.
+   */
+  while ((result = pthread_mutex_trylock (&(rwl->mtxExclusiveAccess))) != 0)
+    {
+      if (result != EBUSY || tryOnly)
+	{
+	  return result;
+	}
+
+      if (rwl->readers != NULL && ptw32_rwlock_bias_held (rwl))
+	{
+	  if (pthread_mutex_trylock (&(rwl->mtxSharedAccessCompleted)) != 0)
+	    {
+	      return EDEADLK;
+	    }
+	}
+      else if ((result = pthread_mutex_lock (&(rwl->mtxSharedAccessCompleted))) != 0)
+	{
+	  return result;
+	}
+      writerWaiting = (rwl->nCompletedSharedAccessCount < 0);
+      (void) pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+
+      if (writerWaiting)
+	{
+	  return EDEADLK;
+	}
+
+      Sleep (0);
+    }
+
+  if ((result = pthread_mutex_lock (&(rwl->mtxSharedAccessCompleted))) != 0)
+    {
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+      return result;
+    }
+
+  if (rwl->readers != NULL)
+    {
+      fast = ptw32_rwlock_bias_rdunlock (rwl);
+    }
+
+  if (!fast && rwl->nSharedAccessCount - rwl->nCompletedSharedAccessCount <= 0)
+    {
+      /* No reader at all, so not the caller either. */
+      (void) pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+      return EPERM;
+    }
+
+  if (tryOnly
+      && rwl->nSharedAccessCount - rwl->nCompletedSharedAccessCount != (fast ? 0 : 1))
+    {
+      /*
+       * Take back the read lock we gave up. No writer can revoke the
+       * bias while we hold mtxExclusiveAccess, but another thread may
+       * have claimed the slot; be a regular reader then.
+       */
+      if (fast && !ptw32_rwlock_bias_rdlock (rwl))
+	{
+	  rwl->nSharedAccessCount++;
+	}
+      (void) pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+      return EBUSY;
+    }
+
+  /*
+   * From here on no writer can get in: we hold mtxExclusiveAccess.
+   */
+  if (!fast)
+    {
+      rwl->nCompletedSharedAccessCount++;
+    }
+
+  if (rwl->nCompletedSharedAccessCount > 0)
+    {
+      rwl->nSharedAccessCount -= rwl->nCompletedSharedAccessCount;
+      rwl->nCompletedSharedAccessCount = 0;
+    }
+
+  if (rwl->nSharedAccessCount > 0)
+    {
+      rwl->nCompletedSharedAccessCount = -rwl->nSharedAccessCount;
+
+      /*
+       * Not a cancellation point: our read lock is already given up.
+       */
+      (void) pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, &oldState);
+      do
+	{
+	  result = pthread_cond_wait (&(rwl->cndSharedAccessCompleted),
+				      &(rwl->mtxSharedAccessCompleted));
+	}
+      while (result == 0 && rwl->nCompletedSharedAccessCount < 0);
+      (void) pthread_setcancelstate (oldState, NULL);
+
+      if (result != 0)
+	{
+	  ptw32_rwlock_cancelwrwait ((void *) rwl);
+	  return result;
+	}
+
+      rwl->nSharedAccessCount = 0;
+    }
+
+  rwl->nExclusiveAccessCount++;
+
+  if (rwl->readers != NULL
+      && ptw32_rwlock_bias_revoke (rwl, tryOnly, NULL) != 0)
+    {
+      /* Fast readers remain: go back to being a reader. */
+      (void) pthread_rwlock_downgrade_np (rwlock);
+      return EBUSY;
+    }
+
+  return 0;
+#endif
+}
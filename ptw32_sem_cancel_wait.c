@@ -0,0 +1,125 @@
+/*
+ * ptw32_sem_cancel_wait.c
+ *
+ * Description:
+ * This translation unit implements semaphores.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+int
+ptw32_sem_cancel_wait (sem_t s)
+/*
+ * ------------------------------------------------------
+ * DESCRIPTION
+ *      Called by a thread that decremented the semaphore
+ *      value below zero and then stopped waiting for it,
+ *      because it timed out, was cancelled or could not
+ *      obtain the Win32 object to block on.
+ *
+ *      While the value is still negative there are more
+ *      waiters than posts and we simply withdraw by adding
+ *      our count back. Otherwise a post has already counted
+ *      us as woken and released (or is about to release)
+ *      the Win32 object for us, and we must consume that
+ *      release so that it is not left over for a later
+ *      waiter. In that case the caller decides whether it
+ *      got the semaphore after all (timeout) or must still
+ *      act on the cancellation.
+ *
+ *      A post only counts a waiter as woken after it holds
+ *      the Win32 object, so s->sem is never NULL here in
+ *      that case.
+ *
+ * RESULTS
+ *              PTW32_TRUE      a post was consumed,
+ *              PTW32_FALSE     we withdrew from the semaphore.
+ *
+ * ------------------------------------------------------
+ */
+{
+  LONG v;
+
+  for (;;)
+    {
+      v = *(PTW32_INTERLOCKED_VOLATILE LONG *) s->count;
+
+      if (v >= 0)
+        {
+          break;
+        }
+
+      if ((PTW32_INTERLOCKED_LONG) v == PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                                           (PTW32_INTERLOCKED_LONGPTR) s->count,
+                                           (PTW32_INTERLOCKED_LONG) (v + 1),
+                                           (PTW32_INTERLOCKED_LONG) v))
+        {
+#if defined(NEED_SEM)
+          if (v + 1 > 0)
+            {
+              ptw32_mcs_local_node_t node;
+
+              ptw32_mcs_lock_acquire(&s->lock, &node);
+              s->leftToUnblock = 0;
+              ptw32_mcs_lock_release(&node);
+            }
+#endif
+          return PTW32_FALSE;
+        }
+    }
+
+#if defined(NEED_SEM)
+  /*
+   * The auto-reset event does not count releases, so don't
+   * block waiting for one that may have been merged with another.
+   */
+  if (WaitForSingleObject (s->sem, 0) != WAIT_OBJECT_0)
+    {
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) s->count);
+      return PTW32_FALSE;
+    }
+#else
+  (void) WaitForSingleObject (s->sem, INFINITE);
+#endif
+
+  return PTW32_TRUE;
+}
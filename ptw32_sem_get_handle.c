@@ -0,0 +1,117 @@
+/*
+ * ptw32_sem_get_handle.c
+ *
+ * Description:
+ * This translation unit implements semaphores.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+HANDLE
+ptw32_sem_get_handle (sem_t s)
+/*
+ * ------------------------------------------------------
+ * DESCRIPTION
+ *      Returns the Win32 object that threads blocked on the
+ *      POSIX semaphore wait on, creating it on first use.
+ *
+ *      sem_init() does not create the object because most
+ *      semaphores, including the two inside every condition
+ *      variable, are never waited on while their value is zero.
+ *      The first waiter and the first post that finds a waiter
+ *      may race to create it. Each installs its object with a
+ *      compare-exchange and the loser closes its own copy, so
+ *      both always end up using the same object.
+ *
+ * RESULTS
+ *              The handle, or NULL if it could not be created.
+ *
+ * ------------------------------------------------------
+ */
+{
+  HANDLE h = (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(
+                        (PTW32_INTERLOCKED_PVOID_PTR) &s->sem,
+                        (PTW32_INTERLOCKED_PVOID) 0,
+                        (PTW32_INTERLOCKED_PVOID) 0);
+
+  if (h == NULL)
+    {
+      HANDLE newH;
+
+#if defined(NEED_SEM)
+
+      newH = CreateEvent (NULL,
+          PTW32_FALSE,	/* auto (not manual) reset */
+          PTW32_FALSE,	/* initial state is unset */
+          NULL);
+
+#else /* NEED_SEM */
+
+      newH = CreateSemaphore (NULL,	/* Always NULL */
+          (long) 0,	/* Force threads to wait */
+          (long) SEM_VALUE_MAX,	/* Maximum value */
+          NULL);	/* Name */
+
+#endif /* NEED_SEM */
+
+      if (newH == NULL)
+        {
+          return NULL;
+        }
+
+      h = (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(
+                     (PTW32_INTERLOCKED_PVOID_PTR) &s->sem,
+                     (PTW32_INTERLOCKED_PVOID) newH,
+                     (PTW32_INTERLOCKED_PVOID) 0);
+
+      if (h == NULL)
+        {
+          h = newH;
+        }
+      else
+        {
+          (void) CloseHandle (newH);
+        }
+    }
+
+  return h;
+}
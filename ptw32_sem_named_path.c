@@ -0,0 +1,100 @@
+/*
+ * ptw32_sem_named_path.c
+ *
+ * Description:
+ * This translation unit implements semaphores.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+int
+ptw32_sem_named_path (char * path, const char * name, const char * suffix)
+/*
+ * ------------------------------------------------------
+ * DESCRIPTION
+ *      Builds the Win32 object name for the named semaphore
+ *      'name' in 'path', which must hold at least
+ *      PTW32_SEM_NAME_MAX + 32 characters.
+ *
+ *      The leading '/' of a POSIX name is dropped and may be
+ *      left out. '\' is not allowed in Win32 object names, so
+ *      neither it nor another '/' may follow.
+ *
+ * RESULTS
+ *              0               success,
+ *              EINVAL          'name' is empty or contains '/' or '\',
+ *              ENAMETOOLONG    'name' is longer than PTW32_SEM_NAME_MAX.
+ *
+ * ------------------------------------------------------
+ */
+{
+  size_t len;
+
+  if (name == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*name == '/')
+    {
+      name++;
+    }
+
+  if (*name == '\0' || strpbrk (name, "/\\") != NULL)
+    {
+      return EINVAL;
+    }
+
+  len = strlen (name);
+
+  if (len > PTW32_SEM_NAME_MAX)
+    {
+      return ENAMETOOLONG;
+    }
+
+  strcpy (path, "pthreads4w-sem-");
+  strcat (path, name);
+  strcat (path, suffix);
+
+  return 0;
+}
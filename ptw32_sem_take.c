@@ -0,0 +1,91 @@
+/*
+ * -------------------------------------------------------------
+ *
+ * Module: ptw32_sem_take.c
+ *
+ * Purpose:
+ *	Semaphores aren't actually part of the PThreads standard.
+ *	They are defined by the POSIX Standard:
+ *
+ *		POSIX 1003.1b-1993	(POSIX.1b)
+ *
+ * -------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+int
+ptw32_sem_take (sem_t s, int max)
+/*
+ * ------------------------------------------------------
+ * DESCRIPTION
+ *      Takes up to 'max' units from the semaphore in one
+ *      compare-exchange, without ever waiting.
+ *
+ * RESULTS
+ *              the number of units taken; 0 if the value was
+ *              not positive.
+ *
+ * ------------------------------------------------------
+ */
+{
+  LONG v;
+  LONG n;
+
+  do
+    {
+      v = *(PTW32_INTERLOCKED_VOLATILE LONG *) s->count;
+
+      if (v <= 0)
+        {
+          return 0;
+        }
+
+      n = (v < (LONG) max) ? v : (LONG) max;
+    }
+  while ((PTW32_INTERLOCKED_LONG) v != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                                          (PTW32_INTERLOCKED_LONGPTR) s->count,
+                                          (PTW32_INTERLOCKED_LONG) (v - n),
+                                          (PTW32_INTERLOCKED_LONG) v));
+
+  return (int) n;
+}
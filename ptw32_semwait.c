@@ -66,6 +66,7 @@ ptw32_semwait (sem_t * sem)
  *              -1              failed, error in errno.
  * ERRNO
  *              EINVAL          'sem' is not a valid semaphore,
+ *              ENOSPC          a required resource has been exhausted,
  *              ENOSYS          semaphores are not supported,
  *              EINTR           the function was interrupted by a signal,
  *              EDEADLK         a deadlock condition was detected.
@@ -73,21 +74,19 @@ ptw32_semwait (sem_t * sem)
  * ------------------------------------------------------
  */
 {
-  ptw32_mcs_local_node_t node;
-  int v;
   int result = 0;
   sem_t s = *sem;
 
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-  v = --s->value;
-  ptw32_mcs_lock_release(&node);
-
-  if (v < 0)
+  if (PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) s->count) < 0)
     {
       /* Must wait */
-      if (WaitForSingleObject (s->sem, INFINITE) == WAIT_OBJECT_0)
+      HANDLE h = ptw32_sem_get_handle (s);
+
+      if (h != NULL && WaitForSingleObject (h, INFINITE) == WAIT_OBJECT_0)
         {
 #if defined(NEED_SEM)
+          ptw32_mcs_local_node_t node;
+
           ptw32_mcs_lock_acquire(&s->lock, &node);
           if (s->leftToUnblock > 0)
             {
@@ -98,6 +97,19 @@ ptw32_semwait (sem_t * sem)
 #endif
 return 0;
         }
+
+      if (h == NULL)
+        {
+          /*
+           * The Win32 semaphore could not be created. Indicate we're no
+           * longer waiting unless a post has created it and released us
+           * in the meantime.
+           */
+          if (!ptw32_sem_cancel_wait (s))
+            {
+              result = ENOSPC;
+            }
+        }
     }
   else
     {
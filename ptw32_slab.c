@@ -0,0 +1,288 @@
+/*
+ * ptw32_slab.c
+ *
+ * Description:
+ * This translation unit implements the slab allocator used for the library's small fixed-size objects.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * How it works:
+ * Object sizes are rounded up to a size class, a power of two from
+ * PTW32_CACHE_LINE_SIZE bytes to PTW32_CACHE_LINE_SIZE << (PTW32_SLAB_CLASSES - 1).
+ * Objects of a class are carved from cache line aligned chunks, so each
+ * object starts on a cache line of its own and hot locks never share one
+ * with a neighbouring allocation.
+ *
+ * Free objects of a class sit either in a thread's magazine, a small
+ * array in compiler thread-local storage that only that thread touches,
+ * or in the class depot, a Win32 interlocked SList shared by all threads.
+ * A free object's first bytes hold its SLIST_ENTRY while in the depot.
+ *
+ * Allocation takes from the calling thread's magazine, then the depot,
+ * then a new chunk. Freeing returns to the calling thread's magazine
+ * until it is full, then to the depot. A thread's magazines are emptied
+ * into the depots at thread detach.
+ *
+ * Chunks are never freed while the library is attached. This is what
+ * lets an SList pop safely read a free object that another thread has
+ * just popped and reused. Each chunk is linked into ptw32_slabChunks,
+ * and ptw32_processTerminate frees those of every class that has no
+ * objects outstanding (ptw32_slabOutstanding), so a DLL that is loaded
+ * and unloaded repeatedly doesn't leak them. Objects the application
+ * never destroyed keep their class's chunks alive. Freeing a class's
+ * chunks bumps its ptw32_slabGeneration, and a magazine filled under
+ * an older generation, such as one left in another thread's TLS, is
+ * emptied before it is used again.
+ *
+ * Without compiler thread-local storage (see PTW32_SELF_TLS) there are no
+ * magazines and every allocation goes to the depot.
+ */
+
+static INLINE int
+ptw32_slab_class (size_t size)
+{
+  int c = 0;
+
+  while (((size_t) PTW32_CACHE_LINE_SIZE << c) < size)
+    {
+      c++;
+    }
+
+  return c;
+}
+
+#if defined(PTW32_SELF_TLS)
+/*
+ * The calling thread's magazine for class 'c', emptied first if its
+ * rounds point into chunks that have since been freed.
+ */
+static INLINE ptw32_slab_magazine_t *
+ptw32_slab_magazine (int c)
+{
+  ptw32_slab_magazine_t * m = &ptw32_slabMagazine[c];
+
+  if (m->gen != ptw32_slabGeneration[c])
+    {
+      m->gen = ptw32_slabGeneration[c];
+      m->rounds = 0;
+    }
+
+  return m;
+}
+#endif
+
+static void
+ptw32_slab_release (int c, void * p)
+{
+#if defined(PTW32_SELF_TLS)
+  ptw32_slab_magazine_t * m = ptw32_slab_magazine (c);
+
+  if (m->rounds < PTW32_SLAB_MAGAZINE_ROUNDS)
+    {
+      m->round[m->rounds++] = p;
+      return;
+    }
+#endif
+
+  (void) InterlockedPushEntrySList (&ptw32_slabDepot[c], (PSLIST_ENTRY) p);
+}
+
+/*
+ * Carve a new chunk for class 'c'. Returns the first object and
+ * releases the rest.
+ */
+static void *
+ptw32_slab_grow (int c)
+{
+  size_t size = (size_t) PTW32_CACHE_LINE_SIZE << c;
+  ptw32_slab_chunk_t * header;
+  char * mem;
+  char * chunk;
+  char * p;
+
+  if ((mem = (char *) malloc (sizeof (*header) + PTW32_SLAB_CHUNK_SIZE
+                              + PTW32_CACHE_LINE_SIZE)) == NULL)
+    {
+      return NULL;
+    }
+
+  chunk = (char *) (((size_t) mem + sizeof (*header) + PTW32_CACHE_LINE_SIZE - 1)
+                    & ~(size_t) (PTW32_CACHE_LINE_SIZE - 1));
+
+  header = (ptw32_slab_chunk_t *) chunk - 1;
+  header->mem = mem;
+  header->c = c;
+  do
+    {
+      header->next = ptw32_slabChunks;
+    }
+  while ((ptw32_slab_chunk_t *) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &ptw32_slabChunks,
+                                                                        (PTW32_INTERLOCKED_PVOID) header,
+                                                                        (PTW32_INTERLOCKED_PVOID) header->next)
+         != header->next);
+
+  for (p = chunk + size; p + size <= chunk + PTW32_SLAB_CHUNK_SIZE; p += size)
+    {
+      ptw32_slab_release (c, p);
+    }
+
+  return chunk;
+}
+
+/*
+ * Allocate a zeroed object of 'size' bytes, like calloc (1, size).
+ * Must be freed with ptw32_slab_free and the same size. Sizes beyond
+ * the largest class are passed to the heap.
+ */
+void *
+ptw32_slab_calloc (size_t size)
+{
+  int c = ptw32_slab_class (size);
+  void * p = NULL;
+
+  if (c >= PTW32_SLAB_CLASSES)
+    {
+      return calloc (1, size);
+    }
+
+#if defined(PTW32_SELF_TLS)
+  {
+    ptw32_slab_magazine_t * m = ptw32_slab_magazine (c);
+
+    if (m->rounds > 0)
+      {
+        p = m->round[--m->rounds];
+      }
+  }
+#endif
+
+  if (p == NULL
+      && (p = InterlockedPopEntrySList (&ptw32_slabDepot[c])) == NULL
+      && (p = ptw32_slab_grow (c)) == NULL)
+    {
+      return NULL;
+    }
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_slabOutstanding[c]);
+  memset (p, 0, size);
+
+  return p;
+}
+
+void
+ptw32_slab_free (void * p, size_t size)
+{
+  int c;
+
+  if (p == NULL)
+    {
+      return;
+    }
+
+  if ((c = ptw32_slab_class (size)) >= PTW32_SLAB_CLASSES)
+    {
+      free (p);
+      return;
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_slabOutstanding[c]);
+  ptw32_slab_release (c, p);
+}
+
+/*
+ * Return the calling thread's magazines to the depots.
+ */
+void
+ptw32_slab_flush (void)
+{
+#if defined(PTW32_SELF_TLS)
+  int c;
+
+  for (c = 0; c < PTW32_SLAB_CLASSES; c++)
+    {
+      ptw32_slab_magazine_t * m = ptw32_slab_magazine (c);
+
+      while (m->rounds > 0)
+        {
+          (void) InterlockedPushEntrySList (&ptw32_slabDepot[c],
+                                            (PSLIST_ENTRY) m->round[--m->rounds]);
+        }
+    }
+#endif
+}
+
+/*
+ * Free the chunks of every class with no objects outstanding, at
+ * process detach when no other thread is using the library. Such a
+ * class's depot is emptied and its generation bumped, since both the
+ * depot and any thread's magazine may point into the chunks.
+ */
+void
+ptw32_slab_destroy (void)
+{
+  ptw32_slab_chunk_t * chunk;
+  ptw32_slab_chunk_t ** link = &ptw32_slabChunks;
+  int c;
+
+  for (c = 0; c < PTW32_SLAB_CLASSES; c++)
+    {
+      if (ptw32_slabOutstanding[c] == 0)
+        {
+          (void) InterlockedFlushSList (&ptw32_slabDepot[c]);
+          (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_slabGeneration[c]);
+        }
+    }
+
+  while ((chunk = *link) != NULL)
+    {
+      if (ptw32_slabOutstanding[chunk->c] == 0)
+        {
+          *link = chunk->next;
+          free (chunk->mem);
+        }
+      else
+        {
+          link = &chunk->next;
+        }
+    }
+}
@@ -0,0 +1,481 @@
+/*
+ * ptw32_srw.c
+ *
+ * Description:
+ * Slim reader/writer lock and native condition variable backend (PTW32_SRW builds).
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_SRW)
+
+/*
+ * In PTW32_SRW builds non-robust mutexes are an SRWLOCK plus the
+ * ownership fields of pthread_mutex_t_, read-write locks are an SRWLOCK,
+ * and condition variables waited on with such a mutex sleep in a native
+ * CONDITION_VARIABLE. None of them own a kernel object. The OS does
+ * the spinning and parking.
+ *
+ * The mutex lock_idx is held at -1 so that the inline fast paths in
+ * pthread.h (PTW32_MUTEX_INLINE_NP) always defer to the library.
+ *
+ * recursive_count doubles as the "locked" flag of NORMAL and ADAPTIVE
+ * mutexes so that unlocking an unlocked mutex still fails with EPERM
+ * instead of raising STATUS_RESOURCE_NOT_OWNED.
+ */
+
+
+/*
+ * SRW locks have no timed acquire. A timed acquirer counts itself in
+ * timed->waiters, then tries the lock and sleeps on timed->cv until
+ * the lock is ours or abstime has passed. It holds timed->guard from
+ * the try until it is asleep, and an unlock that sees waiters takes
+ * the guard before waking them, so the wake-up can't be lost between
+ * the two. Every release of the lock, including the one in a
+ * condition variable wait, is followed by ptw32_srw_timed_release.
+ */
+void
+ptw32_srw_timed_init (ptw32_srw_timed_t * timed)
+{
+  InitializeSRWLock (&timed->guard);
+  InitializeConditionVariable (&timed->cv);
+  timed->waiters = 0;
+}
+
+static int
+ptw32_srw_try (PSRWLOCK srw, int exclusive)
+{
+  return exclusive ? TryAcquireSRWLockExclusive (srw) : TryAcquireSRWLockShared (srw);
+}
+
+static int
+ptw32_srw_timed_acquire (PSRWLOCK srw, ptw32_srw_timed_t * timed, int exclusive,
+                         const struct timespec * abstime)
+{
+  int result = 0;
+  DWORD timeout;
+
+  if (ptw32_srw_try (srw, exclusive))
+    {
+      return 0;
+    }
+
+  AcquireSRWLockExclusive (&timed->guard);
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &timed->waiters);
+
+  while (!ptw32_srw_try (srw, exclusive))
+    {
+      if ((timeout = ptw32_relmillisecs (abstime)) == 0)
+        {
+          result = ETIMEDOUT;
+          break;
+        }
+
+      (void) SleepConditionVariableSRW (&timed->cv, &timed->guard, timeout, 0);
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &timed->waiters);
+  ReleaseSRWLockExclusive (&timed->guard);
+
+  return result;
+}
+
+/*
+ * Called after releasing the lock that 'timed' belongs to.
+ */
+static void
+ptw32_srw_timed_release (ptw32_srw_timed_t * timed)
+{
+  /*
+   * Order the release before reading waiters. The acquirer's increment
+   * is interlocked and comes before its try, so either it sees the lock
+   * free or we see it waiting.
+   */
+  MemoryBarrier ();
+
+  if (timed->waiters != 0)
+    {
+      AcquireSRWLockExclusive (&timed->guard);
+      ReleaseSRWLockExclusive (&timed->guard);
+      WakeAllConditionVariable (&timed->cv);
+    }
+}
+
+int
+ptw32_srw_mutex_lock (pthread_mutex_t mx, const struct timespec * abstime)
+     /*
+      * Lock a non-robust mutex, waiting at most until abstime
+      * unless it is NULL.
+      */
+{
+  int kind = mx->kind;
+  pthread_t self;
+
+  if (kind == PTHREAD_MUTEX_NORMAL || kind == PTHREAD_MUTEX_ADAPTIVE_NP)
+    {
+      if (abstime == NULL)
+        {
+          AcquireSRWLockExclusive (&mx->srw);
+        }
+      else if (ptw32_srw_timed_acquire (&mx->srw, &mx->srwTimed, PTW32_TRUE, abstime) != 0)
+        {
+          return ETIMEDOUT;
+        }
+      mx->recursive_count = 1;
+      return 0;
+    }
+
+  self = pthread_self ();
+
+  if (pthread_equal (mx->ownerThread, self))
+    {
+      if (kind == PTHREAD_MUTEX_RECURSIVE)
+        {
+          mx->recursive_count++;
+          return 0;
+        }
+      return EDEADLK;
+    }
+
+  if (abstime == NULL)
+    {
+      AcquireSRWLockExclusive (&mx->srw);
+    }
+  else if (ptw32_srw_timed_acquire (&mx->srw, &mx->srwTimed, PTW32_TRUE, abstime) != 0)
+    {
+      return ETIMEDOUT;
+    }
+
+  mx->recursive_count = 1;
+  mx->ownerThread = self;
+
+  return 0;
+}
+
+int
+ptw32_srw_mutex_trylock (pthread_mutex_t mx)
+{
+  int kind = mx->kind;
+  pthread_t self;
+
+  if (kind == PTHREAD_MUTEX_NORMAL || kind == PTHREAD_MUTEX_ADAPTIVE_NP)
+    {
+      if (!TryAcquireSRWLockExclusive (&mx->srw))
+        {
+          return EBUSY;
+        }
+      mx->recursive_count = 1;
+      return 0;
+    }
+
+  self = pthread_self ();
+
+  if (pthread_equal (mx->ownerThread, self))
+    {
+      if (kind == PTHREAD_MUTEX_RECURSIVE)
+        {
+          mx->recursive_count++;
+          return 0;
+        }
+      return EBUSY;
+    }
+
+  if (!TryAcquireSRWLockExclusive (&mx->srw))
+    {
+      return EBUSY;
+    }
+
+  mx->recursive_count = 1;
+  mx->ownerThread = self;
+
+  return 0;
+}
+
+int
+ptw32_srw_mutex_unlock (pthread_mutex_t mx)
+{
+  int kind = mx->kind;
+
+  if (kind == PTHREAD_MUTEX_NORMAL || kind == PTHREAD_MUTEX_ADAPTIVE_NP)
+    {
+      if (mx->recursive_count == 0)
+        {
+          return EPERM;
+        }
+    }
+  else
+    {
+      if (!pthread_equal (mx->ownerThread, pthread_self ()))
+        {
+          return EPERM;
+        }
+      if (kind == PTHREAD_MUTEX_RECURSIVE && --mx->recursive_count > 0)
+        {
+          return 0;
+        }
+      mx->ownerThread.p = NULL;
+    }
+
+  mx->recursive_count = 0;
+  ReleaseSRWLockExclusive (&mx->srw);
+  ptw32_srw_timed_release (&mx->srwTimed);
+
+  return 0;
+}
+
+int
+ptw32_srw_cond_wait (pthread_cond_t cv, pthread_mutex_t mx,
+                     const struct timespec * abstime)
+     /*
+      * Wait on cv's native condition variable with a non-robust
+      * mutex that the caller holds.
+      *
+      * The waiter holds cv->srwGuard shared from before it releases
+      * the mutex until it is asleep, and every wake-up takes the
+      * guard exclusively first (ptw32_srw_cond_wake). The mutex is
+      * released explicitly, rather than by SleepConditionVariableSRW,
+      * so that its timed acquirers are woken.
+      *
+      * A native wait can't be alerted, so a thread that blocks here
+      * registers cv in its srwCond under its stateLock, and
+      * pthread_cancel wakes every waiter on that cv when it sets the
+      * thread's cancellation pending. The others see a spurious
+      * wake-up. As with the generic implementation, the mutex is
+      * re-acquired before a cancellation is acted on.
+      */
+{
+  pthread_t self = pthread_self ();
+  ptw32_thread_t * sp = (ptw32_thread_t *) self.p;
+  ptw32_mcs_local_node_t stateLock;
+  int kind = mx->kind;
+  int recursiveCount;
+  DWORD timeout;
+  int result = 0;
+
+  if ((kind == PTHREAD_MUTEX_NORMAL || kind == PTHREAD_MUTEX_ADAPTIVE_NP)
+      ? mx->recursive_count == 0
+      : !pthread_equal (mx->ownerThread, self))
+    {
+      return EPERM;
+    }
+
+  /* Act on a cancellation that is already pending. */
+  pthread_testcancel ();
+
+  AcquireSRWLockShared (&cv->srwGuard);
+
+  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+  if (sp->state == PThreadStateCancelPending
+      && sp->cancelState == PTHREAD_CANCEL_ENABLE)
+    {
+      ptw32_mcs_lock_release (&stateLock);
+      ReleaseSRWLockShared (&cv->srwGuard);
+    }
+  else
+    {
+      sp->srwCond = cv;
+      ptw32_mcs_lock_release (&stateLock);
+
+      timeout = (abstime == NULL) ? INFINITE : ptw32_relmillisecs (abstime);
+
+      recursiveCount = mx->recursive_count;
+      mx->recursive_count = 0;
+      mx->ownerThread.p = NULL;
+      ReleaseSRWLockExclusive (&mx->srw);
+      ptw32_srw_timed_release (&mx->srwTimed);
+
+      if (!SleepConditionVariableSRW (&cv->native, &cv->srwGuard, timeout,
+                                      CONDITION_VARIABLE_LOCKMODE_SHARED))
+        {
+          result = (GetLastError () == ERROR_TIMEOUT) ? ETIMEDOUT : EINVAL;
+        }
+
+      /*
+       * Drop the guard before blocking on the mutex; its holder may be
+       * waiting for the guard to signal us.
+       */
+      ReleaseSRWLockShared (&cv->srwGuard);
+      AcquireSRWLockExclusive (&mx->srw);
+
+      mx->recursive_count = recursiveCount;
+      if (kind != PTHREAD_MUTEX_NORMAL && kind != PTHREAD_MUTEX_ADAPTIVE_NP)
+        {
+          mx->ownerThread = self;
+        }
+
+      ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+      sp->srwCond = NULL;
+      ptw32_mcs_lock_release (&stateLock);
+
+      /*
+       * A pthread_cancel that found us registered wakes cv after
+       * releasing our stateLock. Don't let cv be destroyed under it.
+       */
+      while (sp->srwWaking != 0)
+        {
+          Sleep (0);
+        }
+    }
+
+  pthread_testcancel ();
+
+  return result;
+}
+
+void
+ptw32_srw_cond_wake (pthread_cond_t cv, int all)
+     /*
+      * Wake one or all native waiters on cv. A waiter that has
+      * released its mutex but isn't asleep yet still holds
+      * cv->srwGuard shared, so taking the guard first means it is
+      * asleep by the time we wake.
+      */
+{
+  AcquireSRWLockExclusive (&cv->srwGuard);
+  ReleaseSRWLockExclusive (&cv->srwGuard);
+
+  if (all)
+    {
+      WakeAllConditionVariable (&cv->native);
+    }
+  else
+    {
+      WakeConditionVariable (&cv->native);
+    }
+}
+
+/*
+ * The READ_MOSTLY reader bias sits in front of the SRW lock as it does
+ * in front of the generic one. See ptw32_rwlock_bias.c.
+ */
+static int
+ptw32_srw_rwlock_acquired (pthread_rwlock_t rwl, int exclusive, int tryOnly,
+                           const struct timespec * abstime)
+{
+  int result = 0;
+
+  if (rwl->readers == NULL)
+    {
+      return 0;
+    }
+
+  if (!exclusive)
+    {
+      ptw32_rwlock_bias_rearm (rwl);
+    }
+  else if ((result = ptw32_rwlock_bias_revoke (rwl, tryOnly, abstime)) != 0)
+    {
+      rwl->srwExclusive = 0;
+      ReleaseSRWLockExclusive (&rwl->srw);
+      ptw32_srw_timed_release (&rwl->srwTimed);
+    }
+
+  return result;
+}
+
+int
+ptw32_srw_rwlock_lock (pthread_rwlock_t rwl, int exclusive,
+                       const struct timespec * abstime)
+{
+  if (abstime != NULL)
+    {
+      if (ptw32_srw_timed_acquire (&rwl->srw, &rwl->srwTimed, exclusive, abstime) != 0)
+        {
+          return ETIMEDOUT;
+        }
+    }
+  else if (exclusive)
+    {
+      AcquireSRWLockExclusive (&rwl->srw);
+    }
+  else
+    {
+      AcquireSRWLockShared (&rwl->srw);
+    }
+
+  if (exclusive)
+    {
+      rwl->srwExclusive = 1;
+    }
+
+  return ptw32_srw_rwlock_acquired (rwl, exclusive, PTW32_FALSE, abstime);
+}
+
+int
+ptw32_srw_rwlock_trylock (pthread_rwlock_t rwl, int exclusive)
+{
+  if (exclusive)
+    {
+      if (!TryAcquireSRWLockExclusive (&rwl->srw))
+        {
+          return EBUSY;
+        }
+      rwl->srwExclusive = 1;
+    }
+  else if (!TryAcquireSRWLockShared (&rwl->srw))
+    {
+      return EBUSY;
+    }
+
+  return ptw32_srw_rwlock_acquired (rwl, exclusive, PTW32_TRUE, NULL);
+}
+
+int
+ptw32_srw_rwlock_unlock (pthread_rwlock_t rwl)
+{
+  /*
+   * Only the writer can be unlocking while srwExclusive is set.
+   */
+  if (rwl->srwExclusive)
+    {
+      rwl->srwExclusive = 0;
+      ReleaseSRWLockExclusive (&rwl->srw);
+    }
+  else
+    {
+      ReleaseSRWLockShared (&rwl->srw);
+    }
+
+  ptw32_srw_timed_release (&rwl->srwTimed);
+
+  return 0;
+}
+
+#endif /* PTW32_SRW */
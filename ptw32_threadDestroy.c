@@ -60,6 +60,8 @@ ptw32_threadDestroy (pthread_t thread)
       HANDLE threadH = tp->threadH;
 #endif
       HANDLE cancelEvent = tp->cancelEvent;
+      HANDLE condEvent = tp->condEvent;
+      ptw32_tsd_t * tsd = tp->tsd;
 
       /*
        * Thread ID structs are never freed. They're NULLed and reused.
@@ -69,11 +71,18 @@ ptw32_threadDestroy (pthread_t thread)
       ptw32_threadReusePush (thread);
 
       /* Now work on the copies as the `tp` instance has already been nulled. */
+      free (tsd);
+
       if (cancelEvent != NULL)
 	{
 	  CloseHandle (cancelEvent);
 	}
 
+      if (condEvent != NULL)
+	{
+	  CloseHandle (condEvent);
+	}
+
 #if ! defined(__MINGW32__) || defined (__MSVCRT__) || defined (__DMC__)
       /*
        * See documentation for endthread vs endthreadex.
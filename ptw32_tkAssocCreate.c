@@ -60,11 +60,8 @@ ptw32_tkAssocCreate (ptw32_thread_t * sp, pthread_key_t key)
       * at the beginning of this file for further details.
       *
       * Notes:
-      *      1)      New associations are pushed to the beginning of the
-      *              chain so that the internal ptw32_selfThreadKey association
-      *              is always last, thus allowing selfThreadExit to
-      *              be implicitly called last by pthread_exit.
-      *      2)      
+      *      1)      The key must have an index (not ptw32_selfThreadKey)
+      *              and the thread's 'tsd' array must already cover it.
       *
       * Parameters:
       *              thread
@@ -88,7 +85,7 @@ ptw32_tkAssocCreate (ptw32_thread_t * sp, pthread_key_t key)
    * Both key->keyLock and thread->threadLock are locked before
    * entry to this routine.
    */
-  assoc = (ThreadKeyAssoc *) calloc (1, sizeof (*assoc));
+  assoc = (ThreadKeyAssoc *) ptw32_slab_calloc (sizeof (*assoc));
 
   if (assoc == NULL)
     {
@@ -112,13 +109,7 @@ ptw32_tkAssocCreate (ptw32_thread_t * sp, pthread_key_t key)
   /*
    * Register assoc with thread
    */
-  assoc->prevKey = NULL;
-  assoc->nextKey = (ThreadKeyAssoc *) sp->keys;
-  if (assoc->nextKey != NULL)
-    {
-      assoc->nextKey->prevKey = assoc;
-    }
-  sp->keys = (void *) assoc;
+  sp->tsd[key->index].assoc = (void *) assoc;
 
   return (0);
 
@@ -70,31 +70,13 @@ ptw32_tkAssocDestroy (ThreadKeyAssoc * assoc)
   if (assoc != NULL)
     {
       ThreadKeyAssoc * prev, * next;
+      ptw32_thread_t * sp = assoc->thread;
+      LONG index = assoc->key->index;
 
-      /* Remove assoc from thread's keys chain */
-      prev = assoc->prevKey;
-      next = assoc->nextKey;
-      if (prev != NULL)
-	{
-	  prev->nextKey = next;
-	}
-      if (next != NULL)
-	{
-	  next->prevKey = prev;
-	}
-
-      if (assoc->thread->keys == assoc)
-	{
-	  /* We're at the head of the thread's keys chain */
-	  assoc->thread->keys = next;
-	}
-      if (assoc->thread->nextAssoc == assoc)
+      /* Remove assoc from thread's 'tsd' array */
+      if (index < sp->tsdSize && sp->tsd[index].assoc == assoc)
 	{
-	  /*
-	   * Thread is exiting and we're deleting the assoc to be processed next.
-	   * Hand thread the assoc after this one.
-	   */
-	  assoc->thread->nextAssoc = next;
+	  sp->tsd[index].assoc = NULL;
 	}
 
       /* Remove assoc from key's threads chain */
@@ -115,7 +97,7 @@ ptw32_tkAssocDestroy (ThreadKeyAssoc * assoc)
 	  assoc->key->threads = next;
 	}
 
-      free (assoc);
+      ptw32_slab_free (assoc, sizeof (*assoc));
     }
 
 }				/* ptw32_tkAssocDestroy */
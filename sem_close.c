@@ -52,14 +52,77 @@
 #include "semaphore.h"
 #include "implement.h"
 
-/* ignore warning "unreferenced formal parameter" */
-#if defined(_MSC_VER)
-#pragma warning( disable : 4100 )
-#endif
-
 int
 sem_close (sem_t * sem)
+/*
+ * ------------------------------------------------------
+ * DOCPUBLIC
+ *      This function closes a named semaphore.
+ *
+ * PARAMETERS
+ *      sem
+ *              address returned by sem_open
+ *
+ * DESCRIPTION
+ *      Undoes one sem_open of the semaphore in this process.
+ *      After the last one its address is no longer valid and
+ *      the process's Win32 handles to it are closed. Threads
+ *      must not be waiting on it at that point.
+ *
+ * RESULTS
+ *              0               successfully closed semaphore,
+ *              -1              failed, error in errno
+ * ERRNO
+ *              EINVAL          'sem' is not an open named semaphore,
+ *              ENOSYS          named semaphores are not supported
+ *                              (NEED_SEM builds).
+ *
+ * ------------------------------------------------------
+ */
 {
+#if defined(NEED_SEM)
+
   PTW32_SET_ERRNO(ENOSYS);
   return -1;
+
+#else /* NEED_SEM */
+
+  ptw32_sem_named_t * n;
+  ptw32_sem_named_t ** prev;
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_sem_named_lock, &node);
+
+  for (prev = &ptw32_sem_named_list; (n = *prev) != NULL; prev = &n->next)
+    {
+      if (&n->sem == sem)
+        {
+          if (--n->refs == 0)
+            {
+              *prev = n->next;
+            }
+          break;
+        }
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (n == NULL)
+    {
+      PTW32_SET_ERRNO(EINVAL);
+      return -1;
+    }
+
+  if (n->refs == 0)
+    {
+      (void) CloseHandle (n->s.sem);
+      (void) UnmapViewOfFile (n->shared);
+      (void) CloseHandle (n->section);
+      free (n);
+    }
+
+  return 0;
+
+#endif /* NEED_SEM */
+
 }				/* sem_close */
@@ -71,7 +71,7 @@ sem_destroy (sem_t * sem)
  *              0               successfully destroyed semaphore,
  *              -1              failed, error in errno
  * ERRNO
- *              EINVAL          'sem' is not a valid semaphore,
+ *              EINVAL          'sem' is not a valid unnamed semaphore,
  *              ENOSYS          semaphores are not supported,
  *              EBUSY           threads (or processes) are currently
  *                                      blocked on 'sem'
@@ -82,8 +82,9 @@ sem_destroy (sem_t * sem)
   int result = 0;
   sem_t s = NULL;
 
-  if (sem == NULL || *sem == NULL)
+  if (sem == NULL || *sem == NULL || (*sem)->count != &(*sem)->value)
     {
+      /* Named semaphores are closed, not destroyed. */
       result = EINVAL;
     }
   else
@@ -93,7 +94,7 @@ sem_destroy (sem_t * sem)
 
       if ((result = ptw32_mcs_lock_try_acquire(&s->lock, &node)) == 0)
         {
-          if (s->value < 0)
+          if (*(PTW32_INTERLOCKED_VOLATILE LONG *) s->count < 0)
             {
               result = EBUSY;
             }
@@ -104,7 +105,7 @@ sem_destroy (sem_t * sem)
                * however there could be threads about to wait behind us.
                * It is up to the application to ensure this is not the case.
                */
-              if (!CloseHandle (s->sem))
+              if (s->sem != NULL && !CloseHandle (s->sem))
                 {
                   result = EINVAL;
                 }
@@ -119,7 +120,7 @@ sem_destroy (sem_t * sem)
       return -1;
     }
 
-  free (s);
+  ptw32_slab_free (s, sizeof (*s));
 
   return 0;
 
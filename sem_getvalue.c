@@ -85,13 +85,9 @@ sem_getvalue (sem_t * sem, int *sval)
  */
 {
   int result = 0;
-
-  ptw32_mcs_local_node_t node;
   sem_t s = *sem;
 
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-  *sval = s->value;
-  ptw32_mcs_lock_release(&node);
+  *sval = (int) *(PTW32_INTERLOCKED_VOLATILE LONG *) s->count;
 
   if (result != 0)
     {
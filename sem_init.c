@@ -106,7 +106,7 @@ sem_init (sem_t * sem, int pshared, unsigned int value)
     }
   else
     {
-      s = (sem_t) calloc (1, sizeof (*s));
+      s = (sem_t) ptw32_slab_calloc (sizeof (*s));
 
       if (NULL == s)
         {
@@ -115,40 +115,23 @@ sem_init (sem_t * sem, int pshared, unsigned int value)
       else
         {
 
+          s->count = &s->value;
           s->value = value;
           s->lock = NULL;
 
-#if defined(NEED_SEM)
-
-          s->sem = CreateEvent (NULL,
-              PTW32_FALSE,	/* auto (not manual) reset */
-              PTW32_FALSE,	/* initial state is unset */
-              NULL);
-
-          if (0 == s->sem)
-            {
-              result = ENOSPC;
-            }
-          else
-            {
-              s->leftToUnblock = 0;
-            }
-
-#else /* NEED_SEM */
-
-          if ((s->sem = CreateSemaphore (NULL,	/* Always NULL */
-              (long) 0,	/* Force threads to wait */
-              (long) SEM_VALUE_MAX,	/* Maximum value */
-              NULL)) == 0)	/* Name */
-            {
-              result = ENOSPC;
-            }
+          /*
+           * The Win32 object that waiters block on is created when
+           * the first thread has to wait. See ptw32_sem_get_handle.c.
+           */
+          s->sem = NULL;
 
+#if defined(NEED_SEM)
+          s->leftToUnblock = 0;
 #endif /* NEED_SEM */
 
           if (result != 0)
             {
-              free(s);
+              ptw32_slab_free (s, sizeof (*s));
             }
         }
     }
@@ -48,23 +48,247 @@
 # include "config.h"
 #endif
 
+#include <stdarg.h>
+#include <string.h>
+#include <fcntl.h>
 #include "pthread.h"
 #include "semaphore.h"
 #include "implement.h"
 
-/* ignore warning "unreferenced formal parameter" */
-#if defined(_MSC_VER)
-#pragma warning( disable : 4100 )
-#endif
-
 sem_t
 *sem_open (const char *name, int oflag, ...)
+/*
+ * ------------------------------------------------------
+ * DOCPUBLIC
+ *      This function opens a named semaphore, creating it
+ *      if requested.
+ *
+ * PARAMETERS
+ *      name
+ *              the semaphore's name, "/somename"
+ *
+ *      oflag
+ *              0, O_CREAT or O_CREAT | O_EXCL
+ *
+ *      mode, value
+ *              with O_CREAT only: the permissions (ignored;
+ *              the object gets the default Win32 security)
+ *              and the initial value of a new semaphore
+ *
+ * DESCRIPTION
+ *      Every process that opens the same name shares one
+ *      semaphore, and in each process every sem_open of the
+ *      name returns the same address until the matching
+ *      number of sem_close calls.
+ *
+ *      The count lives in a named section, so sem_post and
+ *      sem_wait only need the named Win32 semaphore when the
+ *      count crosses zero, exactly as for unnamed semaphores.
+ *
+ *      Win32 removes a named object when its last handle is
+ *      closed, so the semaphore only exists while some process
+ *      has it open. See also sem_unlink.c.
+ *
+ * RESULTS
+ *              address of the semaphore on success,
+ *              SEM_FAILED      failed, error in errno
+ * ERRNO
+ *              EACCES          the name exists but cannot be opened,
+ *              EAGAIN          O_CREAT was given, and the name was
+ *                              unlinked but is still open somewhere,
+ *              EEXIST          O_CREAT | O_EXCL was given and the
+ *                              semaphore exists,
+ *              EINVAL          'name' is not valid, or 'value' is
+ *                              greater than SEM_VALUE_MAX,
+ *              ENAMETOOLONG    'name' is too long,
+ *              ENOENT          O_CREAT was not given and the
+ *                              semaphore does not exist,
+ *              ENOMEM          out of memory,
+ *              ENOSPC          a required resource has been exhausted,
+ *              ENOSYS          named semaphores are not supported
+ *                              (NEED_SEM builds).
+ *
+ * ------------------------------------------------------
+ */
 {
-  /* Note: this is a POSIX.1b-1993 conforming stub; POSIX.1-2001 removed
-   * the requirement to provide this stub, and also removed the validity
-   * of ENOSYS as a resultant errno state; nevertheless, it makes sense
-   * to retain the POSIX.1b-1993 conforming behaviour here.
-   */
+#if defined(NEED_SEM)
+
   PTW32_SET_ERRNO(ENOSYS);
   return SEM_FAILED;
+
+#else /* NEED_SEM */
+
+  int result = 0;
+  int created = PTW32_FALSE;
+  unsigned int value = 0;
+  char waitPath[PTW32_SEM_NAME_MAX + 32];
+  ptw32_sem_named_t * n = NULL;
+  ptw32_mcs_local_node_t node;
+
+  if (oflag & O_CREAT)
+    {
+      va_list ap;
+
+      va_start (ap, oflag);
+      (void) va_arg (ap, int);
+      value = va_arg (ap, unsigned int);
+      va_end (ap);
+
+      if (value > (unsigned int) SEM_VALUE_MAX)
+        {
+          PTW32_SET_ERRNO(EINVAL);
+          return SEM_FAILED;
+        }
+    }
+
+  if ((result = ptw32_sem_named_path (waitPath, name, "-wait")) != 0)
+    {
+      PTW32_SET_ERRNO(result);
+      return SEM_FAILED;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_sem_named_lock, &node);
+
+  /*
+   * Already open in this process? An unlinked semaphore no longer
+   * answers to its name.
+   */
+  for (n = ptw32_sem_named_list; n != NULL; n = n->next)
+    {
+      if (n->shared->state != PTW32_SEM_NAMED_UNLINKED
+          && strcmp (n->name, waitPath) == 0)
+        {
+          break;
+        }
+    }
+
+  if (n != NULL)
+    {
+      if ((oflag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+        {
+          result = EEXIST;
+        }
+      else
+        {
+          n->refs++;
+        }
+      goto DONE;
+    }
+
+  if ((n = (ptw32_sem_named_t *) calloc (1, sizeof (*n))) == NULL)
+    {
+      result = ENOMEM;
+      goto DONE;
+    }
+
+  strcpy (n->name, waitPath);
+  /* The section's name is the wait object's without "-wait". */
+  waitPath[strlen (waitPath) - 5] = '\0';
+
+  if (oflag & O_CREAT)
+    {
+      n->section = CreateFileMappingA (INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                       0, sizeof (ptw32_sem_named_shared_t), waitPath);
+      created = (n->section != NULL && GetLastError () != ERROR_ALREADY_EXISTS);
+    }
+  else
+    {
+      n->section = OpenFileMappingA (FILE_MAP_ALL_ACCESS, PTW32_FALSE, waitPath);
+    }
+
+  if (n->section == NULL)
+    {
+      result = (GetLastError () == ERROR_FILE_NOT_FOUND) ? ENOENT : EACCES;
+    }
+  else if (!created && (oflag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+    {
+      result = EEXIST;
+    }
+  else if ((n->shared = (ptw32_sem_named_shared_t *)
+                MapViewOfFile (n->section, FILE_MAP_ALL_ACCESS, 0, 0,
+                               sizeof (ptw32_sem_named_shared_t))) == NULL)
+    {
+      result = ENOMEM;
+    }
+  else
+    {
+      if (created)
+        {
+          n->shared->value = (LONG) value;
+        }
+      else
+        {
+          /*
+           * The creator publishes the count before the state.
+           */
+          while (*(PTW32_INTERLOCKED_VOLATILE LONG *) &n->shared->state == 0)
+            {
+              Sleep (0);
+            }
+
+          if (n->shared->state == PTW32_SEM_NAMED_UNLINKED)
+            {
+              result = (oflag & O_CREAT) ? EAGAIN : ENOENT;
+            }
+        }
+
+      if (result == 0)
+        {
+          n->s.sem = CreateSemaphoreA (NULL, 0, (long) SEM_VALUE_MAX, n->name);
+
+          if (n->s.sem == NULL)
+            {
+              result = ENOSPC;
+            }
+        }
+
+      if (created)
+        {
+          /*
+           * If we failed, don't leave later openers waiting for us.
+           */
+          (void) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                   (PTW32_INTERLOCKED_LONGPTR) &n->shared->state,
+                   (PTW32_INTERLOCKED_LONG) (result == 0
+                                             ? PTW32_SEM_NAMED_READY
+                                             : PTW32_SEM_NAMED_UNLINKED));
+        }
+    }
+
+  if (result == 0)
+    {
+      n->s.count = &n->shared->value;
+      n->s.lock = 0;
+      n->sem = &n->s;
+      n->refs = 1;
+      n->next = ptw32_sem_named_list;
+      ptw32_sem_named_list = n;
+    }
+  else
+    {
+      if (n->shared != NULL)
+        {
+          (void) UnmapViewOfFile (n->shared);
+        }
+      if (n->section != NULL)
+        {
+          (void) CloseHandle (n->section);
+        }
+      free (n);
+    }
+
+DONE:
+
+  ptw32_mcs_lock_release (&node);
+
+  if (result != 0)
+    {
+      PTW32_SET_ERRNO(result);
+      return SEM_FAILED;
+    }
+
+  return &n->sem;
+
+#endif /* NEED_SEM */
+
 }				/* sem_open */
@@ -81,34 +81,48 @@ sem_post (sem_t * sem)
  */
 {
   int result = 0;
-
-  ptw32_mcs_local_node_t node;
+  LONG v;
+  HANDLE h = NULL;
   sem_t s = *sem;
 
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-  if (s->value < SEM_VALUE_MAX)
+  /*
+   * Nobody waiting: a single compare-exchange. If there are waiters
+   * get the Win32 object before counting one of them as woken; see
+   * ptw32_sem_cancel_wait.c.
+   */
+  do
     {
-#if defined(NEED_SEM)
-      if (++s->value <= 0
-          && !SetEvent(s->sem))
+      v = *(PTW32_INTERLOCKED_VOLATILE LONG *) s->count;
+
+      if (v >= SEM_VALUE_MAX)
         {
-          s->value--;
-          result = EINVAL;
+          result = ERANGE;
+          goto FAIL;
         }
-#else
-      if (++s->value <= 0
-          && !ReleaseSemaphore (s->sem, 1, NULL))
+      if (v < 0 && h == NULL && (h = ptw32_sem_get_handle (s)) == NULL)
         {
-          s->value--;
           result = EINVAL;
+          goto FAIL;
         }
-#endif /* NEED_SEM */
     }
-  else
+  while ((PTW32_INTERLOCKED_LONG) v != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                                          (PTW32_INTERLOCKED_LONGPTR) s->count,
+                                          (PTW32_INTERLOCKED_LONG) (v + 1),
+                                          (PTW32_INTERLOCKED_LONG) v));
+
+  if (v < 0)
     {
-      result = ERANGE;
+#if defined(NEED_SEM)
+      if (!SetEvent (h))
+#else
+      if (!ReleaseSemaphore (h, 1, NULL))
+#endif /* NEED_SEM */
+        {
+          result = EINVAL;
+        }
     }
-  ptw32_mcs_lock_release(&node);
+
+FAIL:
 
   if (result != 0)
     {
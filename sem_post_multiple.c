@@ -69,8 +69,11 @@ sem_post_multiple (sem_t * sem, int count)
  *
  * DESCRIPTION
  *      This function posts multiple wakeups to a semaphore. If there
- *      are waiting threads (or processes), n <= count are awakened;
- *      the semaphore value is incremented by count - n.
+ *      are waiting threads (or processes), n = min(count, waiters) are
+ *      awakened with a single release of the Win32 semaphore; the
+ *      semaphore value is incremented by count - n. A thread waiting
+ *      in sem_timedwait_multiple_np() counts as one waiter however
+ *      many units it asked for.
  *
  * RESULTS
  *              0               successfully posted semaphore,
@@ -83,47 +86,62 @@ sem_post_multiple (sem_t * sem, int count)
  * ------------------------------------------------------
  */
 {
-  ptw32_mcs_local_node_t node;
   int result = 0;
+  LONG v;
   long waiters;
+  HANDLE h = NULL;
   sem_t s = *sem;
 
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-
-  if (s->value <= (SEM_VALUE_MAX - count))
+  do
     {
-      waiters = -s->value;
-      s->value += count;
-      if (waiters > 0)
+      v = *(PTW32_INTERLOCKED_VOLATILE LONG *) s->count;
+
+      if (v > (SEM_VALUE_MAX - count))
+        {
+          result = ERANGE;
+          goto FAIL;
+        }
+      if (v < 0 && h == NULL && (h = ptw32_sem_get_handle (s)) == NULL)
         {
+          result = EINVAL;
+          goto FAIL;
+        }
+    }
+  while ((PTW32_INTERLOCKED_LONG) v != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                                          (PTW32_INTERLOCKED_LONGPTR) s->count,
+                                          (PTW32_INTERLOCKED_LONG) (v + count),
+                                          (PTW32_INTERLOCKED_LONG) v));
+
+  waiters = -v;
+  if (waiters > 0)
+    {
 #if defined(NEED_SEM)
-          if (SetEvent(s->sem))
+      ptw32_mcs_local_node_t node;
+
+      ptw32_mcs_lock_acquire(&s->lock, &node);
+      if (SetEvent (h))
+        {
+          waiters--;
+          s->leftToUnblock += count - 1;
+          if (s->leftToUnblock > waiters)
             {
-              waiters--;
-              s->leftToUnblock += count - 1;
-              if (s->leftToUnblock > waiters)
-                {
-                  s->leftToUnblock = waiters;
-                }
+              s->leftToUnblock = waiters;
             }
+        }
+      else
+        {
+          result = EINVAL;
+        }
+      ptw32_mcs_lock_release(&node);
 #else
-  if (ReleaseSemaphore (s->sem,  (waiters<=count)?waiters:count, 0))
-    {
-      /* No action */
-    }
-#endif
-  else
-    {
-      s->value -= count;
-      result = EINVAL;
-    }
+      if (!ReleaseSemaphore (h, (waiters <= count) ? waiters : count, 0))
+        {
+          result = EINVAL;
         }
+#endif
     }
-  else
-    {
-      result = ERANGE;
-    }
-  ptw32_mcs_lock_release(&node);
+
+FAIL:
 
   if (result != 0)
     {
@@ -62,41 +62,21 @@ typedef struct {
 static void PTW32_CDECL
 ptw32_sem_timedwait_cleanup (void * args)
 {
-  ptw32_mcs_local_node_t node;
   sem_timedwait_cleanup_args_t * a = (sem_timedwait_cleanup_args_t *)args;
-  sem_t s = a->sem;
 
-  ptw32_mcs_lock_acquire(&s->lock, &node);
   /*
    * We either timed out or were cancelled.
-   * If someone has posted between then and now we try to take the semaphore.
+   * If someone has posted between then and now we take the semaphore.
    * Otherwise the semaphore count may be wrong after we
    * return. In the case of a cancellation, it is as if we
    * were cancelled just before we return (after taking the semaphore)
    * which is ok.
    */
-  if (WaitForSingleObject(s->sem, 0) == WAIT_OBJECT_0)
+  if (ptw32_sem_cancel_wait (a->sem))
     {
       /* We got the semaphore on the second attempt */
       *(a->resultPtr) = 0;
     }
-  else
-    {
-      /* Indicate we're no longer waiting */
-      s->value++;
-#if defined(NEED_SEM)
-      if (s->value > 0)
-        {
-          s->leftToUnblock = 0;
-        }
-#else
-      /*
-       * Don't release the W32 sema, it doesn't need adjustment
-       * because it doesn't record the number of waiters.
-       */
-#endif
-    }
-  ptw32_mcs_lock_release(&node);
 }
 
 
@@ -132,6 +112,7 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
  *              -1              failed, error in errno
  * ERRNO
  *              EINVAL          'sem' is not a valid semaphore,
+ *              ENOSPC          a required resource has been exhausted,
  *              ENOSYS          semaphores are not supported,
  *              EINTR           the function was interrupted by a signal,
  *              EDEADLK         a deadlock condition was detected.
@@ -141,7 +122,6 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
  */
 {
   DWORD milliseconds;
-  int v;
   int result = 0;
   sem_t s = NULL;
 
@@ -153,8 +133,6 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
     }
   else
     {
-      ptw32_mcs_local_node_t node;
-
       s = *sem;
 
   if (abstime == NULL)
@@ -169,16 +147,13 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
       milliseconds = ptw32_relmillisecs (abstime);
     }
 
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-  v = --s->value;
-  ptw32_mcs_lock_release(&node);
-
-  if (v < 0)
+  if (PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) s->count) < 0)
     {
 #if defined(NEED_SEM)
       int timedout;
 #endif
       sem_timedwait_cleanup_args_t cleanup_args;
+      HANDLE h = ptw32_sem_get_handle (s);
 
       cleanup_args.sem = s;
       cleanup_args.resultPtr = &result;
@@ -191,7 +166,7 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
 #if defined(NEED_SEM)
       timedout =
 #endif
-          result = pthreadCancelableTimedWait (s->sem, milliseconds);
+          result = (h == NULL) ? ENOSPC : pthreadCancelableTimedWait (h, milliseconds);
       pthread_cleanup_pop(result);
 #if defined(PTW32_CONFIG_MSVC7)
 #pragma inline_depth()
@@ -201,6 +176,8 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
 
       if (!timedout)
         {
+          ptw32_mcs_local_node_t node;
+
           ptw32_mcs_lock_acquire(&s->lock, &node);
           if (s->leftToUnblock > 0)
             {
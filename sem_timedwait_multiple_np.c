@@ -0,0 +1,137 @@
+/*
+ * -------------------------------------------------------------
+ *
+ * Module: sem_timedwait_multiple_np.c
+ *
+ * Purpose:
+ *	Semaphores aren't actually part of the PThreads standard.
+ *	They are defined by the POSIX Standard:
+ *
+ *		POSIX 1003.1b-1993	(POSIX.1b)
+ *
+ * -------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+int
+sem_timedwait_multiple_np (sem_t * sem, int max, int * got,
+                           const struct timespec * abstime)
+/*
+ * ------------------------------------------------------
+ * DOCPUBLIC
+ *      This function waits on a semaphore possibly until
+ *      'abstime' time, and then takes as many units as are
+ *      available, up to a limit.
+ *
+ * PARAMETERS
+ *      sem
+ *              pointer to an instance of sem_t
+ *
+ *      max
+ *              the most units to take, must be greater than zero.
+ *
+ *      got
+ *              pointer to an int that receives the number of
+ *              units taken.
+ *
+ *      abstime
+ *              pointer to an instance of struct timespec, or NULL
+ *
+ * DESCRIPTION
+ *      If the semaphore value is greater than zero this
+ *      behaves like sem_trywait_multiple_np(). Otherwise the
+ *      calling thread waits for one unit as in sem_timedwait()
+ *      and, once it has it, takes up to max - 1 more of those
+ *      posted in the meantime without waiting again.
+ *
+ *      A waiter that wants several units is therefore only
+ *      woken once and counted once by sem_post_multiple(),
+ *      and never holds units while it waits for more.
+ *
+ *      If 'abstime' is a NULL pointer then this function will
+ *      block until it can successfully decrease the value.
+ *
+ *      This function is a cancellation point.
+ *
+ * RESULTS
+ *              0               successfully decreased semaphore,
+ *              -1              failed, error in errno
+ * ERRNO
+ *              EINVAL          'sem' is not a valid semaphore, or
+ *                              'max' is less than or equal to zero,
+ *              ENOSPC          a required resource has been exhausted,
+ *              ETIMEDOUT       abstime elapsed before success.
+ *
+ * ------------------------------------------------------
+ */
+{
+  int n;
+
+  if (sem == NULL || *sem == NULL || max <= 0 || got == NULL)
+    {
+      PTW32_SET_ERRNO(EINVAL);
+      return -1;
+    }
+
+  pthread_testcancel();
+
+  if ((n = ptw32_sem_take (*sem, max)) == 0)
+    {
+      if (sem_timedwait (sem, abstime) != 0)
+        {
+          return -1;
+        }
+
+      n = 1;
+
+      if (max > 1)
+        {
+          n += ptw32_sem_take (*sem, max - 1);
+        }
+    }
+
+  *got = n;
+
+  return 0;
+
+}				/* sem_timedwait_multiple_np */
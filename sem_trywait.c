@@ -84,21 +84,23 @@ sem_trywait (sem_t * sem)
  */
 {
   int result = 0;
+  LONG v;
   sem_t s = *sem;
-  ptw32_mcs_local_node_t node;
 
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-
-  if (s->value > 0)
-    {
-      s->value--;
-    }
-  else
+  do
     {
-      result = EAGAIN;
-    }
+      v = *(PTW32_INTERLOCKED_VOLATILE LONG *) s->count;
 
-  ptw32_mcs_lock_release(&node);
+      if (v <= 0)
+        {
+          result = EAGAIN;
+          break;
+        }
+    }
+  while ((PTW32_INTERLOCKED_LONG) v != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                                          (PTW32_INTERLOCKED_LONGPTR) s->count,
+                                          (PTW32_INTERLOCKED_LONG) (v - 1),
+                                          (PTW32_INTERLOCKED_LONG) v));
 
   if (result != 0)
     {
@@ -0,0 +1,115 @@
+/*
+ * -------------------------------------------------------------
+ *
+ * Module: sem_trywait_multiple_np.c
+ *
+ * Purpose:
+ *	Semaphores aren't actually part of the PThreads standard.
+ *	They are defined by the POSIX Standard:
+ *
+ *		POSIX 1003.1b-1993	(POSIX.1b)
+ *
+ * -------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+int
+sem_trywait_multiple_np (sem_t * sem, int max, int * got)
+/*
+ * ------------------------------------------------------
+ * DOCPUBLIC
+ *      This function takes as many units as are available,
+ *      up to a limit, from a semaphore.
+ *
+ * PARAMETERS
+ *      sem
+ *              pointer to an instance of sem_t
+ *
+ *      max
+ *              the most units to take, must be greater than zero.
+ *
+ *      got
+ *              pointer to an int that receives the number of
+ *              units taken.
+ *
+ * DESCRIPTION
+ *      If the semaphore value is greater than zero, this
+ *      function decreases it by the value or 'max', whichever
+ *      is smaller, in one atomic step. If the semaphore value
+ *      is zero, then this function returns immediately with
+ *      the error EAGAIN.
+ *
+ * RESULTS
+ *              0               successfully decreased semaphore,
+ *              -1              failed, error in errno
+ * ERRNO
+ *              EAGAIN          the semaphore was already locked,
+ *              EINVAL          'sem' is not a valid semaphore, or
+ *                              'max' is less than or equal to zero.
+ *
+ * ------------------------------------------------------
+ */
+{
+  int result = 0;
+  int n = 0;
+
+  if (sem == NULL || *sem == NULL || max <= 0 || got == NULL)
+    {
+      result = EINVAL;
+    }
+  else if ((n = ptw32_sem_take (*sem, max)) == 0)
+    {
+      result = EAGAIN;
+    }
+
+  if (result != 0)
+    {
+      PTW32_SET_ERRNO(result);
+      return -1;
+    }
+
+  *got = n;
+
+  return 0;
+
+}				/* sem_trywait_multiple_np */
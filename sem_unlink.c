@@ -52,14 +52,104 @@
 #include "semaphore.h"
 #include "implement.h"
 
-/* ignore warning "unreferenced formal parameter" */
-#if defined(_MSC_VER)
-#pragma warning( disable : 4100 )
-#endif
-
 int
 sem_unlink (const char *name)
+/*
+ * ------------------------------------------------------
+ * DOCPUBLIC
+ *      This function removes the name of a named semaphore.
+ *
+ * PARAMETERS
+ *      name
+ *              the name passed to sem_open
+ *
+ * DESCRIPTION
+ *      Processes that have the semaphore open can go on using
+ *      it, but sem_open no longer finds it.
+ *
+ *      Win32 only frees the name when the last process closes
+ *      the semaphore. Until then sem_open with O_CREAT cannot
+ *      make a new semaphore of that name and fails with EAGAIN.
+ *      Without O_CREAT it fails with ENOENT, as it should.
+ *
+ * RESULTS
+ *              0               successfully unlinked the name,
+ *              -1              failed, error in errno
+ * ERRNO
+ *              EACCES          the semaphore cannot be opened,
+ *              EINVAL          'name' is not valid,
+ *              ENAMETOOLONG    'name' is too long,
+ *              ENOENT          no semaphore has that name,
+ *              ENOSYS          named semaphores are not supported
+ *                              (NEED_SEM builds).
+ *
+ * ------------------------------------------------------
+ */
 {
+#if defined(NEED_SEM)
+
   PTW32_SET_ERRNO(ENOSYS);
   return -1;
+
+#else /* NEED_SEM */
+
+  int result;
+  char path[PTW32_SEM_NAME_MAX + 32];
+  HANDLE section;
+  ptw32_sem_named_shared_t * shared;
+
+  if ((result = ptw32_sem_named_path (path, name, "")) != 0)
+    {
+      PTW32_SET_ERRNO(result);
+      return -1;
+    }
+
+  section = OpenFileMappingA (FILE_MAP_ALL_ACCESS, PTW32_FALSE, path);
+
+  if (section == NULL)
+    {
+      PTW32_SET_ERRNO((GetLastError () == ERROR_FILE_NOT_FOUND) ? ENOENT : EACCES);
+      return -1;
+    }
+
+  shared = (ptw32_sem_named_shared_t *)
+             MapViewOfFile (section, FILE_MAP_ALL_ACCESS, 0, 0,
+                            sizeof (ptw32_sem_named_shared_t));
+
+  if (shared == NULL)
+    {
+      result = EACCES;
+    }
+  else
+    {
+      /* Let a sem_open that is still creating it finish. */
+      while (*(PTW32_INTERLOCKED_VOLATILE LONG *) &shared->state == 0)
+        {
+          Sleep (0);
+        }
+
+      if ((PTW32_INTERLOCKED_LONG) PTW32_SEM_NAMED_READY
+            != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                 (PTW32_INTERLOCKED_LONGPTR) &shared->state,
+                 (PTW32_INTERLOCKED_LONG) PTW32_SEM_NAMED_UNLINKED,
+                 (PTW32_INTERLOCKED_LONG) PTW32_SEM_NAMED_READY))
+        {
+          result = ENOENT;
+        }
+
+      (void) UnmapViewOfFile (shared);
+    }
+
+  (void) CloseHandle (section);
+
+  if (result != 0)
+    {
+      PTW32_SET_ERRNO(result);
+      return -1;
+    }
+
+  return 0;
+
+#endif /* NEED_SEM */
+
 }				/* sem_unlink */
@@ -56,33 +56,12 @@
 static void PTW32_CDECL
 ptw32_sem_wait_cleanup(void * sem)
 {
-  sem_t s = (sem_t) sem;
-  ptw32_mcs_local_node_t node;
-
-  ptw32_mcs_lock_acquire(&s->lock, &node);
   /*
-   * If sema is destroyed do nothing, otherwise:-
-   * If the sema is posted between us being canceled and us locking
-   * the sema again above then we need to consume that post but cancel
-   * anyway. If we don't get the semaphore we indicate that we're no
-   * longer waiting.
+   * If the sema is posted between us being canceled and us withdrawing
+   * from it then we need to consume that post but cancel anyway.
+   * Otherwise we indicate that we're no longer waiting.
    */
-  if (*((sem_t *)sem) != NULL && !(WaitForSingleObject(s->sem, 0) == WAIT_OBJECT_0))
-    {
-      ++s->value;
-#if defined(NEED_SEM)
-      if (s->value > 0)
-        {
-          s->leftToUnblock = 0;
-        }
-#else
-      /*
-       * Don't release the W32 sema, it doesn't need adjustment
-       * because it doesn't record the number of waiters.
-       */
-#endif /* NEED_SEM */
-    }
-  ptw32_mcs_lock_release(&node);
+  (void) ptw32_sem_cancel_wait ((sem_t) sem);
 }
 
 int
@@ -109,6 +88,7 @@ sem_wait (sem_t * sem)
  *              -1              failed, error in errno
  * ERRNO
  *              EINVAL          'sem' is not a valid semaphore,
+ *              ENOSPC          a required resource has been exhausted,
  *              ENOSYS          semaphores are not supported,
  *              EINTR           the function was interrupted by a signal,
  *              EDEADLK         a deadlock condition was detected.
@@ -116,25 +96,25 @@ sem_wait (sem_t * sem)
  * ------------------------------------------------------
  */
 {
-  ptw32_mcs_local_node_t node;
-  int v;
   int result = 0;
   sem_t s = *sem;
 
   pthread_testcancel();
 
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-  v = --s->value;
-  ptw32_mcs_lock_release(&node);
-
-  if (v < 0)
+  /*
+   * A single interlocked decrement. Only block if there was
+   * nothing to take.
+   */
+  if (PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) s->count) < 0)
     {
 #if defined(PTW32_CONFIG_MSVC7)
 #pragma inline_depth(0)
 #endif
       /* Must wait */
+      HANDLE h = ptw32_sem_get_handle (s);
+
       pthread_cleanup_push(ptw32_sem_wait_cleanup, (void *) s);
-      result = pthreadCancelableWait (s->sem);
+      result = (h == NULL) ? ENOSPC : pthreadCancelableWait (h);
       /* Cleanup if we're canceled or on any other error */
       pthread_cleanup_pop(result);
 #if defined(PTW32_CONFIG_MSVC7)
@@ -145,6 +125,8 @@ sem_wait (sem_t * sem)
 
   if (!result)
     {
+      ptw32_mcs_local_node_t node;
+
       ptw32_mcs_lock_acquire(&s->lock, &node);
 
       if (s->leftToUnblock > 0)
@@ -80,15 +80,14 @@ struct timespec;
 typedef struct sem_t_ * sem_t;
 
 /* POSIX.1b (and later) mandates SEM_FAILED as the value to be
- * returned on failure of sem_open(); (our implementation is a
- * stub, which will always return this).
+ * returned on failure of sem_open().
  */
 #define SEM_FAILED  (sem_t *)(int)(-1)
 
 PTW32_BEGIN_C_DECLS
 
-/* Function prototypes: some are implemented as stubs, which
- * always fail; (FIXME: identify them).
+/* Function prototypes: in NEED_SEM builds sem_open(), sem_close()
+ * and sem_unlink() are stubs, which always fail with ENOSYS.
  */
 PTW32_DLLPORT int PTW32_CDECL sem_init (sem_t * sem,
 					int pshared,
@@ -108,6 +107,15 @@ PTW32_DLLPORT int PTW32_CDECL sem_post (sem_t * sem);
 PTW32_DLLPORT int PTW32_CDECL sem_post_multiple (sem_t * sem,
 						 int count);
 
+PTW32_DLLPORT int PTW32_CDECL sem_trywait_multiple_np (sem_t * sem,
+						       int max,
+						       int * got);
+
+PTW32_DLLPORT int PTW32_CDECL sem_timedwait_multiple_np (sem_t * sem,
+							 int max,
+							 int * got,
+							 const struct timespec * abstime);
+
 PTW32_DLLPORT sem_t * PTW32_CDECL sem_open (const char * name, int oflag, ...);
 
 PTW32_DLLPORT int PTW32_CDECL sem_close (sem_t * sem);
@@ -0,0 +1,155 @@
+/*
+ * barrier7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Declare PTHREAD_BARRIER_SPIN_NP and PTHREAD_BARRIER_TREE_NP barriers
+ * and cross them many times with different numbers of threads, including
+ * more threads than CPUs and counts that don't fill the tree evenly.
+ * Check that every crossing has exactly one serial thread and that
+ * everything written before a crossing is seen after it.
+ *
+ * Depends on API functions:
+ *	pthread_barrierattr_setkind_np()
+ *	pthread_barrierattr_getkind_np()
+ */
+
+#include "test.h"
+
+enum {
+  MAXTHREADS = 64,
+  ROUNDS = 2000
+};
+
+static pthread_barrier_t barrier = NULL;
+static int height;
+static int slot[MAXTHREADS];
+
+static void *
+func(void * arg)
+{
+  int me = (int)(size_t) arg;
+  int serialThreads = 0;
+  int round;
+  int i;
+  int result;
+
+  for (round = 1; round <= ROUNDS; round++)
+    {
+      slot[me] = round;
+
+      result = pthread_barrier_wait(&barrier);
+
+      if (result == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+          serialThreads++;
+        }
+      else
+        {
+          assert(result == 0);
+        }
+
+      for (i = 0; i < height; i++)
+        {
+          assert(slot[i] >= round);
+        }
+
+      /*
+       * Nobody may start the next round before everyone has checked.
+       */
+      result = pthread_barrier_wait(&barrier);
+      assert(result == 0 || result == PTHREAD_BARRIER_SERIAL_THREAD);
+    }
+
+  return (void*)(size_t)serialThreads;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_barrier7(void)
+#endif
+{
+  static const int heights[] = { 1, 2, 3, 8, 13, MAXTHREADS };
+  static const int kinds[] = { PTHREAD_BARRIER_SPIN_NP, PTHREAD_BARRIER_TREE_NP };
+  pthread_barrierattr_t ba;
+  pthread_t t[MAXTHREADS];
+  void* result;
+  int serialThreadsTotal;
+  int kind;
+  int h, i, k;
+
+  assert(pthread_barrierattr_init(&ba) == 0);
+  assert(pthread_barrierattr_getkind_np(&ba, &kind) == 0);
+  assert(kind == PTHREAD_BARRIER_DEFAULT_NP);
+  assert(pthread_barrierattr_setkind_np(&ba, -1) == EINVAL);
+
+  for (k = 0; k < (int)(sizeof(kinds) / sizeof(kinds[0])); k++)
+  for (h = 0; h < (int)(sizeof(heights) / sizeof(heights[0])); h++)
+    {
+      assert(pthread_barrierattr_setkind_np(&ba, kinds[k]) == 0);
+      assert(pthread_barrierattr_getkind_np(&ba, &kind) == 0);
+      assert(kind == kinds[k]);
+
+      height = heights[h];
+
+      assert(pthread_barrier_init(&barrier, &ba, height) == 0);
+
+      for (i = 0; i < height; i++)
+        {
+          slot[i] = 0;
+        }
+
+      for (i = 0; i < height; i++)
+        {
+          assert(pthread_create(&t[i], NULL, func, (void *)(size_t)i) == 0);
+        }
+
+      serialThreadsTotal = 0;
+      for (i = 0; i < height; i++)
+        {
+          assert(pthread_join(t[i], &result) == 0);
+          serialThreadsTotal += (int)(size_t)result;
+        }
+
+      assert(serialThreadsTotal == ROUNDS);
+
+      assert(pthread_barrier_destroy(&barrier) == 0);
+    }
+
+  assert(pthread_barrierattr_destroy(&ba) == 0);
+
+  return 0;
+}
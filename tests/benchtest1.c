@@ -38,8 +38,11 @@
  *
  * - Mutex
  *   Single thread iteration over lock/unlock for each mutex type.
+ *   The NORMAL and RECURSIVE types are also timed using the inline
+ *   kind-specialised fast paths enabled by PTW32_MUTEX_INLINE_NP.
  */
 
+#define PTW32_MUTEX_INLINE_NP
 #include "test.h"
 
 #ifdef __GNUC__
@@ -100,6 +103,37 @@ runTest (char * testNameString, int mType)
           (float) durationMilliSecs * 1E3 / ITERATIONS);
 }
 
+static void
+runInlineTest (char * testNameString, int mType)
+{
+  assert(pthread_mutexattr_settype(&ma, mType) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+
+  if (mType == PTHREAD_MUTEX_RECURSIVE)
+    {
+      TESTSTART;
+      assert((pthread_mutex_lock_recursive_np(&mx),1) == one);
+      assert((pthread_mutex_unlock_recursive_np(&mx),2) == two);
+      TESTSTOP;
+    }
+  else
+    {
+      TESTSTART;
+      assert((pthread_mutex_lock_normal_np(&mx),1) == one);
+      assert((pthread_mutex_unlock_normal_np(&mx),2) == two);
+      TESTSTOP;
+    }
+
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / ITERATIONS);
+}
+
 
 #ifndef MONOLITHIC_PTHREAD_TESTS
 int
@@ -238,6 +272,12 @@ test_benchtest1(void)
   runTest("PTHREAD_MUTEX_ERRORCHECK", PTHREAD_MUTEX_ERRORCHECK);
 
   runTest("PTHREAD_MUTEX_RECURSIVE", PTHREAD_MUTEX_RECURSIVE);
+
+  runTest("PTHREAD_MUTEX_ADAPTIVE_NP", PTHREAD_MUTEX_ADAPTIVE_NP);
+
+  runInlineTest("PTHREAD_MUTEX_NORMAL (inline _np)", PTHREAD_MUTEX_NORMAL);
+
+  runInlineTest("PTHREAD_MUTEX_RECURSIVE (inline _np)", PTHREAD_MUTEX_RECURSIVE);
 #else
   runTest("Non-blocking lock", 0);
 #endif
@@ -254,6 +294,8 @@ test_benchtest1(void)
   runTest("PTHREAD_MUTEX_ERRORCHECK (Robust)", PTHREAD_MUTEX_ERRORCHECK);
 
   runTest("PTHREAD_MUTEX_RECURSIVE (Robust)", PTHREAD_MUTEX_RECURSIVE);
+
+  runTest("PTHREAD_MUTEX_ADAPTIVE_NP (Robust)", PTHREAD_MUTEX_ADAPTIVE_NP);
 #else
   runTest("Non-blocking lock", 0);
 #endif
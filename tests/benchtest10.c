@@ -0,0 +1,161 @@
+/*
+ * benchtest10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Barrier scaling
+ *   2 to 256 threads repeatedly cross a barrier with a few
+ *   hundred nanoseconds of work between crossings, for each
+ *   barrier kind (pthread_barrierattr_setkind_np).
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define CROSSINGS           2000
+#define MAX_THREADS         256
+#define WORK                100
+
+static pthread_barrier_t barrier;
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+
+static void
+reportTest (char * testNameString, int nThreads, long count)
+{
+  char name[64];
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  sprintf(name, "%s x%d", testNameString, nThreads);
+  printf( "%-45s %15ld %15.3f\n",
+	    name,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / count);
+}
+
+static void *
+crosser (void * arg)
+{
+  volatile long work = 0;
+  int i, j;
+
+  for (i = 0; i < CROSSINGS; i++)
+    {
+      for (j = 0; j < WORK; j++)
+        {
+          work++;
+        }
+      (void) pthread_barrier_wait(&barrier);
+    }
+
+  return NULL;
+}
+
+static void
+runTest (char * testNameString, int nThreads, int kind)
+{
+  pthread_barrierattr_t ba;
+  pthread_t t[MAX_THREADS];
+  int i;
+
+  assert(pthread_barrierattr_init(&ba) == 0);
+  assert(pthread_barrierattr_setkind_np(&ba, kind) == 0);
+  assert(pthread_barrier_init(&barrier, &ba, nThreads) == 0);
+  assert(pthread_barrierattr_destroy(&ba) == 0);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, crosser, NULL) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(pthread_barrier_destroy(&barrier) == 0);
+
+  reportTest(testNameString, nThreads, CROSSINGS);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest10(void)
+#endif
+{
+  int nThreads;
+
+  printf( "=============================================================================\n");
+  printf( "\nBarrier crossings with %d increments of work per thread between them.\n\n", WORK);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 2; nThreads <= MAX_THREADS; nThreads *= 2)
+    {
+      runTest("Barrier (default)", nThreads, PTHREAD_BARRIER_DEFAULT_NP);
+      runTest("Barrier (spin)", nThreads, PTHREAD_BARRIER_SPIN_NP);
+      runTest("Barrier (tree)", nThreads, PTHREAD_BARRIER_TREE_NP);
+
+      printf( ".............................................................................\n");
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
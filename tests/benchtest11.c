@@ -0,0 +1,193 @@
+/*
+ * benchtest11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Spin lock contention
+ *   1 to 16 threads repeatedly lock and unlock one spin lock
+ *   around a little work, for each spin lock kind
+ *   (pthread_spin_init_np), compared with a mutex.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS          100000L
+#define MAX_THREADS         16
+#define WORK                10
+
+static pthread_spinlock_t spin;
+static pthread_mutex_t mx;
+static int useMutex;
+static volatile long shared = 0;
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+
+static void
+reportTest (char * testNameString, int nThreads, long count)
+{
+  char name[64];
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  sprintf(name, "%s x%d", testNameString, nThreads);
+  printf( "%-45s %15ld %15.3f\n",
+	    name,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / count);
+}
+
+static void *
+locker (void * arg)
+{
+  long i;
+  int j;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if (useMutex)
+        {
+          (void) pthread_mutex_lock(&mx);
+        }
+      else
+        {
+          (void) pthread_spin_lock(&spin);
+        }
+      for (j = 0; j < WORK; j++)
+        {
+          shared++;
+        }
+      if (useMutex)
+        {
+          (void) pthread_mutex_unlock(&mx);
+        }
+      else
+        {
+          (void) pthread_spin_unlock(&spin);
+        }
+    }
+
+  return NULL;
+}
+
+static void
+runTest (char * testNameString, int nThreads, int kind)
+{
+  pthread_t t[MAX_THREADS];
+  int i;
+
+  useMutex = (kind < 0);
+  if (useMutex)
+    {
+      assert(pthread_mutex_init(&mx, NULL) == 0);
+    }
+  else
+    {
+      assert(pthread_spin_init_np(&spin, PTHREAD_PROCESS_PRIVATE, kind) == 0);
+    }
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, NULL) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  if (useMutex)
+    {
+      assert(pthread_mutex_destroy(&mx) == 0);
+    }
+  else
+    {
+      assert(pthread_spin_destroy(&spin) == 0);
+    }
+
+  /*
+   * Average time per lock/unlock pair over all threads.
+   */
+  reportTest(testNameString, nThreads, ITERATIONS * nThreads);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest11(void)
+#endif
+{
+  int nThreads;
+
+  printf( "=============================================================================\n");
+  printf( "\nLock/unlock pairs with %d increments of work inside.\n\n", WORK);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 1; nThreads <= MAX_THREADS; nThreads *= 2)
+    {
+      runTest("Spin lock (default)", nThreads, PTHREAD_SPINLOCK_DEFAULT_NP);
+      runTest("Spin lock (fair)", nThreads, PTHREAD_SPINLOCK_FAIR_NP);
+      runTest("Mutex (default)", nThreads, -1);
+
+      printf( ".............................................................................\n");
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * benchtest12.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Sync object churn
+ *   1 to 16 threads repeatedly initialise and destroy a mutex,
+ *   a condition variable or a rwlock.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS          20000L
+#define MAX_THREADS         16
+
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+
+static void
+reportTest (char * testNameString, int nThreads, long count)
+{
+  char name[64];
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  sprintf(name, "%s x%d", testNameString, nThreads);
+  printf( "%-45s %15ld %15.3f\n",
+	    name,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / count);
+}
+
+static void *
+mutexChurn (void * arg)
+{
+  pthread_mutex_t mx;
+  long i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_init(&mx, NULL) == 0);
+      assert(pthread_mutex_destroy(&mx) == 0);
+    }
+
+  return NULL;
+}
+
+static void *
+condChurn (void * arg)
+{
+  pthread_cond_t cv;
+  long i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_cond_init(&cv, NULL) == 0);
+      assert(pthread_cond_destroy(&cv) == 0);
+    }
+
+  return NULL;
+}
+
+static void *
+rwlockChurn (void * arg)
+{
+  pthread_rwlock_t rwl;
+  long i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_rwlock_init(&rwl, NULL) == 0);
+      assert(pthread_rwlock_destroy(&rwl) == 0);
+    }
+
+  return NULL;
+}
+
+static void
+runTest (char * testNameString, int nThreads, void * (*func)(void *))
+{
+  pthread_t t[MAX_THREADS];
+  int i;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, func, NULL) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  /*
+   * Average time per init/destroy pair over all threads.
+   */
+  reportTest(testNameString, nThreads, ITERATIONS * nThreads);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest12(void)
+#endif
+{
+  int nThreads;
+
+  printf( "=============================================================================\n");
+  printf( "\nInit/destroy pairs per thread.\n\n");
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 1; nThreads <= MAX_THREADS; nThreads *= 2)
+    {
+      runTest("Mutex init/destroy", nThreads, mutexChurn);
+      runTest("Condvar init/destroy", nThreads, condChurn);
+      runTest("Rwlock init/destroy", nThreads, rwlockChurn);
+
+      printf( ".............................................................................\n");
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * benchtest13.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Measure time taken to complete an elementary operation.
+ *
+ * - False sharing
+ *   1 to 16 threads each lock and unlock a mutex or spin lock, or
+ *   post and wait a semaphore, of their own. The objects were
+ *   initialised one after the other, so with a plain heap they
+ *   would be neighbours in memory. For reference, the threads also
+ *   increment interlocked counters of their own, packed into one
+ *   array and padded to a cache line each.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS          1000000L
+#define MAX_THREADS         16
+#define LINE                128	/* At least any cache line size */
+
+enum {
+  MUTEXES,
+  SPINLOCKS,
+  SEMAPHORES,
+  PACKED,
+  PADDED
+};
+
+static pthread_mutex_t mx[MAX_THREADS];
+static pthread_spinlock_t spin[MAX_THREADS];
+static sem_t sema[MAX_THREADS];
+static volatile LONG packed[MAX_THREADS];
+static volatile LONG padded[MAX_THREADS][LINE / sizeof(LONG)];
+static int which;
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+
+static void
+reportTest (char * testNameString, int nThreads, long count)
+{
+  char name[64];
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  sprintf(name, "%s x%d", testNameString, nThreads);
+  printf( "%-45s %15ld %15.3f\n",
+	    name,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / count);
+}
+
+static void *
+worker (void * arg)
+{
+  int n = (int)(size_t) arg;
+  long i;
+
+  switch (which)
+    {
+    case MUTEXES:
+      for (i = 0; i < ITERATIONS; i++)
+        {
+          (void) pthread_mutex_lock(&mx[n]);
+          (void) pthread_mutex_unlock(&mx[n]);
+        }
+      break;
+    case SPINLOCKS:
+      for (i = 0; i < ITERATIONS; i++)
+        {
+          (void) pthread_spin_lock(&spin[n]);
+          (void) pthread_spin_unlock(&spin[n]);
+        }
+      break;
+    case SEMAPHORES:
+      for (i = 0; i < ITERATIONS; i++)
+        {
+          (void) sem_post(&sema[n]);
+          (void) sem_wait(&sema[n]);
+        }
+      break;
+    case PACKED:
+      for (i = 0; i < ITERATIONS; i++)
+        {
+          (void) InterlockedIncrement((LPLONG) &packed[n]);
+        }
+      break;
+    case PADDED:
+      for (i = 0; i < ITERATIONS; i++)
+        {
+          (void) InterlockedIncrement((LPLONG) &padded[n][0]);
+        }
+      break;
+    }
+
+  return NULL;
+}
+
+static void
+runTest (char * testNameString, int nThreads, int kind)
+{
+  pthread_t t[MAX_THREADS];
+  int i;
+
+  which = kind;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  /*
+   * Average time per operation in each thread: flat if the threads
+   * don't interfere.
+   */
+  reportTest(testNameString, nThreads, ITERATIONS);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest13(void)
+#endif
+{
+  int nThreads;
+  int i;
+
+  for (i = 0; i < MAX_THREADS; i++)
+    {
+      assert(pthread_mutex_init(&mx[i], NULL) == 0);
+      assert(pthread_spin_init(&spin[i], PTHREAD_PROCESS_PRIVATE) == 0);
+      assert(sem_init(&sema[i], 0, 0) == 0);
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nEach thread uses an object of its own.\n\n");
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 1; nThreads <= MAX_THREADS; nThreads *= 2)
+    {
+      runTest("Own mutex", nThreads, MUTEXES);
+      runTest("Own spin lock", nThreads, SPINLOCKS);
+      runTest("Own semaphore", nThreads, SEMAPHORES);
+      runTest("Own counter, packed (reference)", nThreads, PACKED);
+      runTest("Own counter, padded (reference)", nThreads, PADDED);
+
+      printf( ".............................................................................\n");
+    }
+
+  printf( "=============================================================================\n");
+
+  for (i = 0; i < MAX_THREADS; i++)
+    {
+      assert(pthread_mutex_destroy(&mx[i]) == 0);
+      assert(pthread_spin_destroy(&spin[i]) == 0);
+      assert(sem_destroy(&sema[i]) == 0);
+    }
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
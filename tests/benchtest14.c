@@ -0,0 +1,200 @@
+/*
+ * benchtest14.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Thread-specific data
+ *   Single thread iteration over pthread_getspecific and the inline
+ *   pthread_getspecific_fast_np enabled by PTW32_TSD_INLINE_NP, with
+ *   a bare TlsGetValue, and one bracketed by GetLastError and
+ *   SetLastError, as the references. Reports nanoseconds per call.
+ */
+
+#define PTW32_TSD_INLINE_NP
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      10000000L
+#define FILLER_KEYS     100
+
+static pthread_key_t key;
+static pthread_key_t filler[FILLER_KEYS];
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+static long overHeadMilliSecs = 0;
+static int one = 1;
+static int two = 2;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+/*
+ * Dummy use of j, otherwise the loop may be removed by the optimiser
+ * when doing the overhead timing with an empty loop.
+ */
+#define TESTSTART \
+  { int i, j = 0, k = 0; PTW32_FTIME(&currSysTimeStart); for (i = 0; i < ITERATIONS; i++) { j++;
+
+#define TESTSTOP \
+  }; PTW32_FTIME(&currSysTimeStop); if (j + k == i) j++; }
+
+
+static void
+reportTest (char * testNameString)
+{
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E6 / ITERATIONS);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest14(void)
+#endif
+{
+  DWORD w32key;
+  int i;
+
+  printf( "=============================================================================\n");
+  printf( "\nRead a thread-specific value.\n%ld iterations\n\n",
+          ITERATIONS);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(nsec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  /*
+   * Time the loop overhead so we can subtract it from the actual test times.
+   */
+  TESTSTART;
+  assert(1 == one);
+  TESTSTOP;
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+  overHeadMilliSecs = durationMilliSecs;
+
+
+  assert((w32key = TlsAlloc()) != TLS_OUT_OF_INDEXES);
+  assert(TlsSetValue(w32key, (LPVOID) &one) != 0);
+  TESTSTART;
+  assert(TlsGetValue(w32key) == (LPVOID) &one);
+  TESTSTOP;
+
+  reportTest("W32 TlsGetValue");
+
+  TESTSTART;
+  {
+    DWORD lastError = GetLastError();
+    assert(TlsGetValue(w32key) == (LPVOID) &one);
+    SetLastError(lastError);
+  }
+  TESTSTOP;
+  assert(TlsFree(w32key) != 0);
+
+  reportTest("W32 TlsGetValue keeping last error");
+
+  printf( ".............................................................................\n");
+
+  /*
+   * Now we can start the actual tests
+   */
+  assert(pthread_key_create(&key, NULL) == 0);
+  assert(pthread_setspecific(key, &two) == 0);
+
+  TESTSTART;
+  assert(pthread_getspecific(key) == (void *) &two);
+  TESTSTOP;
+
+  reportTest("pthread_getspecific");
+
+  TESTSTART;
+  assert(pthread_getspecific_fast_np(key) == (void *) &two);
+  TESTSTOP;
+
+  reportTest("pthread_getspecific_fast_np");
+
+  assert(pthread_key_delete(key) == 0);
+
+  /*
+   * A key further into the value array, and one that is not set.
+   */
+  for (i = 0; i < FILLER_KEYS; i++)
+    {
+      assert(pthread_key_create(&filler[i], NULL) == 0);
+    }
+  assert(pthread_key_create(&key, NULL) == 0);
+  assert(pthread_setspecific(key, &two) == 0);
+
+  TESTSTART;
+  assert(pthread_getspecific_fast_np(key) == (void *) &two);
+  TESTSTOP;
+
+  reportTest("pthread_getspecific_fast_np (index 100)");
+
+  TESTSTART;
+  assert(pthread_getspecific_fast_np(filler[0]) == NULL);
+  TESTSTOP;
+
+  reportTest("pthread_getspecific_fast_np (not set)");
+
+  assert(pthread_key_delete(key) == 0);
+  for (i = 0; i < FILLER_KEYS; i++)
+    {
+      assert(pthread_key_delete(filler[i]) == 0);
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
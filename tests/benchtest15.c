@@ -0,0 +1,182 @@
+/*
+ * benchtest15.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Thread-specific data at thread exit
+ *   Create a thread that sets values for N keys with destructors,
+ *   then exits and is joined, for N from 0 to 512. A second series
+ *   sets and then clears all but one of the N values, so the exit
+ *   has only one destructor to call.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define THREADS         2000L
+#define MAX_KEYS        512
+
+static pthread_key_t keys[MAX_KEYS];
+static int nKeys;
+static int clearValues;
+static int one = 1;
+static long destructorCalls;
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+
+static void
+reportTest (char * testNameString)
+{
+  char name[64];
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  sprintf(name, "%s, %d keys", testNameString, nKeys);
+  printf( "%-45s %15ld %15.3f\n",
+	    name,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / THREADS);
+}
+
+static void
+destroyValue (void * value)
+{
+  destructorCalls++;
+}
+
+static void *
+setKeys (void * arg)
+{
+  int i;
+
+  for (i = 0; i < nKeys; i++)
+    {
+      assert(pthread_setspecific(keys[i], &one) == 0);
+    }
+
+  if (clearValues)
+    {
+      for (i = 1; i < nKeys; i++)
+        {
+          assert(pthread_setspecific(keys[i], NULL) == 0);
+        }
+    }
+
+  return NULL;
+}
+
+static void
+runTest (char * testNameString)
+{
+  pthread_t t;
+  long i;
+
+  destructorCalls = 0;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_create(&t, NULL, setKeys, NULL) == 0);
+      assert(pthread_join(t, NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(destructorCalls == THREADS * (clearValues && nKeys > 0 ? 1 : nKeys));
+
+  /*
+   * Average time per thread lifetime.
+   */
+  reportTest(testNameString);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest15(void)
+#endif
+{
+  int i;
+
+  for (i = 0; i < MAX_KEYS; i++)
+    {
+      assert(pthread_key_create(&keys[i], destroyValue) == 0);
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nCreate, set N values, exit and join.\n%ld threads\n\n",
+          THREADS);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (clearValues = 0; clearValues <= 1; clearValues++)
+    {
+      for (nKeys = 0; nKeys <= MAX_KEYS; nKeys = (nKeys == 0 ? 8 : nKeys * 4))
+        {
+          runTest(clearValues ? "Set all, clear all but one" : "Set all");
+        }
+
+      printf( ".............................................................................\n");
+    }
+
+  for (i = 0; i < MAX_KEYS; i++)
+    {
+      assert(pthread_key_delete(keys[i]) == 0);
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
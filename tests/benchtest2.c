@@ -41,8 +41,11 @@
  *   The two threads are forced into lock-step using two mutexes,
  *   forcing the threads to block on each lock operation. The
  *   time measured is therefore the worst case senario.
+ *   The NORMAL and RECURSIVE types are also timed using the inline
+ *   kind-specialised fast paths enabled by PTW32_MUTEX_INLINE_NP.
  */
 
+#define PTW32_MUTEX_INLINE_NP
 #include "test.h"
 
 #ifdef __GNUC__
@@ -64,6 +67,7 @@ static PTW32_STRUCT_TIMEB currSysTimeStart;
 static PTW32_STRUCT_TIMEB currSysTimeStop;
 static pthread_t worker;
 static int running = 0;
+static int inlineKind = PTHREAD_MUTEX_NORMAL;
 
 /* [i_a] */
 #define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
@@ -125,6 +129,36 @@ workerThread(void * arg)
   return NULL;
 }
 
+static int
+lockInline(pthread_mutex_t * m)
+{
+  return (inlineKind == PTHREAD_MUTEX_RECURSIVE) ? pthread_mutex_lock_recursive_np(m)
+                                                 : pthread_mutex_lock_normal_np(m);
+}
+
+static int
+unlockInline(pthread_mutex_t * m)
+{
+  return (inlineKind == PTHREAD_MUTEX_RECURSIVE) ? pthread_mutex_unlock_recursive_np(m)
+                                                 : pthread_mutex_unlock_normal_np(m);
+}
+
+static void *
+inlineWorkerThread(void * arg)
+{
+  do
+    {
+      (void) lockInline(&gate1);
+      (void) lockInline(&gate2);
+      (void) unlockInline(&gate1);
+      sched_yield();
+      (void) unlockInline(&gate2);
+    }
+  while (running);
+
+  return NULL;
+}
+
 static void *
 CSThread(void * arg)
 {
@@ -173,6 +207,37 @@ runTest (char * testNameString, int mType)
           (float) durationMilliSecs * 1E3 / ITERATIONS / 4   /* Four locks/unlocks per iteration */);
 }
 
+static void
+runInlineTest (char * testNameString, int mType)
+{
+  inlineKind = mType;
+  assert(pthread_mutexattr_settype(&ma, mType) == 0);
+  assert(pthread_mutex_init(&gate1, &ma) == 0);
+  assert(pthread_mutex_init(&gate2, &ma) == 0);
+  assert(lockInline(&gate1) == 0);
+  assert(lockInline(&gate2) == 0);
+  running = 1;
+  assert(pthread_create(&worker, NULL, inlineWorkerThread, NULL) == 0);
+  TESTSTART;
+  (void) unlockInline(&gate1);
+  sched_yield();
+  (void) unlockInline(&gate2);
+  (void) lockInline(&gate1);
+  (void) lockInline(&gate2);
+  TESTSTOP;
+  running = 0;
+  assert(unlockInline(&gate2) == 0);
+  assert(unlockInline(&gate1) == 0);
+  assert(pthread_join(worker, NULL) == 0);
+  assert(pthread_mutex_destroy(&gate2) == 0);
+  assert(pthread_mutex_destroy(&gate1) == 0);
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / ITERATIONS / 4   /* Four locks/unlocks per iteration */);
+}
+
 
 #ifndef MONOLITHIC_PTHREAD_TESTS
 int
@@ -302,6 +367,12 @@ test_benchtest2(void)
   runTest("PTHREAD_MUTEX_ERRORCHECK", PTHREAD_MUTEX_ERRORCHECK);
 
   runTest("PTHREAD_MUTEX_RECURSIVE", PTHREAD_MUTEX_RECURSIVE);
+
+  runTest("PTHREAD_MUTEX_ADAPTIVE_NP", PTHREAD_MUTEX_ADAPTIVE_NP);
+
+  runInlineTest("PTHREAD_MUTEX_NORMAL (inline _np)", PTHREAD_MUTEX_NORMAL);
+
+  runInlineTest("PTHREAD_MUTEX_RECURSIVE (inline _np)", PTHREAD_MUTEX_RECURSIVE);
 #else
   runTest("Non-blocking lock", 0);
 #endif
@@ -318,6 +389,8 @@ test_benchtest2(void)
   runTest("PTHREAD_MUTEX_ERRORCHECK (Robust)", PTHREAD_MUTEX_ERRORCHECK);
 
   runTest("PTHREAD_MUTEX_RECURSIVE (Robust)", PTHREAD_MUTEX_RECURSIVE);
+
+  runTest("PTHREAD_MUTEX_ADAPTIVE_NP (Robust)", PTHREAD_MUTEX_ADAPTIVE_NP);
 #else
   runTest("Non-blocking lock", 0);
 #endif
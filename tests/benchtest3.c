@@ -38,8 +38,11 @@
  *
  * - Mutex
  *   Single thread iteration over a trylock on a locked mutex for each mutex type.
+ *   The NORMAL and RECURSIVE types are also timed using the inline
+ *   kind-specialised fast paths enabled by PTW32_MUTEX_INLINE_NP.
  */
 
+#define PTW32_MUTEX_INLINE_NP
 #include "test.h"
 
 #ifdef __GNUC__
@@ -85,6 +88,28 @@ trylockThread (void * arg)
 }
 
 
+static void *
+trylockNormalInlineThread (void * arg)
+{
+  TESTSTART;
+  (void) pthread_mutex_trylock_normal_np(&mx);
+  TESTSTOP;
+
+  return NULL;
+}
+
+
+static void *
+trylockRecursiveInlineThread (void * arg)
+{
+  TESTSTART;
+  (void) pthread_mutex_trylock_recursive_np(&mx);
+  TESTSTOP;
+
+  return NULL;
+}
+
+
 static void *
 oldTrylockThread (void * arg)
 {
@@ -119,6 +144,30 @@ runTest (char * testNameString, int mType)
           (float) durationMilliSecs * 1E3 / ITERATIONS);
 }
 
+static void
+runInlineTest (char * testNameString, int mType)
+{
+  pthread_t t;
+
+  (void) pthread_mutexattr_settype(&ma, mType);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_create(&t, NULL,
+                        (mType == PTHREAD_MUTEX_RECURSIVE) ? trylockRecursiveInlineThread
+                                                           : trylockNormalInlineThread,
+                        0) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / ITERATIONS);
+}
+
 
 #ifndef MONOLITHIC_PTHREAD_TESTS
 int
@@ -191,6 +240,12 @@ test_benchtest3(void)
   runTest("PTHREAD_MUTEX_ERRORCHECK", PTHREAD_MUTEX_ERRORCHECK);
 
   runTest("PTHREAD_MUTEX_RECURSIVE", PTHREAD_MUTEX_RECURSIVE);
+
+  runTest("PTHREAD_MUTEX_ADAPTIVE_NP", PTHREAD_MUTEX_ADAPTIVE_NP);
+
+  runInlineTest("PTHREAD_MUTEX_NORMAL (inline _np)", PTHREAD_MUTEX_NORMAL);
+
+  runInlineTest("PTHREAD_MUTEX_RECURSIVE (inline _np)", PTHREAD_MUTEX_RECURSIVE);
 #else
   runTest("Non-blocking lock", 0);
 #endif
@@ -207,6 +262,8 @@ test_benchtest3(void)
   runTest("PTHREAD_MUTEX_ERRORCHECK (Robust)", PTHREAD_MUTEX_ERRORCHECK);
 
   runTest("PTHREAD_MUTEX_RECURSIVE (Robust)", PTHREAD_MUTEX_RECURSIVE);
+
+  runTest("PTHREAD_MUTEX_ADAPTIVE_NP (Robust)", PTHREAD_MUTEX_ADAPTIVE_NP);
 #else
   runTest("Non-blocking lock", 0);
 #endif
@@ -38,8 +38,11 @@
  *
  * - Mutex
  *   Single thread iteration over trylock/unlock for each mutex type.
+ *   The NORMAL and RECURSIVE types are also timed using the inline
+ *   kind-specialised fast paths enabled by PTW32_MUTEX_INLINE_NP.
  */
 
+#define PTW32_MUTEX_INLINE_NP
 #include "test.h"
 
 #ifdef __GNUC__
@@ -103,6 +106,37 @@ runTest (char * testNameString, int mType)
           (float) durationMilliSecs * 1E3 / ITERATIONS);
 }
 
+static void
+runInlineTest (char * testNameString, int mType)
+{
+  pthread_mutexattr_settype(&ma, mType);
+  pthread_mutex_init(&mx, &ma);
+
+  if (mType == PTHREAD_MUTEX_RECURSIVE)
+    {
+      TESTSTART;
+      (void) pthread_mutex_trylock_recursive_np(&mx);
+      (void) pthread_mutex_unlock_recursive_np(&mx);
+      TESTSTOP;
+    }
+  else
+    {
+      TESTSTART;
+      (void) pthread_mutex_trylock_normal_np(&mx);
+      (void) pthread_mutex_unlock_normal_np(&mx);
+      TESTSTOP;
+    }
+
+  pthread_mutex_destroy(&mx);
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / ITERATIONS);
+}
+
 
 #ifndef MONOLITHIC_PTHREAD_TESTS
 int
@@ -172,6 +206,12 @@ test_benchtest4(void)
   runTest("PTHREAD_MUTEX_ERRORCHECK", PTHREAD_MUTEX_ERRORCHECK);
 
   runTest("PTHREAD_MUTEX_RECURSIVE", PTHREAD_MUTEX_RECURSIVE);
+
+  runTest("PTHREAD_MUTEX_ADAPTIVE_NP", PTHREAD_MUTEX_ADAPTIVE_NP);
+
+  runInlineTest("PTHREAD_MUTEX_NORMAL (inline _np)", PTHREAD_MUTEX_NORMAL);
+
+  runInlineTest("PTHREAD_MUTEX_RECURSIVE (inline _np)", PTHREAD_MUTEX_RECURSIVE);
 #else
   runTest("Non-blocking lock", 0);
 #endif
@@ -188,6 +228,8 @@ test_benchtest4(void)
   runTest("PTHREAD_MUTEX_ERRORCHECK (Robust)", PTHREAD_MUTEX_ERRORCHECK);
 
   runTest("PTHREAD_MUTEX_RECURSIVE (Robust)", PTHREAD_MUTEX_RECURSIVE);
+
+  runTest("PTHREAD_MUTEX_ADAPTIVE_NP (Robust)", PTHREAD_MUTEX_ADAPTIVE_NP);
 #else
   runTest("Non-blocking lock", 0);
 #endif
@@ -0,0 +1,218 @@
+/*
+ * benchtest6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Mutex
+ *   Compare the two mutex wait backends: mutexes that block on their
+ *   lock word (WaitOnAddress, when the PTW32_WAIT_ON_ADDRESS feature is
+ *   available) and mutexes that block on a per-mutex Win32 event.
+ *   Robust mutexes always use an event so they provide the reference.
+ *
+ *   1. Single thread iteration over init plus destroy.
+ *   2. Two threads repeatedly handing off a contended mutex.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      1000000L
+#define HANDOFF_THREADS 2
+
+static pthread_mutex_t mx;
+static pthread_mutexattr_t ma;
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+static long overHeadMilliSecs = 0;
+static int one = 1;
+static int zero = 0;
+static long sharedCount;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+/*
+ * Dummy use of j, otherwise the loop may be removed by the optimiser
+ * when doing the overhead timing with an empty loop.
+ */
+#define TESTSTART \
+  { int i, j = 0, k = 0; PTW32_FTIME(&currSysTimeStart); for (i = 0; i < ITERATIONS; i++) { j++;
+
+#define TESTSTOP \
+  }; PTW32_FTIME(&currSysTimeStop); if (j + k == i) j++; }
+
+
+static void
+reportTest (char * testNameString, long overhead, long count)
+{
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overhead;
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / count);
+}
+
+static void
+runInitDestroyTest (char * testNameString, int robustness)
+{
+  assert(pthread_mutexattr_setrobust(&ma, robustness) == 0);
+
+  TESTSTART;
+  assert(pthread_mutex_init(&mx, &ma) == zero);
+  assert(pthread_mutex_destroy(&mx) == zero);
+  TESTSTOP;
+
+  reportTest(testNameString, overHeadMilliSecs, ITERATIONS);
+}
+
+static void *
+handoffRoutine (void * arg)
+{
+  long i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&mx) == 0);
+      sharedCount++;
+      assert(pthread_mutex_unlock(&mx) == 0);
+    }
+
+  return NULL;
+}
+
+static void
+runHandoffTest (char * testNameString, int robustness)
+{
+  pthread_t t[HANDOFF_THREADS];
+  int i;
+
+  assert(pthread_mutexattr_setrobust(&ma, robustness) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  sharedCount = 0;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < HANDOFF_THREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, handoffRoutine, NULL) == 0);
+    }
+  for (i = 0; i < HANDOFF_THREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(sharedCount == HANDOFF_THREADS * ITERATIONS);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  reportTest(testNameString, 0, HANDOFF_THREADS * ITERATIONS);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest6(void)
+#endif
+{
+  HANDLE ev;
+
+  pthread_mutexattr_init(&ma);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_NORMAL) == 0);
+
+  printf( "=============================================================================\n");
+  printf( "\nMutex wait backends. WaitOnAddress is %s.\n%ld iterations\n\n",
+          pthread_win32_test_features_np(PTW32_WAIT_ON_ADDRESS) ? "in use" : "NOT available",
+          ITERATIONS);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  /*
+   * Time the loop overhead so we can subtract it from the actual test times.
+   */
+  TESTSTART;
+  assert(1 == one);
+  assert(0 == zero);
+  TESTSTOP;
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+  overHeadMilliSecs = durationMilliSecs;
+
+
+  TESTSTART;
+  assert((ev = CreateEvent(NULL, FALSE, FALSE, NULL)) != NULL);
+  assert(CloseHandle(ev) != 0);
+  TESTSTOP;
+
+  reportTest("W32 CreateEvent plus CloseHandle", overHeadMilliSecs, ITERATIONS);
+
+  printf( ".............................................................................\n");
+
+  /*
+   * Now we can start the actual tests
+   */
+  runInitDestroyTest("Init+destroy PTHREAD_MUTEX_NORMAL", PTHREAD_MUTEX_STALLED);
+
+  runInitDestroyTest("Init+destroy PTHREAD_MUTEX_NORMAL (Robust)", PTHREAD_MUTEX_ROBUST);
+
+  printf( ".............................................................................\n");
+
+  runHandoffTest("Handoff x2 PTHREAD_MUTEX_NORMAL", PTHREAD_MUTEX_STALLED);
+
+  runHandoffTest("Handoff x2 PTHREAD_MUTEX_NORMAL (Robust)", PTHREAD_MUTEX_ROBUST);
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  pthread_mutexattr_destroy(&ma);
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * benchtest7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Thread identity
+ *   Single thread iteration over operations that look up the calling
+ *   thread: pthread_self, pthread_getspecific and lock/unlock of a
+ *   recursive mutex (which records its owner via pthread_self).
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      10000000L
+
+static pthread_mutex_t mx;
+static pthread_mutexattr_t ma;
+static pthread_key_t key;
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+static long overHeadMilliSecs = 0;
+static int one = 1;
+static int two = 2;
+static int zero = 0;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+/*
+ * Dummy use of j, otherwise the loop may be removed by the optimiser
+ * when doing the overhead timing with an empty loop.
+ */
+#define TESTSTART \
+  { int i, j = 0, k = 0; PTW32_FTIME(&currSysTimeStart); for (i = 0; i < ITERATIONS; i++) { j++;
+
+#define TESTSTOP \
+  }; PTW32_FTIME(&currSysTimeStop); if (j + k == i) j++; }
+
+
+static void
+reportTest (char * testNameString)
+{
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / ITERATIONS);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest7(void)
+#endif
+{
+  DWORD w32key;
+
+  printf( "=============================================================================\n");
+  printf( "\nLook up the calling thread.\n%ld iterations\n\n",
+          ITERATIONS);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  /*
+   * Time the loop overhead so we can subtract it from the actual test times.
+   */
+  TESTSTART;
+  assert(1 == one);
+  TESTSTOP;
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+  overHeadMilliSecs = durationMilliSecs;
+
+
+  assert((w32key = TlsAlloc()) != TLS_OUT_OF_INDEXES);
+  assert(TlsSetValue(w32key, (LPVOID) &one) != 0);
+  TESTSTART;
+  assert(TlsGetValue(w32key) == (LPVOID) &one);
+  TESTSTOP;
+  assert(TlsFree(w32key) != 0);
+
+  reportTest("W32 TlsGetValue");
+
+  printf( ".............................................................................\n");
+
+  /*
+   * Now we can start the actual tests
+   */
+  TESTSTART;
+  assert(pthread_self().p != NULL);
+  TESTSTOP;
+
+  reportTest("pthread_self");
+
+
+  assert(pthread_key_create(&key, NULL) == 0);
+  assert(pthread_setspecific(key, &two) == 0);
+  TESTSTART;
+  assert(pthread_getspecific(key) == (void *) &two);
+  TESTSTOP;
+  assert(pthread_key_delete(key) == 0);
+
+  reportTest("pthread_getspecific");
+
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_RECURSIVE) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  TESTSTART;
+  assert(pthread_mutex_lock(&mx) == zero);
+  assert(pthread_mutex_unlock(&mx) == zero);
+  TESTSTOP;
+
+  reportTest("PTHREAD_MUTEX_RECURSIVE lock+unlock");
+
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  TESTSTART;
+  assert(pthread_mutex_lock(&mx) == zero);
+  assert(pthread_mutex_unlock(&mx) == zero);
+  TESTSTOP;
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  reportTest("PTHREAD_MUTEX_RECURSIVE nested lock+unlock");
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * benchtest8.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Condition Variable
+ *   1. Signal latency: two threads take turns, each signalling the
+ *      other and waiting for the reply.
+ *   2. Broadcast to BROADCAST_WAITERS waiters, each of which must then
+ *      re-acquire the mutex. With a non-robust mutex the waiters are
+ *      requeued onto the mutex and handed it by each unlock (wait
+ *      morphing); robust mutexes can't be handed over so all waiters
+ *      are woken at once, which provides the reference.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS          100000L
+#define BROADCAST_WAITERS   64
+#define BROADCAST_ROUNDS    2000L
+
+static pthread_mutex_t mx;
+static pthread_mutexattr_t ma;
+static pthread_cond_t cv;
+static pthread_cond_t allWaitingCv;
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+static int turn;
+static int nWaiting;
+static long generation;
+static long wakeCount;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+
+static void
+reportTest (char * testNameString, long count)
+{
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / count);
+}
+
+static void *
+pingPongRoutine (void * arg)
+{
+  int me = (int)(size_t) arg;
+  long i;
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      while (turn != me)
+        {
+          assert(pthread_cond_wait(&cv, &mx) == 0);
+        }
+      turn = 1 - me;
+      assert(pthread_cond_signal(&cv) == 0);
+    }
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  return NULL;
+}
+
+static void
+runSignalTest (char * testNameString, int robustness)
+{
+  pthread_t t[2];
+  int i;
+
+  assert(pthread_mutexattr_setrobust(&ma, robustness) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  assert(pthread_cond_init(&cv, NULL) == 0);
+  turn = 0;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < 2; i++)
+    {
+      assert(pthread_create(&t[i], NULL, pingPongRoutine, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < 2; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  reportTest(testNameString, 2 * ITERATIONS);
+}
+
+static void *
+broadcastWaiterRoutine (void * arg)
+{
+  long i;
+  long myGeneration;
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  for (i = 0; i < BROADCAST_ROUNDS; i++)
+    {
+      myGeneration = generation;
+      if (++nWaiting == BROADCAST_WAITERS)
+        {
+          assert(pthread_cond_signal(&allWaitingCv) == 0);
+        }
+      while (generation == myGeneration)
+        {
+          assert(pthread_cond_wait(&cv, &mx) == 0);
+        }
+      wakeCount++;
+    }
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  return NULL;
+}
+
+static void
+runBroadcastTest (char * testNameString, int robustness)
+{
+  pthread_t t[BROADCAST_WAITERS];
+  long round;
+  int i;
+
+  assert(pthread_mutexattr_setrobust(&ma, robustness) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  assert(pthread_cond_init(&cv, NULL) == 0);
+  assert(pthread_cond_init(&allWaitingCv, NULL) == 0);
+  nWaiting = 0;
+  generation = 0;
+  wakeCount = 0;
+
+  for (i = 0; i < BROADCAST_WAITERS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, broadcastWaiterRoutine, NULL) == 0);
+    }
+
+  PTW32_FTIME(&currSysTimeStart);
+  assert(pthread_mutex_lock(&mx) == 0);
+  for (round = 0; round < BROADCAST_ROUNDS; round++)
+    {
+      while (nWaiting < BROADCAST_WAITERS)
+        {
+          assert(pthread_cond_wait(&allWaitingCv, &mx) == 0);
+        }
+      nWaiting = 0;
+      generation++;
+      assert(pthread_cond_broadcast(&cv) == 0);
+    }
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  for (i = 0; i < BROADCAST_WAITERS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(wakeCount == BROADCAST_WAITERS * BROADCAST_ROUNDS);
+  assert(pthread_cond_destroy(&allWaitingCv) == 0);
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  reportTest(testNameString, BROADCAST_ROUNDS);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest8(void)
+#endif
+{
+  pthread_mutexattr_init(&ma);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_NORMAL) == 0);
+
+  printf( "=============================================================================\n");
+  printf( "\nCondition variable signal and broadcast.\n\n");
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  runSignalTest("Signal+wait round trip PTHREAD_MUTEX_NORMAL", PTHREAD_MUTEX_STALLED);
+
+  runSignalTest("Signal+wait round trip (Robust)", PTHREAD_MUTEX_ROBUST);
+
+  printf( ".............................................................................\n");
+
+  runBroadcastTest("Broadcast x64 PTHREAD_MUTEX_NORMAL (morphed)", PTHREAD_MUTEX_STALLED);
+
+  runBroadcastTest("Broadcast x64 (Robust, wake all)", PTHREAD_MUTEX_ROBUST);
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  pthread_mutexattr_destroy(&ma);
+
+  return 0;
+}
@@ -0,0 +1,248 @@
+/*
+ * benchtest9.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Read-side scaling
+ *   1 to 64 threads repeatedly copy a small record that a single
+ *   writer thread keeps updating, protected by a sequence lock
+ *   (optimistic, readers don't store to shared memory) and, for
+ *   reference, by a default and a read-mostly rwlock. Each copy is
+ *   checked for consistency.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define READS_PER_THREAD    200000L
+#define MAX_READERS         64
+#define WRITER_INTERVAL_MS  1
+
+typedef struct {
+  long a;
+  long b;
+  long sum;
+} record_t;
+
+static record_t shared;
+static pthread_seqlock_t sl;
+static pthread_rwlock_t rwl;
+static volatile int readersDone;
+static PTW32_STRUCT_TIMEB currSysTimeStart;
+static PTW32_STRUCT_TIMEB currSysTimeStop;
+static long durationMilliSecs;
+
+/* [i_a] */
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000LL+_TStop.millitm) \
+                                               - (_TStart.time*1000LL+_TStart.millitm)))
+
+
+static void
+reportTest (char * testNameString, int nThreads, long count)
+{
+  char name[64];
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  sprintf(name, "%s x%d", testNameString, nThreads);
+  printf( "%-45s %15ld %15.3f\n",
+	    name,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / count);
+}
+
+static void *
+seqReader (void * arg)
+{
+  long i;
+  unsigned int seq;
+  record_t copy;
+
+  for (i = 0; i < READS_PER_THREAD; i++)
+    {
+      do
+        {
+          seq = pthread_seqlock_read_begin_np(&sl);
+          copy.a = ((volatile record_t *) &shared)->a;
+          copy.b = ((volatile record_t *) &shared)->b;
+          copy.sum = ((volatile record_t *) &shared)->sum;
+        }
+      while (pthread_seqlock_read_retry_np(&sl, seq));
+      assert(copy.a + copy.b == copy.sum);
+    }
+
+  return NULL;
+}
+
+static void *
+seqWriter (void * arg)
+{
+  while (!readersDone)
+    {
+      assert(pthread_seqlock_write_lock_np(&sl) == 0);
+      shared.a++;
+      shared.b += 2;
+      shared.sum = shared.a + shared.b;
+      assert(pthread_seqlock_write_unlock_np(&sl) == 0);
+      Sleep(WRITER_INTERVAL_MS);
+    }
+
+  return NULL;
+}
+
+static void *
+rwReader (void * arg)
+{
+  long i;
+  record_t copy;
+
+  for (i = 0; i < READS_PER_THREAD; i++)
+    {
+      assert(pthread_rwlock_rdlock(&rwl) == 0);
+      copy = shared;
+      assert(pthread_rwlock_unlock(&rwl) == 0);
+      assert(copy.a + copy.b == copy.sum);
+    }
+
+  return NULL;
+}
+
+static void *
+rwWriter (void * arg)
+{
+  while (!readersDone)
+    {
+      assert(pthread_rwlock_wrlock(&rwl) == 0);
+      shared.a++;
+      shared.b += 2;
+      shared.sum = shared.a + shared.b;
+      assert(pthread_rwlock_unlock(&rwl) == 0);
+      Sleep(WRITER_INTERVAL_MS);
+    }
+
+  return NULL;
+}
+
+static void
+runTest (char * testNameString, int nThreads,
+         void * (*reader)(void *), void * (*writer)(void *))
+{
+  pthread_t t[MAX_READERS];
+  pthread_t w;
+  int i;
+
+  shared.a = shared.b = shared.sum = 0;
+  readersDone = 0;
+  assert(pthread_create(&w, NULL, writer, NULL) == 0);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, reader, NULL) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  readersDone = 1;
+  assert(pthread_join(w, NULL) == 0);
+
+  reportTest(testNameString, nThreads, nThreads * READS_PER_THREAD);
+}
+
+static void
+runRwlockTest (char * testNameString, int nThreads, int kind)
+{
+  pthread_rwlockattr_t rwa;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, kind) == 0);
+  assert(pthread_rwlock_init(&rwl, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  runTest(testNameString, nThreads, rwReader, rwWriter);
+
+  assert(pthread_rwlock_destroy(&rwl) == 0);
+}
+
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main ()
+#else
+int
+test_benchtest9(void)
+#endif
+{
+  int nThreads;
+
+  printf( "=============================================================================\n");
+  printf( "\nRead-side scaling with one writer every %d msec.\n\n", WRITER_INTERVAL_MS);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 1; nThreads <= MAX_READERS; nThreads *= 2)
+    {
+      assert(pthread_seqlock_init_np(&sl) == 0);
+      runTest("Seqlock read", nThreads, seqReader, seqWriter);
+      assert(pthread_seqlock_destroy_np(&sl) == 0);
+
+      runRwlockTest("Rwlock rdlock (default)", nThreads,
+                    PTHREAD_RWLOCK_DEFAULT_NP);
+
+      runRwlockTest("Rwlock rdlock (read-mostly)", nThreads,
+                    PTHREAD_RWLOCK_READ_MOSTLY_NP);
+
+      printf( ".............................................................................\n");
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
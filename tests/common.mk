@@ -4,7 +4,7 @@
 
 ALL_KNOWN_TESTS = \
 	affinity1 affinity2 affinity3 affinity4 affinity5 affinity6 \
-	barrier1 barrier2 barrier3 barrier4 barrier5 barrier6 \
+	barrier1 barrier2 barrier3 barrier4 barrier5 barrier6 barrier7 \
 	cancel1 cancel2 cancel3 cancel4 cancel5 cancel6a cancel6d \
 	cancel7 cancel8 cancel9 \
 	cleanup0 cleanup1 cleanup2 cleanup3 \
@@ -27,7 +27,7 @@ ALL_KNOWN_TESTS = \
 	eyal1 \
 	join0 join1 join2 join3 join4 \
 	kill1 \
-	mutex1 mutex1n mutex1e mutex1r \
+	mutex1 mutex1n mutex1e mutex1r mutex1a \
 	mutex2 mutex2r mutex2e mutex3 mutex3r mutex3e \
 	mutex4 mutex5 mutex6 mutex6n mutex6e mutex6r \
 	mutex6s mutex6es mutex6rs \
@@ -37,25 +37,25 @@ ALL_KNOWN_TESTS = \
 	once1 once2 once3 once4 \
 	priority1 priority2 inherit1 \
 	reinit1 \
-	reuse1 reuse2 \
-	robust1 robust2 robust3 robust4 robust5 \
+	reuse1 reuse2 reuse3 \
+	robust1 robust2 robust3 robust4 robust5 pshared1 \
 	rwlock1 rwlock2 rwlock3 rwlock4 \
 	rwlock2_t rwlock3_t rwlock4_t rwlock5_t rwlock6_t rwlock6_t2 \
-	rwlock5 rwlock6 rwlock7 rwlock8 \
+	rwlock5 rwlock6 rwlock7 rwlock8 rwlock9 rwlock10 rwlock11 \
 	self1 self2 \
 	semaphore1 semaphore2 semaphore3 \
-	semaphore4 semaphore4t semaphore5 \
+	semaphore4 semaphore4t semaphore5 semaphore6 semaphore7 \
 	sequence1 \
 	sizes \
-	spin1 spin2 spin3 spin4 \
+	spin1 spin2 spin3 spin4 spin5 \
 	stress1 \
-	tsd1 tsd2 tsd3 \
+	tsd1 tsd2 tsd3 tsd4 \
 	valid1 valid2
 
 TESTS = $(ALL_KNOWN_TESTS)
 
 BENCHTESTS = \
-	benchtest1 benchtest2 benchtest3 benchtest4 benchtest5
+	benchtest1 benchtest2 benchtest3 benchtest4 benchtest5 benchtest6 benchtest7 benchtest8 benchtest9 benchtest10 benchtest11 benchtest12 benchtest13 benchtest14 benchtest15
 
 # Output useful info if no target given. I.e. the first target that "make" sees is used in this case.
 default_target: help
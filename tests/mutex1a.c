@@ -0,0 +1,132 @@
+/*
+ * mutex1a.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * As for mutex1.c but with type set to PTHREAD_MUTEX_ADAPTIVE_NP.
+ *
+ * Create a simple mutex object, lock it, unlock it, then have several
+ * threads contend on it so that both the spin and the blocking paths
+ * are taken. Check that no increments are lost.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_settype()
+ * 	pthread_mutex_init()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ *	pthread_mutex_destroy()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 8,
+  ITERATIONS = 20000
+};
+
+static pthread_mutex_t mutex = NULL;
+static pthread_mutexattr_t mxAttr;
+static long counter = 0;
+
+static void * worker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      counter++;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  return NULL;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_mutex1a(void)
+#endif
+{
+  pthread_t t[NUMTHREADS];
+  int mxType = -1;
+  int i;
+
+  assert(pthread_mutexattr_init(&mxAttr) == 0);
+
+  BEGIN_MUTEX_STALLED_ROBUST(mxAttr)
+  {
+	  assert(pthread_mutexattr_settype(&mxAttr, PTHREAD_MUTEX_ADAPTIVE_NP) == 0);
+	  assert(pthread_mutexattr_gettype(&mxAttr, &mxType) == 0);
+	  assert(mxType == PTHREAD_MUTEX_ADAPTIVE_NP);
+
+	  assert(mutex == NULL);
+
+	  assert(pthread_mutex_init(&mutex, &mxAttr) == 0);
+
+	  assert(mutex != NULL);
+
+	  assert(pthread_mutex_lock(&mutex) == 0);
+
+	  assert(pthread_mutex_trylock(&mutex) == EBUSY);
+
+	  assert(pthread_mutex_unlock(&mutex) == 0);
+
+	  counter = 0;
+
+	  for (i = 0; i < NUMTHREADS; i++)
+	    {
+	      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+	    }
+
+	  for (i = 0; i < NUMTHREADS; i++)
+	    {
+	      assert(pthread_join(t[i], NULL) == 0);
+	    }
+
+	  assert(counter == (long) NUMTHREADS * ITERATIONS);
+
+	  assert(pthread_mutex_destroy(&mutex) == 0);
+
+	  assert(mutex == NULL);
+  }
+  END_MUTEX_STALLED_ROBUST(mxAttr)
+
+  assert(pthread_mutexattr_destroy(&mxAttr) == 0);
+
+  return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * pshared1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Test PTHREAD_PROCESS_SHARED mutexes, condition variables, rwlocks,
+ * barriers and spin locks between two processes.
+ *
+ * The objects live in a named section that the test runs itself as a
+ * second process to map (a second thread in the monolithic build).
+ * Both sides count under a shared mutex, a shared spin lock and a
+ * shared rwlock, meet at a shared barrier and hand over a turn through
+ * a shared condition variable. The child then exits holding a robust
+ * shared mutex, which the parent must inherit with EOWNERDEAD.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_setpshared()
+ *	pthread_mutexattr_setrobust()
+ *	pthread_condattr_setpshared()
+ *	pthread_rwlockattr_setpshared()
+ *	pthread_barrierattr_setpshared()
+ *	pthread_mutex_consistent()
+ *	pthread_spin_init()
+ */
+
+#include "test.h"
+
+#define ITERATIONS 10000
+
+typedef struct {
+  pthread_mutex_t mx;
+  pthread_mutex_t robustMx;
+  pthread_cond_t cv;
+  pthread_rwlock_t rwl;
+  pthread_barrier_t b;
+  pthread_spinlock_t sl;
+  long mxCount;
+  long slCount;
+  long rwCount;
+  int turn;
+} shared_t;
+
+static char sectionName[64];
+
+static shared_t *
+mapShared(int create)
+{
+  HANDLE h;
+
+  if (create)
+    {
+      h = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                             0, sizeof(shared_t), sectionName);
+    }
+  else
+    {
+      h = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, sectionName);
+    }
+  assert(h != NULL);
+
+  /* The handle is left open: the view is used until exit. */
+  return (shared_t *) MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+}
+
+static void
+work(shared_t * s, int me)
+{
+  int i;
+
+  assert(pthread_barrier_wait(&s->b) != EINVAL);
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&s->mx) == 0);
+      s->mxCount++;
+      assert(pthread_mutex_unlock(&s->mx) == 0);
+
+      assert(pthread_spin_lock(&s->sl) == 0);
+      s->slCount++;
+      assert(pthread_spin_unlock(&s->sl) == 0);
+
+      assert(pthread_rwlock_rdlock(&s->rwl) == 0);
+      assert(pthread_rwlock_unlock(&s->rwl) == 0);
+      assert(pthread_rwlock_wrlock(&s->rwl) == 0);
+      s->rwCount++;
+      assert(pthread_rwlock_unlock(&s->rwl) == 0);
+    }
+
+  assert(pthread_barrier_wait(&s->b) != EINVAL);
+
+  assert(s->mxCount == 2 * ITERATIONS);
+  assert(s->slCount == 2 * ITERATIONS);
+  assert(s->rwCount == 2 * ITERATIONS);
+
+  /*
+   * Take turns: the parent (0) goes first.
+   */
+  assert(pthread_mutex_lock(&s->mx) == 0);
+  for (i = 0; i < 2; i++)
+    {
+      while (s->turn != me)
+        {
+          assert(pthread_cond_wait(&s->cv, &s->mx) == 0);
+        }
+      s->turn = 1 - me;
+      assert(pthread_cond_signal(&s->cv) == 0);
+    }
+  assert(pthread_mutex_unlock(&s->mx) == 0);
+}
+
+static int
+child(void)
+{
+  shared_t * s = mapShared(0);
+
+  work(s, 1);
+
+  /*
+   * Exit holding the robust mutex.
+   */
+  assert(pthread_mutex_lock(&s->robustMx) == 0);
+
+  return 0;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+static void *
+spawnChild(void * arg)
+{
+  char cmd[128];
+
+  sprintf(cmd, "pshared1.exe %s", sectionName);
+
+  return (void *)(size_t) system(cmd);
+}
+#else
+static void *
+spawnChild(void * arg)
+{
+  return (void *)(size_t) child();
+}
+#endif
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main(int argc, char **argv)
+#else
+int
+test_pshared1(int argc, char **argv)
+#endif
+{
+  shared_t * s;
+  pthread_t t;
+  void * result;
+  pthread_mutexattr_t ma;
+  pthread_condattr_t ca;
+  pthread_rwlockattr_t ra;
+  pthread_barrierattr_t ba;
+  int pshared;
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+  if (argc >= 2)
+    {
+      strncpy(sectionName, argv[1], sizeof(sectionName) - 1);
+      return child();
+    }
+#endif
+
+  sprintf(sectionName, "pshared1-%lu", (unsigned long) GetCurrentProcessId());
+  s = mapShared(1);
+  assert(s != NULL);
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_mutexattr_getpshared(&ma, &pshared) == 0);
+  assert(pshared == PTHREAD_PROCESS_SHARED);
+  assert(pthread_mutex_init(&s->mx, &ma) == 0);
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_init(&s->robustMx, &ma) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  assert(pthread_condattr_init(&ca) == 0);
+  assert(pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_cond_init(&s->cv, &ca) == 0);
+  assert(pthread_condattr_destroy(&ca) == 0);
+
+  assert(pthread_rwlockattr_init(&ra) == 0);
+  assert(pthread_rwlockattr_setpshared(&ra, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_rwlock_init(&s->rwl, &ra) == 0);
+  assert(pthread_rwlockattr_destroy(&ra) == 0);
+
+  assert(pthread_barrierattr_init(&ba) == 0);
+  assert(pthread_barrierattr_setpshared(&ba, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_barrier_init(&s->b, &ba, 2) == 0);
+  assert(pthread_barrierattr_destroy(&ba) == 0);
+
+  assert(pthread_spin_init(&s->sl, PTHREAD_PROCESS_SHARED) == 0);
+
+  assert(pthread_create(&t, NULL, spawnChild, NULL) == 0);
+
+  work(s, 0);
+
+  assert(pthread_join(t, &result) == 0);
+  assert(result == NULL);
+
+  /*
+   * The child has exited holding robustMx.
+   */
+  assert(pthread_mutex_lock(&s->robustMx) == EOWNERDEAD);
+  assert(pthread_mutex_consistent(&s->robustMx) == 0);
+  assert(pthread_mutex_unlock(&s->robustMx) == 0);
+  assert(pthread_mutex_lock(&s->robustMx) == 0);
+  assert(pthread_mutex_unlock(&s->robustMx) == 0);
+
+  assert(pthread_mutex_lock(&s->mx) == 0);
+  assert(pthread_mutex_destroy(&s->mx) == EBUSY);
+  assert(pthread_mutex_unlock(&s->mx) == 0);
+
+  assert(pthread_spin_lock(&s->sl) == 0);
+  assert(pthread_spin_trylock(&s->sl) == EBUSY);
+  assert(pthread_spin_unlock(&s->sl) == 0);
+  assert(pthread_spin_destroy(&s->sl) == 0);
+
+  assert(pthread_barrier_destroy(&s->b) == 0);
+  assert(pthread_rwlock_destroy(&s->rwl) == 0);
+  assert(pthread_cond_destroy(&s->cv) == 0);
+  assert(pthread_mutex_destroy(&s->robustMx) == 0);
+  assert(pthread_mutex_destroy(&s->mx) == 0);
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * reuse3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Test that thread structs are reused safely when several threads
+ *   create and join threads at the same time.
+ *
+ * Description:
+ * - Each of NUMCREATORS threads repeatedly creates a thread, joins it
+ *   and checks that the handle it keeps from the previous round no
+ *   longer refers to a live thread, even though its struct may now
+ *   belong to a thread created by another creator.
+ *
+ * Depends on API functions:
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_kill()
+ *	pthread_equal()
+ */
+
+#include "test.h"
+
+enum {
+  NUMCREATORS = 8,
+  NUMTHREADS = 500
+};
+
+static void * func(void * arg)
+{
+  return arg;
+}
+
+static void * creator(void * arg)
+{
+  pthread_t t, last_t;
+  void * result = NULL;
+  int i;
+
+  assert(pthread_create(&last_t, NULL, func, NULL) == 0);
+  assert(pthread_join(last_t, NULL) == 0);
+
+  for (i = 1; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t, NULL, func, (void *)(size_t)i) == 0);
+      /* thread IDs should be unique */
+      assert(!pthread_equal(t, last_t));
+      /* the previous thread is gone */
+      assert(pthread_kill(last_t, 0) == ESRCH);
+      assert(pthread_join(last_t, NULL) == ESRCH);
+      assert(pthread_join(t, &result) == 0);
+      assert((int)(size_t) result == i);
+      last_t = t;
+    }
+
+  return arg;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_reuse3(void)
+#endif
+{
+  pthread_t t[NUMCREATORS];
+  int i;
+
+  for (i = 0; i < NUMCREATORS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, creator, NULL) == 0);
+    }
+
+  for (i = 0; i < NUMCREATORS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  return 0;
+}
@@ -6,6 +6,16 @@ benchtest2.bench:
 benchtest3.bench:
 benchtest4.bench:
 benchtest5.bench:
+benchtest6.bench:
+benchtest7.bench:
+benchtest8.bench:
+benchtest9.bench:
+benchtest10.bench:
+benchtest11.bench:
+benchtest12.bench:
+benchtest13.bench:
+benchtest14.bench:
+benchtest15.bench:
 
 affinity1.pass: errno0.pass
 affinity2.pass: affinity1.pass
@@ -19,6 +29,7 @@ barrier3.pass: barrier2.pass semaphore4.pass self1.pass create3.pass join4.pass
 barrier4.pass: barrier3.pass semaphore4.pass self1.pass create3.pass join4.pass mutex8.pass
 barrier5.pass: barrier4.pass semaphore4.pass self1.pass create3.pass join4.pass mutex8.pass
 barrier6.pass: barrier5.pass semaphore4.pass self1.pass create3.pass join4.pass mutex8.pass
+barrier7.pass: barrier6.pass semaphore4.pass self1.pass create3.pass join4.pass mutex8.pass
 cancel1.pass: self1.pass create3.pass
 cancel2.pass: self1.pass create3.pass join4.pass barrier6.pass
 cancel3.pass: self1.pass create3.pass join4.pass context1.pass
@@ -82,6 +93,7 @@ mutex1.pass: mutex5.pass
 mutex1n.pass: mutex1.pass
 mutex1e.pass: mutex1.pass
 mutex1r.pass: mutex1.pass
+mutex1a.pass: mutex1.pass
 mutex2.pass: mutex1.pass
 mutex2r.pass: mutex2.pass
 mutex2e.pass: mutex2.pass
@@ -116,11 +128,13 @@ priority2.pass: priority1.pass barrier3.pass
 reinit1.pass: rwlock6.pass
 reuse1.pass: create3.pass
 reuse2.pass: reuse1.pass
+reuse3.pass: reuse2.pass
 robust1.pass: mutex8r.pass
 robust2.pass: mutex8r.pass
 robust3.pass: robust2.pass
 robust4.pass: robust3.pass
 robust5.pass: robust4.pass
+pshared1.pass: robust5.pass
 rwlock1.pass: condvar6.pass
 rwlock2.pass: rwlock1.pass
 rwlock3.pass: rwlock2.pass join2.pass
@@ -129,6 +143,9 @@ rwlock5.pass: rwlock4.pass
 rwlock6.pass: rwlock5.pass
 rwlock7.pass: rwlock6.pass
 rwlock8.pass: rwlock7.pass
+rwlock9.pass: rwlock8.pass
+rwlock10.pass: rwlock9.pass
+rwlock11.pass: rwlock10.pass
 rwlock2_t.pass: rwlock2.pass
 rwlock3_t.pass: rwlock3.pass rwlock2_t.pass
 rwlock4_t.pass: rwlock4.pass rwlock3_t.pass
@@ -143,16 +160,20 @@ semaphore3.pass: semaphore2.pass
 semaphore4.pass: semaphore3.pass cancel1.pass
 semaphore4t.pass: semaphore4.pass
 semaphore5.pass: semaphore4.pass
-sequence1.pass: reuse2.pass
+semaphore6.pass: semaphore5.pass
+semaphore7.pass: semaphore6.pass
+sequence1.pass: reuse3.pass
 sizes.pass: 
 spin1.pass: self1.pass create3.pass mutex8.pass
 spin2.pass: spin1.pass
 spin3.pass: spin2.pass
 spin4.pass: spin3.pass
+spin5.pass: spin4.pass
 stress1.pass: create3.pass mutex8.pass barrier6.pass
 timeouts.pass: condvar9.pass
 tsd1.pass: barrier5.pass join1.pass
 tsd2.pass: tsd1.pass
 tsd3.pass: tsd2.pass
+tsd4.pass: tsd3.pass
 valid1.pass: join1.pass
 valid2.pass: valid1.pass
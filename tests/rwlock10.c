@@ -0,0 +1,220 @@
+/*
+ * rwlock10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Check the admission order of the rwlock preference kinds:
+ * - PREFER_READER lets a reader in while a writer waits;
+ * - PREFER_WRITER_NONRECURSIVE and PHASE_FAIR make it wait;
+ * - a reader held back by a writer that then times out gets in;
+ * - every kind still excludes writers from readers and each other.
+ *
+ * Depends on API functions:
+ *      pthread_rwlockattr_init()
+ *      pthread_rwlockattr_setkind_np()
+ *      pthread_rwlock_init()
+ *      pthread_rwlock_rdlock()
+ *      pthread_rwlock_tryrdlock()
+ *      pthread_rwlock_wrlock()
+ *      pthread_rwlock_timedwrlock()
+ *      pthread_rwlock_unlock()
+ *      pthread_rwlock_destroy()
+ */
+
+#include "test.h"
+
+#define THREADS         6
+#define ITERATIONS      20000
+
+static pthread_rwlock_t rwlock = NULL;
+static volatile long a = 0;
+static volatile long b = 0;
+static int torn = 0;
+static volatile int readerDone = 0;
+
+static void * hammer(void * arg)
+{
+  int i;
+  int n = (int)(size_t) arg;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if ((i + n) % 10 == 0)
+        {
+          assert(pthread_rwlock_wrlock(&rwlock) == 0);
+          a++;
+          Sleep(0);
+          b++;
+          assert(pthread_rwlock_unlock(&rwlock) == 0);
+        }
+      else
+        {
+          assert(pthread_rwlock_rdlock(&rwlock) == 0);
+          if (a != b)
+            {
+              torn++;
+            }
+          assert(pthread_rwlock_unlock(&rwlock) == 0);
+        }
+    }
+
+  return NULL;
+}
+
+static void * wrfunc(void * arg)
+{
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return NULL;
+}
+
+static void * timedwrfunc(void * arg)
+{
+  struct timespec abstime, reltime = { 0, 200000000 };
+
+  (void) pthread_win32_getabstime_np(&abstime, &reltime);
+
+  return (void *)(size_t) pthread_rwlock_timedwrlock(&rwlock, &abstime);
+}
+
+static void * rdfunc(void * arg)
+{
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  readerDone = 1;
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return NULL;
+}
+
+static void
+newlock(int kind)
+{
+  pthread_rwlockattr_t rwa;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, kind) == 0);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+}
+
+/*
+ * Hold a read lock, start a writer and see whether a second reader
+ * is let in ahead of it.
+ */
+static int
+readerOvertakes(int kind)
+{
+  pthread_t t;
+  int result;
+
+  newlock(kind);
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_create(&t, NULL, wrfunc, NULL) == 0);
+  Sleep(100);
+  assert(pthread_rwlock_destroy(&rwlock) == EBUSY);
+  result = pthread_rwlock_tryrdlock(&rwlock);
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return result == 0;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_rwlock10(void)
+#endif
+{
+  static const int kinds[] = {
+    PTHREAD_RWLOCK_PREFER_READER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP,
+    PTHREAD_RWLOCK_PHASE_FAIR_NP
+  };
+  pthread_t t[THREADS];
+  pthread_t w;
+  void * result;
+  int k;
+  int i;
+
+  assert(readerOvertakes(PTHREAD_RWLOCK_PREFER_READER_NP));
+  assert(readerOvertakes(PTHREAD_RWLOCK_PREFER_WRITER_NP));
+  assert(!readerOvertakes(PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP));
+  assert(!readerOvertakes(PTHREAD_RWLOCK_PHASE_FAIR_NP));
+
+  /*
+   * A reader queued behind a writer that gives up must not stay queued.
+   */
+  newlock(PTHREAD_RWLOCK_PHASE_FAIR_NP);
+  readerDone = 0;
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_create(&w, NULL, timedwrfunc, NULL) == 0);
+  Sleep(50);
+  assert(pthread_create(&t[0], NULL, rdfunc, NULL) == 0);
+  Sleep(50);
+  assert(readerDone == 0);
+  assert(pthread_join(w, &result) == 0);
+  assert((int)(size_t) result == ETIMEDOUT);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(readerDone == 1);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  for (k = 0; k < (int)(sizeof(kinds) / sizeof(kinds[0])); k++)
+    {
+      newlock(kinds[k]);
+      a = b = 0;
+      for (i = 0; i < THREADS; i++)
+        {
+          assert(pthread_create(&t[i], NULL, hammer, (void *)(size_t) i) == 0);
+        }
+      for (i = 0; i < THREADS; i++)
+        {
+          assert(pthread_join(t[i], NULL) == 0);
+        }
+      assert(torn == 0);
+      assert(a == b);
+      assert(a == THREADS * (ITERATIONS / 10));
+      assert(pthread_rwlock_destroy(&rwlock) == 0);
+    }
+
+  return 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * rwlock11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Upgrade a read lock to a write lock and downgrade it again, for each
+ * rwlock kind:
+ * - tryupgrade succeeds only for the sole reader;
+ * - upgrade waits for the other readers and no writer gets in between;
+ * - downgrade lets other readers in but keeps writers out.
+ * A READ_MOSTLY reader on the fast path gets EDEADLK from upgrade while
+ * a writer waits for it to leave.
+ *
+ * Depends on API functions:
+ *      pthread_rwlockattr_setkind_np()
+ *      pthread_rwlock_rdlock()
+ *      pthread_rwlock_tryrdlock()
+ *      pthread_rwlock_trywrlock()
+ *      pthread_rwlock_upgrade_np()
+ *      pthread_rwlock_tryupgrade_np()
+ *      pthread_rwlock_downgrade_np()
+ *      pthread_rwlock_unlock()
+ */
+
+#include "test.h"
+
+static pthread_rwlock_t rwlock = NULL;
+static volatile int readerDone = 0;
+static volatile int shared = 0;
+
+static void * tryrdfunc(void * arg)
+{
+  int result = pthread_rwlock_tryrdlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+static void * trywrfunc(void * arg)
+{
+  int result = pthread_rwlock_trywrlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+static void * slowreader(void * arg)
+{
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  Sleep(200);
+  readerDone = 1;
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return NULL;
+}
+
+static void * writer(void * arg)
+{
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  shared = 2;
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return NULL;
+}
+
+static int
+other(void * (*func)(void *))
+{
+  pthread_t t;
+  void * result;
+
+  assert(pthread_create(&t, NULL, func, NULL) == 0);
+  assert(pthread_join(t, &result) == 0);
+
+  return (int)(size_t) result;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_rwlock11(void)
+#endif
+{
+  static const int kinds[] = {
+    PTHREAD_RWLOCK_DEFAULT_NP,
+    PTHREAD_RWLOCK_READ_MOSTLY_NP,
+    PTHREAD_RWLOCK_PREFER_READER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP,
+    PTHREAD_RWLOCK_PHASE_FAIR_NP
+  };
+  pthread_rwlockattr_t rwa;
+  pthread_t t;
+  pthread_t w;
+  int k;
+  int result;
+
+  for (k = 0; k < (int)(sizeof(kinds) / sizeof(kinds[0])); k++)
+    {
+      assert(pthread_rwlockattr_init(&rwa) == 0);
+      assert(pthread_rwlockattr_setkind_np(&rwa, kinds[k]) == 0);
+      assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+      assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+      result = pthread_rwlock_tryupgrade_np(&rwlock);
+      if (result == ENOTSUP)
+        {
+          /* SRW build: only the policy kinds convert. */
+          assert(pthread_rwlock_unlock(&rwlock) == 0);
+          assert(pthread_rwlock_downgrade_np(&rwlock) == ENOTSUP);
+          assert(pthread_rwlock_destroy(&rwlock) == 0);
+          continue;
+        }
+
+      /*
+       * Sole reader: tryupgrade succeeds, downgrade lets readers back in.
+       */
+      assert(result == 0);
+      assert(other(tryrdfunc) == EBUSY);
+      assert(pthread_rwlock_downgrade_np(&rwlock) == 0);
+      assert(other(tryrdfunc) == 0);
+      assert(other(trywrfunc) == EBUSY);
+      assert(pthread_rwlock_downgrade_np(&rwlock) == EPERM);
+
+      /*
+       * Another reader: tryupgrade fails, upgrade waits for it.
+       */
+      readerDone = 0;
+      assert(pthread_create(&t, NULL, slowreader, NULL) == 0);
+      Sleep(50);
+      assert(pthread_rwlock_tryupgrade_np(&rwlock) == EBUSY);
+      assert(pthread_rwlock_upgrade_np(&rwlock) == 0);
+      assert(readerDone == 1);
+      assert(other(tryrdfunc) == EBUSY);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+      assert(pthread_join(t, NULL) == 0);
+
+      /*
+       * A writer is waiting for our read lock. The default kinds can't
+       * put the upgrade first; the others do.
+       */
+      shared = 0;
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+      assert(pthread_create(&w, NULL, writer, NULL) == 0);
+      Sleep(50);
+      result = pthread_rwlock_upgrade_np(&rwlock);
+      if (kinds[k] == PTHREAD_RWLOCK_DEFAULT_NP
+          || kinds[k] == PTHREAD_RWLOCK_READ_MOSTLY_NP)
+        {
+          assert(result == EDEADLK);
+        }
+      else
+        {
+          assert(result == 0);
+          shared = 1;
+          Sleep(50);
+          assert(shared == 1);
+        }
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+      assert(pthread_join(w, NULL) == 0);
+      assert(shared == 2);
+
+      assert(pthread_rwlock_upgrade_np(&rwlock) == EPERM);
+      assert(pthread_rwlock_destroy(&rwlock) == 0);
+    }
+
+  /*
+   * A new READ_MOSTLY lock has its reader bias on, so our read lock
+   * takes a fast path slot. The writer takes the regular lock and waits
+   * in bias revocation for our slot; the upgrade must not wait for it.
+   */
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, PTHREAD_RWLOCK_READ_MOSTLY_NP) == 0);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  shared = 0;
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_create(&w, NULL, writer, NULL) == 0);
+  Sleep(50);
+  result = pthread_rwlock_upgrade_np(&rwlock);
+  assert(result == EDEADLK || result == ENOTSUP);
+  assert(shared == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_join(w, NULL) == 0);
+  assert(shared == 2);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,176 @@
+/*
+ * rwlock9.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Exercise a PTHREAD_RWLOCK_READ_MOSTLY_NP rwlock: readers that take the
+ * biased fast path must still exclude writers, and writers must exclude
+ * each other while the bias is revoked and re-armed repeatedly.
+ *
+ * Depends on API functions:
+ *      pthread_rwlockattr_init()
+ *      pthread_rwlockattr_setkind_np()
+ *      pthread_rwlockattr_getkind_np()
+ *      pthread_rwlock_init()
+ *      pthread_rwlock_rdlock()
+ *      pthread_rwlock_tryrdlock()
+ *      pthread_rwlock_wrlock()
+ *      pthread_rwlock_trywrlock()
+ *      pthread_rwlock_unlock()
+ *      pthread_rwlock_destroy()
+ */
+
+#include "test.h"
+
+#define READERS         8
+#define WRITERS         2
+#define ITERATIONS      100000
+
+static pthread_rwlock_t rwlock = NULL;
+
+/*
+ * Writers keep a == b. Readers must never see them differ.
+ */
+static volatile long a = 0;
+static volatile long b = 0;
+static int torn = 0;
+
+static void * rdfunc(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+      if (a != b)
+        {
+          torn++;
+        }
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return NULL;
+}
+
+static void * wrfunc(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS / 100; i++)
+    {
+      assert(pthread_rwlock_wrlock(&rwlock) == 0);
+      a++;
+      Sleep(0);
+      b++;
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return NULL;
+}
+
+static void * trywrfunc(void * arg)
+{
+  return (void *)(size_t) pthread_rwlock_trywrlock(&rwlock);
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_rwlock9(void)
+#endif
+{
+  pthread_rwlockattr_t rwa;
+  pthread_t rdt[READERS];
+  pthread_t wrt[WRITERS];
+  pthread_t t;
+  void * result;
+  int kind = -1;
+  int i;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_getkind_np(&rwa, &kind) == 0);
+  assert(kind == PTHREAD_RWLOCK_DEFAULT_NP);
+  assert(pthread_rwlockattr_setkind_np(&rwa, -1) == EINVAL);
+  assert(pthread_rwlockattr_setkind_np(&rwa, PTHREAD_RWLOCK_READ_MOSTLY_NP) == 0);
+  assert(pthread_rwlockattr_getkind_np(&rwa, &kind) == 0);
+  assert(kind == PTHREAD_RWLOCK_READ_MOSTLY_NP);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  /*
+   * A fast reader holds the lock: a writer in another thread must
+   * fail, and so must destroy.
+   */
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_rwlock_tryrdlock(&rwlock) == 0);
+  assert(pthread_create(&t, NULL, trywrfunc, NULL) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t)result == EBUSY);
+  assert(pthread_rwlock_destroy(&rwlock) == EBUSY);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  /*
+   * A writer holds the lock: readers must fail.
+   */
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_tryrdlock(&rwlock) == EBUSY);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  for (i = 0; i < READERS; i++)
+    {
+      assert(pthread_create(&rdt[i], NULL, rdfunc, NULL) == 0);
+    }
+  for (i = 0; i < WRITERS; i++)
+    {
+      assert(pthread_create(&wrt[i], NULL, wrfunc, NULL) == 0);
+    }
+  for (i = 0; i < READERS; i++)
+    {
+      assert(pthread_join(rdt[i], NULL) == 0);
+    }
+  for (i = 0; i < WRITERS; i++)
+    {
+      assert(pthread_join(wrt[i], NULL) == 0);
+    }
+
+  assert(torn == 0);
+  assert(a == WRITERS * (ITERATIONS / 100));
+  assert(a == b);
+
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * semaphore6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Test named semaphores: sem_open, sem_close and sem_unlink.
+ *
+ * The test runs itself as a second process (a thread in the monolithic
+ * build) that opens the semaphore by name and posts it, so the post
+ * crosses a process boundary.
+ */
+
+#include "test.h"
+#include <fcntl.h>
+#include <limits.h>
+
+#define POSTS 1000
+
+static char semName[64];
+
+static int
+child(void)
+{
+  sem_t * s = sem_open(semName, 0);
+  int i;
+
+  assert(s != SEM_FAILED);
+
+  for (i = 0; i < POSTS; i++)
+    {
+      assert(sem_post(s) == 0);
+    }
+
+  assert(sem_close(s) == 0);
+
+  return 0;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+static void *
+spawnChild(void * arg)
+{
+  char cmd[128];
+
+  sprintf(cmd, "semaphore6.exe %s", semName);
+
+  return (void *)(size_t) system(cmd);
+}
+#else
+static void *
+spawnChild(void * arg)
+{
+  return (void *)(size_t) child();
+}
+#endif
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main(int argc, char **argv)
+#else
+int
+test_semaphore6(int argc, char **argv)
+#endif
+{
+  sem_t * s;
+  sem_t * s2;
+  pthread_t t;
+  void * result;
+  int value;
+  int i;
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+  if (argc >= 2)
+    {
+      strncpy(semName, argv[1], sizeof(semName) - 1);
+      return child();
+    }
+#endif
+
+  sprintf(semName, "/semaphore6-%lu", (unsigned long) GetCurrentProcessId());
+
+  assert(sem_open(semName, 0) == SEM_FAILED);
+  assert(errno == ENOENT);
+  assert(sem_open("/a/b", O_CREAT, 0600, 0) == SEM_FAILED);
+  assert(errno == EINVAL);
+  assert(sem_open(semName, O_CREAT, 0600, (unsigned int) SEM_VALUE_MAX + 1) == SEM_FAILED);
+  assert(errno == EINVAL);
+
+  s = sem_open(semName, O_CREAT | O_EXCL, 0600, 1);
+  assert(s != SEM_FAILED);
+  assert(sem_open(semName, O_CREAT | O_EXCL, 0600, 1) == SEM_FAILED);
+  assert(errno == EEXIST);
+
+  /*
+   * Opening it again in this process gives the same semaphore.
+   */
+  s2 = sem_open(semName, O_CREAT, 0600, 5);
+  assert(s2 == s);
+  assert(sem_getvalue(s, &value) == 0);
+  assert(value == 1);
+  assert(sem_close(s2) == 0);
+
+  assert(sem_destroy(s) == -1);
+  assert(errno == EINVAL);
+
+  assert(sem_wait(s) == 0);
+
+  assert(pthread_create(&t, NULL, spawnChild, NULL) == 0);
+
+  for (i = 0; i < POSTS; i++)
+    {
+      assert(sem_wait(s) == 0);
+    }
+
+  assert(pthread_join(t, &result) == 0);
+  assert(result == NULL);
+  assert(sem_getvalue(s, &value) == 0);
+  assert(value == 0);
+
+  /*
+   * Unlinking hides the name but the semaphore still works.
+   */
+  assert(sem_unlink(semName) == 0);
+  assert(sem_unlink(semName) == -1);
+  assert(errno == ENOENT);
+  assert(sem_open(semName, 0) == SEM_FAILED);
+  assert(errno == ENOENT);
+  assert(sem_open(semName, O_CREAT, 0600, 0) == SEM_FAILED);
+  assert(errno == EAGAIN);
+  assert(sem_post(s) == 0);
+  assert(sem_trywait(s) == 0);
+
+  assert(sem_close(s) == 0);
+  assert(sem_close(s) == -1);
+  assert(errno == EINVAL);
+
+  /*
+   * Once closed everywhere the name can be used again.
+   */
+  s = sem_open(semName, O_CREAT | O_EXCL, 0600, 0);
+  assert(s != SEM_FAILED);
+  assert(sem_trywait(s) == -1);
+  assert(errno == EAGAIN);
+  assert(sem_unlink(semName) == 0);
+  assert(sem_close(s) == 0);
+
+  return 0;
+}
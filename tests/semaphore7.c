@@ -0,0 +1,124 @@
+/*
+ * semaphore7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Test sem_trywait_multiple_np and sem_timedwait_multiple_np.
+ *
+ * Depends on API functions:
+ *	sem_post_multiple()
+ */
+
+#include "test.h"
+
+#define UNITS 100000
+
+static sem_t s;
+static long taken = 0;
+
+static void *
+consumer(void * arg)
+{
+  int got;
+
+  for (;;)
+    {
+      assert(sem_timedwait_multiple_np(&s, 64, &got, NULL) == 0);
+      assert(got >= 1 && got <= 64);
+      if (InterlockedExchangeAdd(&taken, got) + got >= UNITS)
+        {
+          /* Wake the other consumers. */
+          assert(sem_post_multiple(&s, 4) == 0);
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_semaphore7(void)
+#endif
+{
+  pthread_t t[4];
+  struct timespec abstime;
+  const struct timespec rel = { 0, 100 * 1000000 };
+  int got = -1;
+  int i;
+
+  assert(sem_init(&s, 0, 0) == 0);
+
+  assert(sem_trywait_multiple_np(&s, 1, &got) == -1);
+  assert(errno == EAGAIN);
+  assert(got == -1);
+  assert(sem_trywait_multiple_np(&s, 0, &got) == -1);
+  assert(errno == EINVAL);
+
+  assert(sem_post_multiple(&s, 10) == 0);
+  assert(sem_trywait_multiple_np(&s, 3, &got) == 0);
+  assert(got == 3);
+  assert(sem_trywait_multiple_np(&s, 100, &got) == 0);
+  assert(got == 7);
+
+  assert(sem_timedwait_multiple_np(&s, 5, &got,
+                                   pthread_win32_getabstime_np(&abstime, &rel)) == -1);
+  assert(errno == ETIMEDOUT);
+
+  /*
+   * Several batch consumers drain a stream of batch posts.
+   */
+  for (i = 0; i < 4; i++)
+    {
+      assert(pthread_create(&t[i], NULL, consumer, NULL) == 0);
+    }
+
+  for (i = 0; i < UNITS; i += 50)
+    {
+      assert(sem_post_multiple(&s, 50) == 0);
+    }
+
+  for (i = 0; i < 4; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(taken >= UNITS);
+
+  assert(sem_destroy(&s) == 0);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * spin5.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Declare spinlocks of both kinds with pthread_spin_init_np.
+ * Contend for them from several threads and check that the
+ * lock excludes.
+ *
+ * Depends on API functions:
+ *	pthread_spin_init_np()
+ *	pthread_spin_lock()
+ *	pthread_spin_trylock()
+ *	pthread_spin_unlock()
+ *	pthread_spin_destroy()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 16,
+  ITERATIONS = 10000
+};
+
+static pthread_spinlock_t lock;
+static int inside = 0;
+static long total = 0;
+
+static void * func(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_spin_lock(&lock) == 0);
+      assert(++inside == 1);
+      total++;
+      assert(--inside == 0);
+      assert(pthread_spin_unlock(&lock) == 0);
+    }
+
+  return NULL;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_spin5(void)
+#endif
+{
+  pthread_t t[NUMTHREADS];
+  int kind;
+  int i;
+
+  assert(pthread_spin_init_np(&lock, PTHREAD_PROCESS_PRIVATE, -1) == EINVAL);
+
+  for (kind = PTHREAD_SPINLOCK_DEFAULT_NP; kind <= PTHREAD_SPINLOCK_FAIR_NP; kind++)
+    {
+      total = 0;
+
+      assert(pthread_spin_init_np(&lock, PTHREAD_PROCESS_PRIVATE, kind) == 0);
+
+      assert(pthread_spin_trylock(&lock) == 0);
+      assert(pthread_spin_trylock(&lock) == EBUSY);
+      assert(pthread_spin_destroy(&lock) != 0);
+      assert(pthread_spin_unlock(&lock) == 0);
+
+      for (i = 0; i < NUMTHREADS; i++)
+        {
+          assert(pthread_create(&t[i], NULL, func, NULL) == 0);
+        }
+
+      for (i = 0; i < NUMTHREADS; i++)
+        {
+          assert(pthread_join(t[i], NULL) == 0);
+        }
+
+      assert(total == (long) NUMTHREADS * ITERATIONS);
+
+      assert(pthread_spin_destroy(&lock) == 0);
+    }
+
+  return 0;
+}
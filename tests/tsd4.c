@@ -0,0 +1,154 @@
+/*
+ * tsd4.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999-2021 pthreads-win32 / pthreads4w contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Test that the number of keys isn't limited by Win32 TLS slots,
+ *   and that a key created in place of a deleted one starts NULL.
+ *
+ * Description:
+ * - Create NUMKEYS keys, more than Win32 has TLS slots, set a value
+ *   for each in two threads, and check that each thread reads back
+ *   its own values. Then delete every other key, create new keys in
+ *   their place, and check that these read NULL in both threads while
+ *   the surviving keys keep their values.
+ *
+ * Depends on API functions:
+ *	pthread_key_create()
+ *	pthread_key_delete()
+ *	pthread_setspecific()
+ *	pthread_getspecific()
+ */
+
+#include "test.h"
+
+enum {
+  NUMKEYS = 2000
+};
+
+static pthread_key_t keys[NUMKEYS];
+static pthread_barrier_t step;
+
+static void
+check (int base, int recreated)
+{
+  int i;
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      if (recreated && (i & 1))
+        {
+          assert(pthread_getspecific(keys[i]) == NULL);
+        }
+      else
+        {
+          assert(pthread_getspecific(keys[i]) == (void *)(size_t)(base + i));
+        }
+    }
+}
+
+static void * func(void * arg)
+{
+  int base = (int)(size_t) arg;
+  int i;
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_setspecific(keys[i], (void *)(size_t)(base + i)) == 0);
+    }
+  check(base, 0);
+
+  (void) pthread_barrier_wait(&step);
+  /* main recreates the odd keys */
+  (void) pthread_barrier_wait(&step);
+
+  check(base, 1);
+
+  return NULL;
+}
+
+#ifndef MONOLITHIC_PTHREAD_TESTS
+int
+main()
+#else
+int
+test_tsd4(void)
+#endif
+{
+  pthread_t t;
+  int i;
+
+  assert(pthread_barrier_init(&step, NULL, 2) == 0);
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_key_create(&keys[i], NULL) == 0);
+    }
+
+  assert(pthread_create(&t, NULL, func, (void *)(size_t) 1) == 0);
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_getspecific(keys[i]) == NULL);
+      assert(pthread_setspecific(keys[i], (void *)(size_t)(NUMKEYS + i)) == 0);
+    }
+  check(NUMKEYS, 0);
+
+  (void) pthread_barrier_wait(&step);
+
+  for (i = 1; i < NUMKEYS; i += 2)
+    {
+      assert(pthread_key_delete(keys[i]) == 0);
+    }
+  for (i = 1; i < NUMKEYS; i += 2)
+    {
+      assert(pthread_key_create(&keys[i], NULL) == 0);
+    }
+
+  (void) pthread_barrier_wait(&step);
+
+  check(NUMKEYS, 1);
+
+  assert(pthread_join(t, NULL) == 0);
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_key_delete(keys[i]) == 0);
+    }
+
+  assert(pthread_barrier_destroy(&step) == 0);
+
+  return 0;
+}
@@ -42,11 +42,22 @@ int test_barrier3(void);
 int test_barrier4(void);
 int test_barrier5(void);
 int test_barrier6(void);
+int test_barrier7(void);
 int test_benchtest1(void);
 int test_benchtest2(void);
 int test_benchtest3(void);
 int test_benchtest4(void);
 int test_benchtest5(void);
+int test_benchtest6(void);
+int test_benchtest7(void);
+int test_benchtest8(void);
+int test_benchtest9(void);
+int test_benchtest10(void);
+int test_benchtest11(void);
+int test_benchtest12(void);
+int test_benchtest13(void);
+int test_benchtest14(void);
+int test_benchtest15(void);
 int test_cancel1(void);
 int test_cancel2(void);
 int test_cancel3(void);
@@ -115,6 +126,7 @@ int test_mutex1(void);
 int test_mutex1e(void);
 int test_mutex1n(void);
 int test_mutex1r(void);
+int test_mutex1a(void);
 int test_mutex2(void);
 int test_mutex2e(void);
 int test_mutex2r(void);
@@ -150,11 +162,13 @@ int test_priority2(void);
 int test_reinit1(void);
 int test_reuse1(void);
 int test_reuse2(void);
+int test_reuse3(void);
 int test_robust1(void);
 int test_robust2(void);
 int test_robust3(void);
 int test_robust4(void);
 int test_robust5(void);
+int test_pshared1(int argc, char **argv);
 int test_rwlock1(void);
 int test_rwlock2(void);
 int test_rwlock2_t(void);
@@ -169,6 +183,9 @@ int test_rwlock6_t(void);
 int test_rwlock6_t2(void);
 int test_rwlock7(void);
 int test_rwlock8(void);
+int test_rwlock9(void);
+int test_rwlock10(void);
+int test_rwlock11(void);
 int test_self1(void);
 int test_self2(void);
 int test_semaphore1(void);
@@ -177,6 +194,8 @@ int test_semaphore3(void);
 int test_semaphore4(void);
 int test_semaphore4t(void);
 int test_semaphore5(void);
+int test_semaphore6(int argc, char **argv);
+int test_semaphore7(void);
 int test_sequence1(void);
 int test_sequence2(void);
 int test_sizes(void);
@@ -184,6 +203,7 @@ int test_spin1(void);
 int test_spin2(void);
 int test_spin3(void);
 int test_spin4(void);
+int test_spin5(void);
 int test_stress1(void);
 int test_threestage(int argc, char* argv[]);
 int test_timeouts(void);
@@ -192,6 +212,7 @@ int test_tryentercs2(void);
 int test_tsd1(void);
 int test_tsd2(void);
 int test_tsd3(void);
+int test_tsd4(void);
 int test_valid1(void);
 int test_valid2(void);
 
@@ -299,6 +320,7 @@ int main(int argc, char **argv)
 	TEST_WRAPPER(test_barrier4);
 	TEST_WRAPPER(test_barrier5);
 	TEST_WRAPPER(test_barrier6);
+	TEST_WRAPPER(test_barrier7);
 	TEST_WRAPPER(test_cancel1);
 	TEST_WRAPPER(test_cancel2);
 	TEST_WRAPPER(test_cancel3);
@@ -370,6 +392,7 @@ int main(int argc, char **argv)
 	TEST_WRAPPER(test_mutex1e);
 	TEST_WRAPPER(test_mutex1n);
 	TEST_WRAPPER(test_mutex1r);
+	TEST_WRAPPER(test_mutex1a);
 	TEST_WRAPPER(test_mutex2);
 	TEST_WRAPPER(test_mutex2e);
 	TEST_WRAPPER(test_mutex2r);
@@ -402,11 +425,13 @@ int main(int argc, char **argv)
 	TEST_WRAPPER(test_priority2);
 	/* TEST_WRAPPER(test_reuse1); -- fails when run here; does not fail when run at start of run :-S */
 	TEST_WRAPPER(test_reuse2);
+	TEST_WRAPPER(test_reuse3);
 	TEST_WRAPPER(test_robust1);
 	TEST_WRAPPER(test_robust2);
 	TEST_WRAPPER(test_robust3);
 	TEST_WRAPPER(test_robust4);
 	TEST_WRAPPER(test_robust5);
+	TEST_WRAPPER_W_ARGV(test_pshared1);
 	TEST_WRAPPER(test_rwlock1);
 	TEST_WRAPPER(test_rwlock2);
 	TEST_WRAPPER(test_rwlock2_t);
@@ -421,6 +446,9 @@ int main(int argc, char **argv)
 	TEST_WRAPPER(test_rwlock6_t2);
 	TEST_WRAPPER(test_rwlock7);
 	TEST_WRAPPER(test_rwlock8);
+	TEST_WRAPPER(test_rwlock9);
+	TEST_WRAPPER(test_rwlock10);
+	TEST_WRAPPER(test_rwlock11);
 	TEST_WRAPPER(test_self1);
 	TEST_WRAPPER(test_self2);
 	TEST_WRAPPER(test_semaphore1);
@@ -429,6 +457,8 @@ int main(int argc, char **argv)
 	TEST_WRAPPER(test_semaphore4);
 	TEST_WRAPPER(test_semaphore4t);
 	TEST_WRAPPER(test_semaphore5);
+	TEST_WRAPPER_W_ARGV(test_semaphore6);
+	TEST_WRAPPER(test_semaphore7);
 //	TEST_WRAPPER(test_sequence1);
 //	TEST_WRAPPER(test_sequence2);
 	TEST_WRAPPER(test_sizes);
@@ -436,6 +466,7 @@ int main(int argc, char **argv)
 	TEST_WRAPPER(test_spin2);
 	TEST_WRAPPER(test_spin3);
 	TEST_WRAPPER(test_spin4);
+	TEST_WRAPPER(test_spin5);
 	TEST_WRAPPER(test_stress1);
 	TEST_WRAPPER_W_ARGV(test_threestage);
 	TEST_WRAPPER(test_timeouts);
@@ -444,6 +475,7 @@ int main(int argc, char **argv)
 	TEST_WRAPPER(test_tsd1);
 	TEST_WRAPPER(test_tsd2);
 	TEST_WRAPPER(test_tsd3);
+	TEST_WRAPPER(test_tsd4);
 	TEST_WRAPPER(test_valid1);
 	TEST_WRAPPER(test_valid2);
 
@@ -452,6 +484,16 @@ int main(int argc, char **argv)
 	TEST_WRAPPER(test_benchtest3);
 	TEST_WRAPPER(test_benchtest4);
 	TEST_WRAPPER(test_benchtest5);
+	TEST_WRAPPER(test_benchtest6);
+	TEST_WRAPPER(test_benchtest7);
+	TEST_WRAPPER(test_benchtest8);
+	TEST_WRAPPER(test_benchtest9);
+	TEST_WRAPPER(test_benchtest10);
+	TEST_WRAPPER(test_benchtest11);
+	TEST_WRAPPER(test_benchtest12);
+	TEST_WRAPPER(test_benchtest13);
+	TEST_WRAPPER(test_benchtest14);
+	TEST_WRAPPER(test_benchtest15);
 
 	/* test_exit1 should be the VERY LAST test of the bunch as it will exit the application before it returns! */
 	TEST_WRAPPER(test_exit1);
@@ -81,7 +81,7 @@ ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout)
       if (sp->cancelState == PTHREAD_CANCEL_ENABLE)
 	{
 
-	  if ((handles[1] = sp->cancelEvent) != NULL)
+	  if ((handles[1] = ptw32_get_cancel_event (sp)) != NULL)
 	    {
 	      nHandles++;
 	    }